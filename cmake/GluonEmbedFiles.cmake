@@ -0,0 +1,32 @@
+# Embeds files into a target as constexpr byte arrays.
+#
+# gluon_embed_files(<target> <header> NAMESPACE <namespace> FILES <files...> [SYMBOLS <symbols...>])
+#
+# Generates <header> in the target's build directory, declaring gluon::<namespace>::k_Files, a table of gluon::embedded_file
+# (see gluon/core/gln_embedded.h) terminated by a null entry. When SYMBOLS are given, each file is also reachable through its
+# own array, e.g. gluon::<namespace>::<symbol>.
+# The header is regenerated when one of the files changes.
+
+set(GLUON_EMBED_SCRIPT ${CMAKE_CURRENT_LIST_DIR}/GluonEmbedFilesScript.cmake)
+
+function(gluon_embed_files TARGET HEADER)
+	cmake_parse_arguments(EMBED "" "NAMESPACE" "FILES;SYMBOLS" ${ARGN})
+
+	set(GeneratedDir ${CMAKE_CURRENT_BINARY_DIR}/embedded)
+	set(Output ${GeneratedDir}/${HEADER})
+
+	# Lists cannot be forwarded as is on the command line
+	string(REPLACE ";" "|" Files "${EMBED_FILES}")
+	string(REPLACE ";" "|" Symbols "${EMBED_SYMBOLS}")
+
+	add_custom_command(
+		OUTPUT ${Output}
+		COMMAND ${CMAKE_COMMAND} "-DFILES=${Files}" "-DSYMBOLS=${Symbols}" "-DNAMESPACE=${EMBED_NAMESPACE}" "-DOUTPUT=${Output}"
+		        -P ${GLUON_EMBED_SCRIPT}
+		DEPENDS ${EMBED_FILES} ${GLUON_EMBED_SCRIPT}
+		COMMENT "Embedding ${HEADER}"
+		VERBATIM)
+
+	target_sources(${TARGET} PRIVATE ${Output})
+	target_include_directories(${TARGET} PRIVATE ${GeneratedDir})
+endfunction()
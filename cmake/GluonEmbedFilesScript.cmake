@@ -0,0 +1,51 @@
+# Invoked by gluon_embed_files() at build time, see GluonEmbedFiles.cmake
+
+string(REPLACE "|" ";" Files "${FILES}")
+string(REPLACE "|" ";" Symbols "${SYMBOLS}")
+
+list(LENGTH Files FileCount)
+list(LENGTH Symbols SymbolCount)
+
+# CMake regular expressions have no bounded repetition, 32 bytes per line
+string(REPEAT "0x[0-9a-f][0-9a-f]," 32 LinePattern)
+
+set(Arrays "")
+set(Table "")
+
+if (FileCount GREATER 0)
+	math(EXPR LastIndex "${FileCount} - 1")
+
+	foreach(Index RANGE ${LastIndex})
+		list(GET Files ${Index} File)
+		get_filename_component(Name ${File} NAME)
+
+		if (Index LESS SymbolCount)
+			list(GET Symbols ${Index} Symbol)
+		else()
+			set(Symbol "k_File${Index}")
+		endif()
+
+		file(READ ${File} Content HEX)
+		string(LENGTH "${Content}" HexLength)
+		math(EXPR Size "${HexLength} / 2")
+
+		string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," Bytes "${Content}")
+		string(REGEX REPLACE "(${LinePattern})" "\\1\n\t" Bytes "${Bytes}")
+
+		string(APPEND Arrays "// ${Name}\nstatic constexpr u8 ${Symbol}[] = {\n\t${Bytes}0x00};\n\n")
+		string(APPEND Table "\t{\"${Name}\", ${Symbol}, ${Size}},\n")
+	endforeach()
+endif()
+
+file(WRITE ${OUTPUT}.tmp
+	"#pragma once\n\n"
+	"// Generated by cmake/GluonEmbedFiles.cmake, do not edit\n\n"
+	"#include <gluon/core/gln_embedded.h>\n\n"
+	"namespace gluon\n{\nnamespace ${NAMESPACE}\n{\n"
+	"${Arrays}"
+	"static constexpr embedded_file k_Files[] = {\n${Table}\t{nullptr, nullptr, 0},\n};\n"
+	"}\n}\n")
+
+# Keeps the timestamp when nothing changed, so that dependent files are not rebuilt
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different ${OUTPUT}.tmp ${OUTPUT})
+file(REMOVE ${OUTPUT}.tmp)
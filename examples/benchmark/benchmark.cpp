@@ -0,0 +1,993 @@
+#include <gluon/api/gln_renderer.h>
+#include <gluon/api/gln_renderer_p.h>
+#include <gluon/api/gln_text.h>
+#include <gluon/api/gln_text_buffer.h>
+#include <gluon/api/gln_text_view.h>
+
+#include <gluon/core/gln_timer.h>
+#include <gluon/core/gln_utf8.h>
+
+#include <EASTL/algorithm.h>
+#include <EASTL/functional.h>
+#include <EASTL/string.h>
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <filesystem>
+
+#include <stdio.h>
+#include <string.h>
+
+namespace fs = std::filesystem;
+
+// Usage: benchmark <scenario>, each scenario prints its timings on the standard output.
+// The backend is selected like for the other examples, GLUON_RENDER_BACKEND=vulkan runs the Vulkan one. To compare both on a
+// software rasterizer, run "benchmark frame" with LIBGL_ALWAYS_SOFTWARE=1, then with GLUON_RENDER_BACKEND=vulkan and the lavapipe ICD
+// selected through VK_ICD_FILENAMES.
+
+static constexpr i32 k_WindowWidth  = 1280;
+static constexpr i32 k_WindowHeight = 720;
+
+using draw_callback = eastl::function<void(u32 Frame)>;
+
+struct scenario
+{
+	const char* Name;
+	const char* Description;
+	void (*Run)(GLFWwindow* Window);
+};
+
+static void PrintTimes(const char* Label, eastl::vector<f64> Times)
+{
+	if (Times.empty())
+	{
+		return;
+	}
+
+	eastl::sort(Times.begin(), Times.end());
+
+	f64 Sum = 0.0;
+	for (f64 Time : Times)
+	{
+		Sum += Time;
+	}
+
+	printf("%-32s median %9.3fms  mean %9.3fms  p95 %9.3fms  (%u samples)\n",
+	       Label,
+	       Times[Times.size() / 2] * 1000.0,
+	       Sum / Times.size() * 1000.0,
+	       Times[Times.size() * 95 / 100] * 1000.0,
+	       (u32)Times.size());
+}
+
+static void StartRendering()
+{
+	gluon::priv::CreateRenderingContext();
+	gluon::priv::Resize((f32)k_WindowWidth, (f32)k_WindowHeight);
+}
+
+//! Frames are timed from the first draw to the end of the swap, glFinish() waits for the GPU so that both backends are comparable
+static eastl::vector<f64> RunFrames(GLFWwindow* Window, u32 FrameCount, const draw_callback& Draw)
+{
+	eastl::vector<f64> Times;
+	Times.reserve(FrameCount);
+
+	gluon::timer Timer;
+	for (u32 Frame = 0; Frame < FrameCount; ++Frame)
+	{
+		glfwPollEvents();
+
+		Timer.Start();
+
+		Draw(Frame);
+		gluon::priv::Flush();
+
+		glfwSwapBuffers(Window);
+		glFinish();
+
+		Times.push_back(Timer.GetElapsedSeconds());
+	}
+
+	return Times;
+}
+
+static gluon::font_handle WaitForFont(GLFWwindow* Window, const char* FontName)
+{
+	const gluon::font_handle Font = gluon::LoadFont(FontName);
+	gluon::SetFont(Font);
+
+	while (!gluon::IsFontReady(Font))
+	{
+		RunFrames(Window, 1, [](u32) {});
+	}
+
+	return Font;
+}
+
+static void RunFrameScenario(GLFWwindow* Window)
+{
+	StartRendering();
+	WaitForFont(Window, "roboto");
+
+	const gluon::color TextColor = gluon::MakeColorFromRGB8(20, 20, 20);
+
+	auto Draw = [TextColor](u32 Frame)
+	{
+		for (u32 Index = 0; Index < 4096; ++Index)
+		{
+			const f32 X = (f32)((Index * 37 + Frame) % k_WindowWidth);
+			const f32 Y = (f32)((Index * 101) % k_WindowHeight);
+
+			gluon::DrawRectangle(X, Y, 24.0f, 16.0f, gluon::MakeColorFromRGB8((u8)Index, 128, (u8)(255 - Index)), 4.0f);
+		}
+
+		for (u32 Line = 0; Line < 48; ++Line)
+		{
+			gluon::DrawText("The quick brown fox jumps over the lazy dog 0123456789",
+			                14.0f,
+			                16.0f,
+			                (f32)(k_WindowHeight - 16 - Line * 15),
+			                TextColor);
+		}
+	};
+
+	RunFrames(Window, 60, Draw); // Warm up, pipelines and caches
+
+	// Labelled with the backend which was actually selected, it falls back to OpenGL when Vulkan was not compiled in
+	const bool Vulkan = gluon::GetBackendType() == gluon::RenderBackend_Vulkan;
+	PrintTimes(Vulkan ? "frame (4096 rects, 48 lines), vulkan" : "frame (4096 rects, 48 lines), opengl", RunFrames(Window, 600, Draw));
+}
+
+//! Cost of a typical sequence of state changes, built once with GLUON_RENDERBACKEND_DISPATCH=OpenGL and once with Dynamic
+static void RunDispatchScenario(GLFWwindow*)
+{
+	StartRendering();
+
+	const gluon::buffer_handle       Buffer      = gluon::CreateBuffer(256);
+	const gluon::texture_handle      Texture     = gluon::CreateTexture(1, 1);
+	const gluon::vertex_array_handle VertexArray = gluon::CreateVertexArray(Buffer);
+
+	constexpr u32 k_CallCount     = 4;
+	constexpr u32 k_SequenceCount = 1000000;
+
+	eastl::vector<f64> Times;
+	for (u32 Run = 0; Run < 10; ++Run)
+	{
+		gluon::timer Timer;
+		Timer.Start();
+
+		for (u32 Sequence = 0; Sequence < k_SequenceCount; ++Sequence)
+		{
+			gluon::BindVertexArray(VertexArray);
+			gluon::BindStorageBuffer(0, Buffer);
+			gluon::BindTexture(0, Texture);
+			gluon::SetBlending((Sequence & 1) != 0);
+		}
+
+		// Time of a million calls
+		Times.push_back(Timer.GetElapsedSeconds() / k_CallCount);
+	}
+
+	PrintTimes(gluon::GetBackendType() == gluon::RenderBackend_Vulkan ? "1M Vulkan calls" : "1M OpenGL calls", Times);
+
+	gluon::DestroyVertexArray(VertexArray);
+	gluon::DestroyTexture(Texture);
+	gluon::DestroyBuffer(Buffer);
+}
+
+//! Time spent blocked in the context creation and time to the first frame drawn with every program, cold then warm cache
+static void RunStartupScenario(GLFWwindow* Window)
+{
+	const fs::path CacheDirectory = fs::temp_directory_path() / "gluon_benchmark_shader_cache";
+
+	std::error_code Error;
+	fs::remove_all(CacheDirectory, Error);
+
+	gluon::SetProgramCacheDirectory(CacheDirectory.string().c_str());
+
+	for (const char* Label : {"cold cache", "warm cache"})
+	{
+		// The second run starts from a new context, the cache has been filled by the first one
+		if (gluon::priv::IsFirstFrameRendered())
+		{
+			gluon::priv::DestroyRenderingContext();
+		}
+
+		gluon::timer Timer;
+		Timer.Start();
+
+		StartRendering();
+		const f64 CreationTime = Timer.GetElapsedSeconds();
+
+		while (!gluon::priv::IsFirstFrameRendered())
+		{
+			RunFrames(Window, 1, [](u32) {});
+		}
+
+		const gluon::program_cache_stats Stats = gluon::GetProgramCacheStats();
+		printf("%-12s context creation %8.3fms  first complete frame %8.3fms  (%u hits, %u misses so far)\n",
+		       Label,
+		       CreationTime * 1000.0,
+		       Timer.GetElapsedSeconds() * 1000.0,
+		       Stats.Hits,
+		       Stats.Misses);
+	}
+}
+
+//! Roboto is embedded in the library by default, the other fonts are read from resources/fonts.
+//! Frames keep being drawn while the fonts load, the longest one shows the hitch of the upload slices.
+static void RunFontLoadScenario(GLFWwindow* Window)
+{
+	StartRendering();
+
+	const gluon::color RectangleColor = gluon::MakeColorFromRGB8(60, 120, 200);
+
+	auto Draw = [RectangleColor](u32 Frame)
+	{
+		for (u32 Index = 0; Index < 1024; ++Index)
+		{
+			const f32 X = (f32)((Index * 37 + Frame) % k_WindowWidth);
+			const f32 Y = (f32)((Index * 101) % k_WindowHeight);
+
+			gluon::DrawRectangle(X, Y, 24.0f, 16.0f, RectangleColor);
+		}
+	};
+
+	for (const char* FontName : {"roboto", "DIMIS", "Lamthong"})
+	{
+		gluon::timer Timer;
+		Timer.Start();
+
+		const gluon::font_handle Font = gluon::LoadFont(FontName);
+
+		u32 FrameCount   = 0;
+		f64 LongestFrame = 0.0;
+
+		while (!gluon::IsFontReady(Font) && Timer.GetElapsedSeconds() < 10.0)
+		{
+			LongestFrame = eastl::max(LongestFrame, RunFrames(Window, 1, Draw)[0]);
+			++FrameCount;
+		}
+
+		const gluon::font_load_stats Stats = gluon::GetFontLoadStats();
+		printf("%-12s %s load %8.3fms  longest frame %8.3fms  (%u frames drawn meanwhile)\n",
+		       FontName,
+		       gluon::IsFontReady(Font) ? "ready," : "failed,",
+		       Stats.LastLoadTime * 1000.0,
+		       LongestFrame * 1000.0,
+		       FrameCount);
+	}
+}
+
+//! Glyph lookups of the layout, through the page-indexed glyph_table and through the hash map it replaced
+static void RunGlyphLookupScenario(GLFWwindow*)
+{
+	gluon::font_atlas Atlas = gluon::LoadFontAtlas("roboto");
+
+	eastl::unordered_map<u32, gluon::glyph> GlyphMap;
+	for (u32 GlyphIndex = 0; GlyphIndex < Atlas.Glyphs.GetGlyphCount(); ++GlyphIndex)
+	{
+		GlyphMap[Atlas.Glyphs.GetCodepoint(GlyphIndex)] = Atlas.Glyphs.GetGlyph(GlyphIndex);
+	}
+
+	// Mostly Latin-1 like most UI text, with a few codepoints going through the pages
+	const char32_t k_Sample[] = U"The quick brown fox jumps over the lazy dog, déjà vu \u0391\u03B2\u0414\u0436 \u2014 0123456789";
+	const u32      SampleSize = (u32)(sizeof(k_Sample) / sizeof(k_Sample[0]) - 1);
+
+	constexpr u32 k_LookupCount = 10000000;
+
+	eastl::vector<f64> TableTimes, MapTimes;
+	f32                Sum = 0.0f;
+
+	for (u32 Run = 0; Run < 10; ++Run)
+	{
+		gluon::timer Timer;
+
+		Timer.Start();
+		for (u32 Lookup = 0; Lookup < k_LookupCount; ++Lookup)
+		{
+			if (const gluon::glyph* Glyph = Atlas.Glyphs.Find(k_Sample[Lookup % SampleSize]))
+			{
+				Sum += Glyph->Advance;
+			}
+		}
+		TableTimes.push_back(Timer.GetElapsedSeconds());
+
+		Timer.Start();
+		for (u32 Lookup = 0; Lookup < k_LookupCount; ++Lookup)
+		{
+			auto It = GlyphMap.find(k_Sample[Lookup % SampleSize]);
+			if (It != GlyphMap.end())
+			{
+				Sum += It->second.Advance;
+			}
+		}
+		MapTimes.push_back(Timer.GetElapsedSeconds());
+	}
+
+	// Keeps the loops from being optimized away
+	printf("Advance sum %f\n", Sum);
+
+	PrintTimes("10M lookups, glyph_table", TableTimes);
+	PrintTimes("10M lookups, unordered_map", MapTimes);
+
+	gluon::ReleaseFontAtlas(&Atlas);
+}
+
+//! CPU time of laying out a screen of text without the layout cache, with and without kerning
+static void RunKerningScenario(GLFWwindow* Window)
+{
+	StartRendering();
+	WaitForFont(Window, "roboto");
+
+	gluon::SetLayoutCacheBudget(0);
+
+	const gluon::color TextColor = gluon::MakeColorFromRGB8(20, 20, 20);
+
+	for (bool Kerning : {false, true})
+	{
+		gluon::SetKerningEnabled(Kerning);
+
+		eastl::vector<f64> Times;
+
+		auto Draw = [&Times, TextColor](u32 Frame)
+		{
+			gluon::timer Timer;
+			Timer.Start();
+
+			// Every line differs, so that none is found in the single entry the cache keeps
+			for (u32 Line = 0; Line < 48; ++Line)
+			{
+				char Text[128];
+				snprintf(Text, sizeof(Text), "AVA WAVE Type To Yo LT Ta Vo We, the quick brown fox jumps %u %u", Frame, Line);
+
+				gluon::DrawText(Text, 14.0f, 16.0f, (f32)(k_WindowHeight - 16 - Line * 15), TextColor);
+			}
+
+			Times.push_back(Timer.GetElapsedSeconds());
+		};
+
+		RunFrames(Window, 60, Draw);
+		Times.clear();
+		RunFrames(Window, 600, Draw);
+
+		PrintTimes(Kerning ? "layout of 48 lines, kerning" : "layout of 48 lines, no kerning", Times);
+	}
+}
+
+//! The same static labels drawn as immediate texts and as retained texts, with the glyph data uploaded per frame
+static void RunRetainedScenario(GLFWwindow* Window)
+{
+	StartRendering();
+	const gluon::font_handle Font = WaitForFont(Window, "roboto");
+
+	constexpr u32 k_LabelCount = 1024;
+
+	const gluon::color TextColor = gluon::MakeColorFromRGB8(20, 20, 20);
+
+	eastl::vector<eastl::string> Labels;
+	for (u32 Label = 0; Label < k_LabelCount; ++Label)
+	{
+		char Text[64];
+		snprintf(Text, sizeof(Text), "Label %u, value %u", Label, Label * 7919);
+
+		Labels.push_back(Text);
+	}
+
+	auto LabelX = [](u32 Label) { return (f32)(16 + (Label % 8) * 156); };
+	auto LabelY = [](u32 Label) { return (f32)(k_WindowHeight - 12 - (Label / 8) * 5); };
+
+	eastl::vector<gluon::text_handle> Texts;
+	for (u32 Label = 0; Label < k_LabelCount; ++Label)
+	{
+		const gluon::text_handle Text = gluon::CreateText();
+		gluon::SetTextString(Text, Labels[Label].c_str());
+		gluon::SetTextFont(Text, Font, 12.0f);
+		gluon::SetTextPosition(Text, LabelX(Label), LabelY(Label));
+		gluon::SetTextColor(Text, TextColor);
+
+		Texts.push_back(Text);
+	}
+
+	for (bool Retained : {false, true})
+	{
+		eastl::vector<f64> Times;
+		u64                UploadedBytes = 0;
+
+		auto Draw = [&](u32)
+		{
+			gluon::timer Timer;
+			Timer.Start();
+
+			for (u32 Label = 0; Label < k_LabelCount; ++Label)
+			{
+				if (Retained)
+				{
+					gluon::DrawText(Texts[Label]);
+				}
+				else
+				{
+					gluon::DrawText(Labels[Label].c_str(), 12.0f, LabelX(Label), LabelY(Label), TextColor);
+				}
+			}
+
+			Times.push_back(Timer.GetElapsedSeconds());
+
+			// Stats of the previous frame
+			const gluon::text_stats Stats = gluon::GetTextStats();
+			UploadedBytes += Stats.ImmediateBytes + Stats.RetainedBytes;
+		};
+
+		RunFrames(Window, 60, Draw);
+		Times.clear();
+		UploadedBytes = 0;
+
+		const eastl::vector<f64> FrameTimes = RunFrames(Window, 600, Draw);
+
+		PrintTimes(Retained ? "1024 retained texts, CPU" : "1024 immediate texts, CPU", Times);
+		PrintTimes(Retained ? "1024 retained texts, frame" : "1024 immediate texts, frame", FrameTimes);
+		printf("%-32s %.1fKB uploaded per frame\n", "", UploadedBytes / 600.0 / 1024.0);
+	}
+
+	for (gluon::text_handle Text : Texts)
+	{
+		gluon::DestroyText(Text);
+	}
+}
+
+//! Byte at a time decoding without validation, the reference the vectorized decoder is compared to
+static u32 DecodeScalar(const u8** Data)
+{
+	const u8* Bytes = *Data;
+
+	if (Bytes[0] < 0x80)
+	{
+		*Data += 1;
+		return Bytes[0];
+	}
+
+	if (Bytes[0] < 0xE0)
+	{
+		*Data += 2;
+		return ((Bytes[0] & 0x1F) << 6) | (Bytes[1] & 0x3F);
+	}
+
+	if (Bytes[0] < 0xF0)
+	{
+		*Data += 3;
+		return ((Bytes[0] & 0x0F) << 12) | ((Bytes[1] & 0x3F) << 6) | (Bytes[2] & 0x3F);
+	}
+
+	*Data += 4;
+	return ((Bytes[0] & 0x07) << 18) | ((Bytes[1] & 0x3F) << 12) | ((Bytes[2] & 0x3F) << 6) | (Bytes[3] & 0x3F);
+}
+
+//! Decoding throughput of the DrawText() UTF-8 front-end over ASCII, Thai and CJK corpora
+static void RunUtf8Scenario(GLFWwindow*)
+{
+	struct corpus
+	{
+		const char* Name;
+		const char* Sample;
+	};
+
+	const corpus k_Corpora[] = {
+	    {"ASCII", "The quick brown fox jumps over the lazy dog. "},
+	    {"Thai", "\u0E20\u0E32\u0E29\u0E32\u0E44\u0E17\u0E22\u0E40\u0E1B\u0E47\u0E19\u0E20\u0E32\u0E29\u0E32 "},
+	    {"CJK", "\u6F22\u5B57\u306F\u4E2D\u56FD\u8A9E\u3068\u65E5\u672C\u8A9E\u3067\u4F7F\u308F\u308C\u308B "},
+	};
+
+	constexpr u64 k_CorpusSize = 16 * 1024 * 1024;
+
+	for (const corpus& Corpus : k_Corpora)
+	{
+		eastl::string Text;
+		while (Text.size() < k_CorpusSize)
+		{
+			Text += Corpus.Sample;
+		}
+
+		eastl::vector<f64> DecoderTimes, ScalarTimes;
+		u32                Sum = 0;
+
+		for (u32 Run = 0; Run < 10; ++Run)
+		{
+			gluon::timer Timer;
+
+			Timer.Start();
+			gluon::utf8_decoder Decoder(Text.data(), Text.size());
+			for (u32 Codepoint; Decoder.Next(&Codepoint);)
+			{
+				Sum += Codepoint;
+			}
+			DecoderTimes.push_back(Timer.GetElapsedSeconds());
+
+			Timer.Start();
+			const u8* Data = (const u8*)Text.data();
+			const u8* End  = Data + Text.size();
+			while (Data < End)
+			{
+				Sum += DecodeScalar(&Data);
+			}
+			ScalarTimes.push_back(Timer.GetElapsedSeconds());
+		}
+
+		eastl::sort(DecoderTimes.begin(), DecoderTimes.end());
+		eastl::sort(ScalarTimes.begin(), ScalarTimes.end());
+
+		// The sum keeps the loops from being optimized away
+		printf("%-8s utf8_decoder %8.1fMB/s  scalar %8.1fMB/s  (%08x)\n",
+		       Corpus.Name,
+		       Text.size() / DecoderTimes[DecoderTimes.size() / 2] / (1024.0 * 1024.0),
+		       Text.size() / ScalarTimes[ScalarTimes.size() / 2] / (1024.0 * 1024.0),
+		       Sum);
+	}
+}
+
+//! A text of 10M lines: indexing time, frame time at a few scroll positions and during a live resize with wrapping
+static void RunTextViewScenario(GLFWwindow* Window)
+{
+	StartRendering();
+	const gluon::font_handle Font = WaitForFont(Window, "roboto");
+
+	constexpr u32 k_LineCount = 10000000;
+
+	eastl::string Text;
+	for (u32 Line = 0; Line < k_LineCount; ++Line)
+	{
+		char Buffer[96];
+		const i32 Size = snprintf(Buffer, sizeof(Buffer), "%08u the quick brown fox jumps over the lazy dog\n", Line);
+
+		Text.append(Buffer, Buffer + Size);
+	}
+
+	gluon::text_view View;
+	gluon::timer     Timer;
+
+	Timer.Start();
+	View.SetText(Text.data(), Text.size());
+	printf("%-32s %9.3fms  (%u lines, %.1fMB)\n", "indexing", Timer.GetElapsedSeconds() * 1000.0, View.GetLineCount(), Text.size() / 1e6);
+
+	View.SetFont(Font, 14.0f);
+
+	const gluon::color TextColor = gluon::MakeColorFromRGB8(20, 20, 20);
+
+	for (u32 Line : {0u, k_LineCount / 2, k_LineCount - 64})
+	{
+		View.ScrollToLine(Line);
+
+		char Label[64];
+		snprintf(Label, sizeof(Label), "frame at line %u", Line);
+
+		PrintTimes(Label,
+		           RunFrames(Window, 300, [&View, TextColor](u32 Frame) {
+			           View.SetScroll(View.GetScroll() + (Frame % 2 == 0 ? 7.0 : -7.0));
+			           View.Draw(0.0f, (f32)k_WindowHeight, (f32)k_WindowWidth, (f32)k_WindowHeight, TextColor);
+		           }));
+	}
+
+	// Lines are single rows without wrapping
+	View.ScrollToLine(k_LineCount - 64);
+	View.SetScroll(View.GetScroll() + 0.5);
+	printf("%-32s %.1fpx, expected %.1fpx\n", "scroll near the end", View.GetScroll(), (k_LineCount - 64) * 14.0 + 0.5);
+
+	// Wrapped lines are laid out again at every width, the rest of the text keeps its heights
+	View.SetWrapping(true);
+	View.ScrollToLine(k_LineCount / 2);
+
+	PrintTimes("live resize, wrapping",
+	           RunFrames(Window, 300, [&View, TextColor](u32 Frame) {
+		           const f32 Width = (f32)(k_WindowWidth / 4 + (Frame * 3) % (k_WindowWidth / 2));
+		           View.Draw(0.0f, (f32)k_WindowHeight, Width, (f32)k_WindowHeight, TextColor);
+	           }));
+}
+
+//! Typing in the middle of a 1MB document: one keystroke per frame, every tenth one erases and every hundredth one is a line feed
+static void RunKeystrokeScenario(GLFWwindow* Window)
+{
+	StartRendering();
+	const gluon::font_handle Font = WaitForFont(Window, "roboto");
+
+	eastl::u32string Document;
+	while (Document.size() < 1000000)
+	{
+		Document += U"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore.\n";
+	}
+
+	gluon::text_buffer Buffer;
+	Buffer.SetText(Document.c_str());
+	Buffer.SetFont(Font, 16.0f);
+
+	// Paragraphs are a single line at this width, the caret is in the middle of the view
+	constexpr u32 k_FirstParagraph = 5000;
+
+	Buffer.SetScroll(k_FirstParagraph * 16.0f);
+
+	const gluon::color TextColor = gluon::MakeColorFromRGB8(20, 20, 20);
+
+	u32                Position = (k_FirstParagraph + 20) * 102 + 50;
+	eastl::vector<f64> Times;
+
+	auto Draw = [&](u32 Frame)
+	{
+		gluon::timer Timer;
+		Timer.Start();
+
+		if (Frame % 10 == 9)
+		{
+			Buffer.Erase(--Position, 1);
+		}
+		else
+		{
+			Buffer.Insert(Position++, Frame % 100 == 50 ? U"\n" : U"x", 1);
+		}
+
+		Buffer.Draw(0.0f, (f32)k_WindowHeight, (f32)k_WindowWidth, (f32)k_WindowHeight, TextColor);
+
+		Times.push_back(Timer.GetElapsedSeconds());
+	};
+
+	RunFrames(Window, 60, Draw);
+	Times.clear();
+
+	const eastl::vector<f64> FrameTimes = RunFrames(Window, 1000, Draw);
+
+	PrintTimes("keystroke, edit and layout", Times);
+	PrintTimes("keystroke, frame", FrameTimes);
+
+	const gluon::text_buffer_stats Stats = Buffer.GetStats();
+	printf("%-32s %u pieces, %u paragraphs, %u laid out\n", "", Stats.PieceCount, Stats.ParagraphCount, Stats.CachedParagraphs);
+}
+
+//! CPU time of drawing a screen of Thai text whose layouts are shaped at every draw, then found in a warm layout cache
+static void RunShapingScenario(GLFWwindow* Window)
+{
+	StartRendering();
+	WaitForFont(Window, "Lamthong");
+
+	const gluon::color TextColor = gluon::MakeColorFromRGB8(20, 20, 20);
+
+	for (bool Warm : {false, true})
+	{
+		gluon::SetLayoutCacheBudget(Warm ? 4 * 1024 * 1024 : 0);
+
+		eastl::vector<f64> Times;
+
+		auto Draw = [&](u32 Frame)
+		{
+			gluon::timer Timer;
+			Timer.Start();
+
+			// Cold lines differ at every frame, the single entry the cache keeps never matches
+			for (u32 Line = 0; Line < 48; ++Line)
+			{
+				char Text[256];
+				snprintf(Text, sizeof(Text), "น้ำท่วมที่กำลังผ่านไป ผู้ใหญ่บ้านปิ่นโตทำดี %u %u", Warm ? 0 : Frame, Line);
+
+				gluon::DrawText(Text, 14.0f, 16.0f, (f32)(k_WindowHeight - 16 - Line * 15), TextColor);
+			}
+
+			Times.push_back(Timer.GetElapsedSeconds());
+		};
+
+		RunFrames(Window, 60, Draw);
+		Times.clear();
+		RunFrames(Window, 600, Draw);
+
+		PrintTimes(Warm ? "48 Thai lines, warm cache" : "48 Thai lines, shaped each draw", Times);
+
+		const gluon::layout_cache_stats Stats = gluon::GetLayoutCacheStats();
+		printf("%-32s %u hits, %u misses, %.1fKB cached\n", "", Stats.Hits, Stats.Misses, Stats.MemoryUsed / 1024.0);
+	}
+}
+
+//! Frame time of a page of small texts drawn as glyphs and greeked, @see gluon::SetTextLodThresholds(). The number of glyph instances
+//! avoided is reported with it, to pick the size below which greeking pays off.
+static void RunGreekingScenario(GLFWwindow* Window)
+{
+	StartRendering();
+	WaitForFont(Window, "roboto");
+
+	const gluon::color TextColor = gluon::MakeColorFromRGB8(20, 20, 20);
+
+	for (f32 PixelSize : {4.0f, 6.0f, 8.0f})
+	{
+		const u32 LineCount = (u32)(k_WindowHeight / PixelSize);
+
+		for (bool Greeked : {false, true})
+		{
+			gluon::SetTextLodThresholds(Greeked ? PixelSize + 1.0f : 0.0f, 0.0f);
+
+			gluon::text_stats Stats;
+
+			auto Draw = [&](u32)
+			{
+				for (u32 Line = 0; Line < LineCount; ++Line)
+				{
+					for (u32 Column = 0; Column < 4; ++Column)
+					{
+						gluon::DrawText("The quick brown fox jumps over the lazy dog 0123456789",
+						                PixelSize,
+						                (f32)(8 + Column * 320),
+						                (f32)k_WindowHeight - Line * PixelSize,
+						                TextColor);
+					}
+				}
+
+				// Stats of the previous frame
+				Stats = gluon::GetTextStats();
+			};
+
+			RunFrames(Window, 60, Draw);
+
+			char Label[64];
+			snprintf(Label, sizeof(Label), "%u texts, %.0fpx, %s", LineCount * 4, PixelSize, Greeked ? "greeked" : "glyphs");
+			PrintTimes(Label, RunFrames(Window, 600, Draw));
+
+			if (Greeked)
+			{
+				printf("%-32s %u texts greeked, %u glyph instances avoided\n", "", Stats.GreekedTexts, Stats.AvoidedGlyphs);
+			}
+		}
+	}
+
+	gluon::SetTextLodThresholds(0.0f, 0.0f);
+}
+
+//! Long unwrapped texts laid out on the CPU and by the layout shader, to find the length from which the GPU is faster
+static void RunGpuLayoutScenario(GLFWwindow* Window)
+{
+	StartRendering();
+	WaitForFont(Window, "roboto");
+
+	gluon::SetLayoutCacheBudget(0);
+
+	constexpr u32 k_LineCount = 16;
+
+	const gluon::color TextColor = gluon::MakeColorFromRGB8(20, 20, 20);
+
+	for (u32 Length : {64u, 256u, 1024u, 4096u, 16384u})
+	{
+		// Every line differs, so that none is found in the single entry the cache keeps
+		eastl::vector<eastl::string> Lines;
+		for (u32 Line = 0; Line < k_LineCount; ++Line)
+		{
+			char Prefix[16];
+			snprintf(Prefix, sizeof(Prefix), "%02u ", Line);
+
+			eastl::string Text = Prefix;
+			while (Text.size() < Length)
+			{
+				Text += "Lorem ipsum dolor sit amet, consectetur adipiscing elit. ";
+			}
+
+			Text.resize(Length);
+			Lines.push_back(Text);
+		}
+
+		for (bool Gpu : {false, true})
+		{
+			gluon::SetGpuTextLayoutThreshold(Gpu ? Length : 0);
+
+			eastl::vector<f64> Times;
+
+			auto Draw = [&](u32)
+			{
+				gluon::timer Timer;
+				Timer.Start();
+
+				for (u32 Line = 0; Line < k_LineCount; ++Line)
+				{
+					gluon::DrawText(Lines[Line].c_str(), 14.0f, 16.0f, (f32)(k_WindowHeight - 16 - Line * 15), TextColor);
+				}
+
+				Times.push_back(Timer.GetElapsedSeconds());
+			};
+
+			// The layout shader is compiled in the background, its texts are laid out on the CPU until it is ready
+			while (Gpu && gluon::GetTextStats().GpuLaidOutTexts == 0)
+			{
+				RunFrames(Window, 1, Draw);
+			}
+
+			RunFrames(Window, 60, Draw);
+			Times.clear();
+
+			const eastl::vector<f64> FrameTimes = RunFrames(Window, 600, Draw);
+
+			char Label[64];
+			snprintf(Label, sizeof(Label), "%u x %u codepoints, %s, CPU", k_LineCount, Length, Gpu ? "GPU" : "CPU");
+			PrintTimes(Label, Times);
+
+			snprintf(Label, sizeof(Label), "%u x %u codepoints, %s, frame", k_LineCount, Length, Gpu ? "GPU" : "CPU");
+			PrintTimes(Label, FrameTimes);
+		}
+	}
+}
+
+//! Static labels drawn with distance field shading and from the bitmap cache, at a few sizes since the fragment cost grows with the
+//! covered area. Frame times include the GPU, the OpenGL backend is the one with a cache.
+static void RunBitmapCacheScenario(GLFWwindow* Window)
+{
+	StartRendering();
+	WaitForFont(Window, "roboto");
+
+	constexpr u32 k_LabelCount = 2048;
+
+	const gluon::color TextColor = gluon::MakeColorFromRGB8(20, 20, 20);
+
+	eastl::vector<eastl::string> Labels;
+	for (u32 Label = 0; Label < k_LabelCount; ++Label)
+	{
+		char Text[64];
+		snprintf(Text, sizeof(Text), "Label %u, value %u", Label, Label * 7919);
+
+		Labels.push_back(Text);
+	}
+
+	for (f32 PixelSize : {10.0f, 16.0f, 24.0f})
+	{
+		for (bool Cached : {false, true})
+		{
+			gluon::SetTextBitmapCache(Cached ? 4096 : 0, 24.0f, 4);
+
+			u32 BitmapTexts = 0;
+
+			auto Draw = [&](u32)
+			{
+				for (u32 Label = 0; Label < k_LabelCount; ++Label)
+				{
+					const f32 X = (f32)(16 + (Label % 8) * 156);
+					const f32 Y = (f32)(k_WindowHeight - 12 - (Label / 8) * 2.5f);
+
+					gluon::DrawText(Labels[Label].c_str(), PixelSize, X, Y, TextColor);
+				}
+
+				BitmapTexts = gluon::GetTextStats().BitmapTexts;
+			};
+
+			// Texts are rasterized in the atlas once drawn for MinFrames frames
+			RunFrames(Window, 60, Draw);
+
+			char Label[64];
+			snprintf(Label, sizeof(Label), "%u labels, %.0fpx, %s", k_LabelCount, PixelSize, Cached ? "bitmap cache" : "distance field");
+			PrintTimes(Label, RunFrames(Window, 600, Draw));
+
+			if (Cached)
+			{
+				printf("%-32s %u texts drawn from the cache\n", "", BitmapTexts);
+			}
+		}
+	}
+
+	gluon::SetTextBitmapCache(0);
+}
+
+//! A scene ten viewports tall scrolled through, most rectangles and texts fall outside of the viewport and are culled as they are drawn
+static void RunCullingScenario(GLFWwindow* Window)
+{
+	StartRendering();
+	WaitForFont(Window, "roboto");
+
+	constexpr u32 k_RowCount = 480;
+	constexpr f32 k_RowStep  = 15.0f;
+
+	const gluon::color TextColor = gluon::MakeColorFromRGB8(20, 20, 20);
+
+	eastl::vector<f64>   Times;
+	gluon::culling_stats Culling;
+
+	auto Draw = [&](u32 Frame)
+	{
+		gluon::timer Timer;
+		Timer.Start();
+
+		const f32 Scroll = (f32)(Frame % 600) * 10.0f;
+
+		for (u32 Row = 0; Row < k_RowCount; ++Row)
+		{
+			const f32 Y = (f32)Row * k_RowStep - Scroll;
+
+			for (u32 Column = 0; Column < 16; ++Column)
+			{
+				gluon::DrawRectangle((f32)(Column * 80), Y, 72.0f, 12.0f, gluon::MakeColorFromRGB8((u8)Row, 128, (u8)Column), 2.0f);
+			}
+
+			gluon::DrawText("The quick brown fox jumps over the lazy dog", 12.0f, 16.0f, (f32)k_WindowHeight - Y, TextColor);
+		}
+
+		Times.push_back(Timer.GetElapsedSeconds());
+
+		// Stats of the previous frame
+		Culling = gluon::GetCullingStats();
+	};
+
+	RunFrames(Window, 60, Draw);
+	Times.clear();
+
+	const eastl::vector<f64> FrameTimes = RunFrames(Window, 600, Draw);
+
+	PrintTimes("culling, draw calls", Times);
+	PrintTimes("culling, frame", FrameTimes);
+	printf("%-32s %u of %u rectangles and %u of %u texts culled, %.1fKB saved\n",
+	       "",
+	       Culling.CulledRectangles,
+	       k_RowCount * 16,
+	       Culling.CulledTexts,
+	       k_RowCount,
+	       Culling.SavedBytes / 1024.0);
+}
+
+static const scenario k_Scenarios[] = {
+    {"frame", "Frame time of a rectangles and text scene, to compare the backends", RunFrameScenario},
+    {"dispatch", "Backend call overhead, to compare the static and dynamic dispatch builds", RunDispatchScenario},
+    {"startup", "Context creation and first complete frame, with a cold then a warm program cache", RunStartupScenario},
+    {"fontload", "Load time of an embedded font and of fonts read from the disk, and the longest frame meanwhile", RunFontLoadScenario},
+    {"glyphlookup", "Glyph lookups through the page-indexed table and through a hash map", RunGlyphLookupScenario},
+    {"kerning", "Layout time of a screen of text with and without kerning, the layout cache being disabled", RunKerningScenario},
+    {"retained", "Static labels drawn as immediate and as retained texts", RunRetainedScenario},
+    {"utf8", "UTF-8 decoding throughput of the vectorized decoder and of a scalar one", RunUtf8Scenario},
+    {"textview", "Text view over 10M lines: indexing, scrolling and live resize", RunTextViewScenario},
+    {"keystroke", "Latency of a keystroke in a 1MB document", RunKeystrokeScenario},
+    {"shaping", "Layout time of Thai text shaped at every draw and found in a warm layout cache", RunShapingScenario},
+    {"greeking", "Frame time of small texts drawn as glyphs and as greeking bars, at a few sizes", RunGreekingScenario},
+    {"bitmapcache", "Frame time of small labels with and without the bitmap cache, at a few sizes", RunBitmapCacheScenario},
+    {"culling", "Draw and frame time of a scene mostly outside of the viewport, and what culling dropped", RunCullingScenario},
+    {"gpulayout", "Layout of long texts on the CPU and by the layout shader, over a range of lengths", RunGpuLayoutScenario},
+};
+
+i32 main(i32 ArgCount, char** Args)
+{
+	const char*     ScenarioName = ArgCount > 1 ? Args[1] : "frame";
+	const scenario* Scenario     = nullptr;
+
+	for (const scenario& Candidate : k_Scenarios)
+	{
+		if (strcmp(Candidate.Name, ScenarioName) == 0)
+		{
+			Scenario = &Candidate;
+		}
+	}
+
+	if (Scenario == nullptr)
+	{
+		printf("Usage: benchmark <scenario>\n");
+		for (const scenario& Candidate : k_Scenarios)
+		{
+			printf("  %-12s %s\n", Candidate.Name, Candidate.Description);
+		}
+		return 1;
+	}
+
+	if (!glfwInit())
+	{
+		return 1;
+	}
+
+	glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+	GLFWwindow* Window = glfwCreateWindow(k_WindowWidth, k_WindowHeight, "Gluon benchmark", nullptr, nullptr);
+	if (Window == nullptr)
+	{
+		glfwTerminate();
+		return 1;
+	}
+
+	glfwMakeContextCurrent(Window);
+	glfwSwapInterval(0);
+
+	Scenario->Run(Window);
+
+	gluon::priv::DestroyRenderingContext();
+
+	glfwDestroyWindow(Window);
+	glfwTerminate();
+
+	return 0;
+}
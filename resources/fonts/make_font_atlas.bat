@@ -1 +1,4 @@
-msdf-atlas-gen -font %1.ttf -charset charset.txt -format png -imageout %1.png -json %1.json -size 96 -pxrange 8 -errorcorrection 1.0 -nooverlap -angle 3.0 -type msdf
+rem Usage: make_font_atlas <font> [sdf|msdf|mtsdf], sdf atlases take a third of the memory of msdf ones
+set Type=%2
+if "%Type%"=="" set Type=msdf
+msdf-atlas-gen -font %1.ttf -charset charset.txt -format png -imageout %1.png -json %1.json -size 96 -pxrange 8 -errorcorrection 1.0 -nooverlap -angle 3.0 -type %Type%
@@ -17,8 +17,17 @@ layout (std430, binding=1) buffer rect_infos
 	rectangle_info[] u_RectangleInfos;
 };
 
+#ifdef VULKAN
+layout (std140, set = 0, binding = 0) uniform frame_uniforms
+{
+	mat4 u_View;
+	mat4 u_Proj;
+	vec2 u_ViewportSize;
+};
+#else
 uniform vec2 u_ViewportSize;
 uniform mat4 u_View;
+#endif
 
 float GetRectangleAlpha(vec2 Position, vec2 Center, vec2 Size, float Radius)
 {
@@ -17,19 +17,34 @@ layout (std430, binding=1) buffer rect_infos
 layout (location = 0) flat out uint InstanceID;
 layout (location = 1) out vec2 OutPosition;
 
+#ifdef VULKAN
+layout (std140, set = 0, binding = 0) uniform frame_uniforms
+{
+	mat4 u_View;
+	mat4 u_Proj;
+	vec2 u_ViewportSize;
+};
+#else
 uniform mat4 u_View;
 uniform mat4 u_Proj;
+#endif
+
+#ifdef VULKAN
+#	define INSTANCE_INDEX gl_InstanceIndex
+#else
+#	define INSTANCE_INDEX gl_InstanceID
+#endif
 
 void main()
 {
-    vec2 Translation = u_RectangleInfos[gl_InstanceID].PositionSize.xy;
+    vec2 Translation = u_RectangleInfos[INSTANCE_INDEX].PositionSize.xy;
     Translation = mix(Translation - 100, Translation + 100, in_Position * 0.5 + 0.5);
-    vec2 Scale = u_RectangleInfos[gl_InstanceID].PositionSize.zw;
+    vec2 Scale = u_RectangleInfos[INSTANCE_INDEX].PositionSize.zw;
 
     vec2 Position = in_Position * Scale + Translation;
     gl_Position = u_Proj * u_View * vec4(Position, 0, 1);
 
     OutPosition = vec2(u_View * vec4(Position, 0, 1));
 
-    InstanceID = gl_InstanceID;
+    InstanceID = INSTANCE_INDEX;
 }
@@ -3,12 +3,35 @@
 layout (location = 0) flat in uint InstanceID;
 layout (location = 1) in vec2 Position;
 layout (location = 2) in vec2 Texcoord;
-layout (location = 3) flat in uint TextureIndex;
+layout (location = 3) flat in uint Layer;
 layout (location = 4) in vec4 FillColor;
 
 layout (location = 0) out vec4 out_Color;
 
-uniform sampler2D u_Textures[16];
+// Fonts of the same atlas size and type share an array, one layer each
+#ifdef VULKAN
+layout (set = 0, binding = 4) uniform sampler2DArray u_FontAtlases;
+#else
+uniform sampler2DArray u_FontAtlases;
+#endif
+
+// Channel count of the atlases of the array (1 SDF, 3 MSDF, 4 MTSDF), and their distance range in texels. 0 is the coverage atlas of
+// cached small texts, which holds alpha already resolved by this shader.
+#ifdef VULKAN
+layout (std140, set = 0, binding = 0) uniform frame_uniforms
+{
+	mat4 u_View;
+	mat4 u_Proj;
+	vec2 u_ViewportSize;
+	uint u_FontArray;
+	uint u_AtlasType;
+	float u_DistanceRange;
+	uint u_GlyphOffset;
+};
+#else
+uniform uint u_AtlasType;
+uniform float u_DistanceRange;
+#endif
 
 float Median(float r, float g, float b)
 {
@@ -22,7 +45,14 @@ const float borderEdge = 0.1;
 
 void main()
 {
-	vec3 Sample = texture(u_Textures[TextureIndex], Texcoord).rgb;
+	vec4 Sample = texture(u_FontAtlases, vec3(Texcoord, Layer));
+
+	// Texels are mapped one to one to pixels, no distance to resolve
+	if (u_AtlasType == 0u)
+	{
+		out_Color = vec4(FillColor.rgb, Sample.r);
+		return;
+	}
 	// vec3 DropShadowSample = texture(u_Textures[0], Texcoord + vec2(-0.0025, -0.0025)).rgb;
 
 	// float Distance = 1.0 - Median(Sample.r, Sample.g, Sample.b);
@@ -36,12 +66,14 @@ void main()
 
 	// out_Color = vec4(OverallColor, OverallAlpha);
 
-	float SignedDist = Median(Sample.r, Sample.g, Sample.b) - 0.5;
+	// The type is the same for the whole draw. MTSDF atlases shade like MSDF ones, their alpha is the true distance.
+	float Distance = u_AtlasType == 1u ? Sample.r : Median(Sample.r, Sample.g, Sample.b);
+	float SignedDist = Distance - 0.5;
 
-	ivec2 TextureSize = textureSize(u_Textures[0], 0);
+	ivec2 TextureSize = textureSize(u_FontAtlases, 0).xy;
 	float dx = dFdx(Texcoord.x) * TextureSize.x;
 	float dy = dFdy(Texcoord.y) * TextureSize.y;
-	float ToPixels = 12 * inversesqrt(dx * dx + dy * dy);
+	float ToPixels = u_DistanceRange * inversesqrt(dx * dx + dy * dy);
 
 	float Opacity = clamp(SignedDist * ToPixels + 0.5, 0.0, 1.0);
 	out_Color = vec4(FillColor.rgb, Opacity);
@@ -8,32 +8,86 @@ struct glyph_info
 	vec4 Scale; // xy -> Scale, z -> GlobalScale
 	vec4 Texcoords;
 	vec4 FillColor;
-	uint TextureIndex;
+	uint TextureIndex; // Texture array in the high 16 bits, layer in the low ones
+	uint ObjectIndex;
 };
 
+// Retained texts, glyph positions are relative to their object
+struct text_object
+{
+	vec4 PositionVisible; // xy -> Position, z -> Visible
+	vec4 FillColor;
+};
+
+const uint NO_TEXT_OBJECT = 0xFFFFFFFFu;
+
 layout (std430, binding =1 ) buffer glyph_infos
 {
 	glyph_info[] u_GlyphInfos;
 };
 
+layout (std430, binding = 2) buffer text_objects
+{
+	text_object[] u_TextObjects;
+};
+
 layout (location = 0) flat out uint InstanceID;
 layout (location = 1) out vec2 OutPosition;
 layout (location = 2) out vec2 OutTexcoord;
-layout (location = 3) flat out uint TextureIndex;
+layout (location = 3) flat out uint Layer;
 layout (location = 4) out vec4 FillColor;
 
+#ifdef VULKAN
+layout (std140, set = 0, binding = 0) uniform frame_uniforms
+{
+	mat4 u_View;
+	mat4 u_Proj;
+	vec2 u_ViewportSize;
+	uint u_FontArray;
+	uint u_AtlasType;
+	float u_DistanceRange;
+	uint u_GlyphOffset;
+};
+#else
 uniform mat4 u_View;
 uniform mat4 u_Proj;
 uniform vec2 u_ViewportSize;
+uniform uint u_FontArray;
+uniform uint u_GlyphOffset; // First glyph of the range drawn
+#endif
+
+#ifdef VULKAN
+#	define INSTANCE_INDEX gl_InstanceIndex
+#else
+#	define INSTANCE_INDEX gl_InstanceID
+#endif
 
 void main()
 {
-	glyph_info GlyphInfos = u_GlyphInfos[gl_InstanceID];
+	uint GlyphIndex = u_GlyphOffset + uint(INSTANCE_INDEX);
+	glyph_info GlyphInfos = u_GlyphInfos[GlyphIndex];
 	vec2 Scale = GlyphInfos.Scale.xy;
 	float GlobalScale = GlyphInfos.Scale.z;
 
 	vec2 WorldPosition = GlyphInfos.PositionTranslate.xy;
 	vec2 Translate = GlyphInfos.PositionTranslate.zw;
+	vec4 GlyphColor = GlyphInfos.FillColor;
+
+	if (GlyphInfos.ObjectIndex != NO_TEXT_OBJECT)
+	{
+		text_object Object = u_TextObjects[GlyphInfos.ObjectIndex];
+
+		// Collapses the quad of hidden objects
+		Scale *= Object.PositionVisible.z;
+		WorldPosition += Object.PositionVisible.xy;
+		GlyphColor = Object.FillColor;
+	}
+
+	// Retained glyphs are drawn once per texture array they use, the ones stored in other arrays are collapsed
+	if ((GlyphInfos.TextureIndex >> 16) != u_FontArray)
+	{
+		Scale = vec2(0.0);
+	}
 
 	vec2 Position = in_Position + vec2(1, 0);
 	Position = (Position * Scale + Translate) * GlobalScale + WorldPosition;
@@ -46,7 +100,7 @@ void main()
 	vec4 InTexcoord = GlyphInfos.Texcoords;
 	OutTexcoord = vec2(InTexcoord[XIndex], InTexcoord[YIndex]);
 
-	InstanceID = gl_InstanceID;
-	TextureIndex = GlyphInfos.TextureIndex;
-	FillColor = GlyphInfos.FillColor;
+	InstanceID = GlyphIndex;
+	Layer = GlyphInfos.TextureIndex & 0xFFFFu;
+	FillColor = GlyphColor;
 }
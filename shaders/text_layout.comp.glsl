@@ -0,0 +1,215 @@
+#version 450
+
+// Lays out immediate texts from glyph ids, one workgroup per run. Advances are summed with a scan restarting at each line feed.
+layout (local_size_x = 256) in;
+
+#define GROUP_SIZE 256u
+
+struct glyph_info
+{
+	vec4 PositionTranslate;
+	vec4 Scale; // xy -> Scale, z -> GlobalScale
+	vec4 Texcoords;
+	vec4 FillColor;
+	uint TextureIndex; // Texture array in the high 16 bits, layer in the low ones
+	uint ObjectIndex;
+};
+
+const uint NO_TEXT_OBJECT = 0xFFFFFFFFu;
+
+// Glyph ids index the atlas table, line feeds and missing glyphs have reserved ids
+const uint MISSING_GLYPH = 0xFFFFFFFFu;
+const uint LINE_FEED     = 0xFFFFFFFEu;
+
+// Atlas table entries, in words. Kerning pairs are stored after the glyphs of their font, as (right codepoint, advance) sorted by
+// codepoint.
+const uint GLYPH_SIZE          = 16u;
+const uint GLYPH_PLANE_BOUNDS  = 0u; // Left, bottom, right, top
+const uint GLYPH_TEXCOORDS     = 4u;
+const uint GLYPH_ADVANCE       = 8u;
+const uint GLYPH_TEXTURE_INDEX = 9u;
+const uint GLYPH_HAS_GEOMETRY  = 10u;
+const uint GLYPH_CODEPOINT     = 11u;
+const uint GLYPH_KERNING_BEGIN = 12u;
+const uint GLYPH_KERNING_COUNT = 13u;
+
+// Runs, in words
+const uint RUN_SIZE        = 12u;
+const uint RUN_FILL_COLOR  = 0u;
+const uint RUN_ORIGIN      = 4u;
+const uint RUN_SCALE       = 6u;
+const uint RUN_LINE_HEIGHT = 7u;
+const uint RUN_FIRST_GLYPH = 8u; // Index of the first glyph id after the runs, and of the first glyph written
+const uint RUN_GLYPH_COUNT = 9u;
+const uint RUN_FLAGS       = 10u;
+
+const uint RUN_KERNING = 1u;
+
+layout (std430, binding = 1) writeonly buffer glyph_infos
+{
+	glyph_info[] u_GlyphInfos;
+};
+
+layout (std430, binding = 2) readonly buffer atlas_glyphs
+{
+	uint[] u_AtlasGlyphs;
+};
+
+// One run per workgroup first, then the glyph ids of every run
+layout (std430, binding = 3) readonly buffer layout_input
+{
+	uint[] u_Input;
+};
+
+shared float s_Advances[GROUP_SIZE];
+shared uint  s_LineFeeds[GROUP_SIZE];
+
+float ReadGlyphFloat(uint Glyph, uint Field) { return uintBitsToFloat(u_AtlasGlyphs[Glyph * GLYPH_SIZE + Field]); }
+
+vec4 ReadGlyphRect(uint Glyph, uint Field)
+{
+	return vec4(ReadGlyphFloat(Glyph, Field),
+	            ReadGlyphFloat(Glyph, Field + 1u),
+	            ReadGlyphFloat(Glyph, Field + 2u),
+	            ReadGlyphFloat(Glyph, Field + 3u));
+}
+
+float ReadRunFloat(uint Run, uint Field) { return uintBitsToFloat(u_Input[Run + Field]); }
+
+float GetKerning(uint Left, uint RightCodepoint)
+{
+	uint Begin = u_AtlasGlyphs[Left * GLYPH_SIZE + GLYPH_KERNING_BEGIN];
+	uint Count = u_AtlasGlyphs[Left * GLYPH_SIZE + GLYPH_KERNING_COUNT];
+
+	uint First     = 0u;
+	uint Remaining = Count;
+
+	while (Remaining > 0u)
+	{
+		uint Step = Remaining / 2u;
+
+		if (u_AtlasGlyphs[Begin + (First + Step) * 2u] < RightCodepoint)
+		{
+			First += Step + 1u;
+			Remaining -= Step + 1u;
+		}
+		else
+		{
+			Remaining = Step;
+		}
+	}
+
+	if (First < Count && u_AtlasGlyphs[Begin + First * 2u] == RightCodepoint)
+	{
+		return uintBitsToFloat(u_AtlasGlyphs[Begin + First * 2u + 1u]);
+	}
+
+	return 0.0;
+}
+
+void main()
+{
+	uint Run   = gl_WorkGroupID.x * RUN_SIZE;
+	uint Local = gl_LocalInvocationID.x;
+
+	vec4  FillColor   = vec4(ReadRunFloat(Run, RUN_FILL_COLOR),
+	                         ReadRunFloat(Run, RUN_FILL_COLOR + 1u),
+	                         ReadRunFloat(Run, RUN_FILL_COLOR + 2u),
+	                         ReadRunFloat(Run, RUN_FILL_COLOR + 3u));
+	vec2  Origin      = vec2(ReadRunFloat(Run, RUN_ORIGIN), ReadRunFloat(Run, RUN_ORIGIN + 1u));
+	float Scale       = ReadRunFloat(Run, RUN_SCALE);
+	float LineHeight  = ReadRunFloat(Run, RUN_LINE_HEIGHT);
+	uint  FirstOutput = u_Input[Run + RUN_FIRST_GLYPH];
+	uint  FirstInput  = gl_NumWorkGroups.x * RUN_SIZE + FirstOutput;
+	uint  GlyphCount  = u_Input[Run + RUN_GLYPH_COUNT];
+	bool  HasKerning  = (u_Input[Run + RUN_FLAGS] & RUN_KERNING) != 0u;
+
+	// Pen position and line of the end of the previous chunks
+	float PenCarry  = 0.0;
+	uint  LineCarry = 0u;
+
+	for (uint ChunkBegin = 0u; ChunkBegin < GlyphCount; ChunkBegin += GROUP_SIZE)
+	{
+		uint Index = ChunkBegin + Local;
+		uint Glyph = Index < GlyphCount ? u_Input[FirstInput + Index] : MISSING_GLYPH;
+
+		float Advance = 0.0;
+		float Kerning = 0.0;
+
+		if (Glyph < LINE_FEED)
+		{
+			Advance = ReadGlyphFloat(Glyph, GLYPH_ADVANCE) * Scale;
+
+			// Pairs are broken by line feeds and missing glyphs
+			uint Previous = Index > 0u ? u_Input[FirstInput + Index - 1u] : MISSING_GLYPH;
+
+			if (HasKerning && Previous < LINE_FEED)
+			{
+				Kerning = GetKerning(Previous, u_AtlasGlyphs[Glyph * GLYPH_SIZE + GLYPH_CODEPOINT]) * Scale;
+			}
+		}
+
+		// Segmented inclusive scan, sums restart after the last line feed in range
+		s_Advances[Local]  = Kerning + Advance;
+		s_LineFeeds[Local] = Glyph == LINE_FEED ? 1u : 0u;
+
+		barrier();
+
+		for (uint Offset = 1u; Offset < GROUP_SIZE; Offset <<= 1u)
+		{
+			float Sum       = s_Advances[Local];
+			uint  LineFeeds = s_LineFeeds[Local];
+
+			if (Local >= Offset)
+			{
+				Sum       = LineFeeds > 0u ? Sum : s_Advances[Local - Offset] + Sum;
+				LineFeeds = s_LineFeeds[Local - Offset] + LineFeeds;
+			}
+
+			barrier();
+
+			s_Advances[Local]  = Sum;
+			s_LineFeeds[Local] = LineFeeds;
+
+			barrier();
+		}
+
+		if (Index < GlyphCount)
+		{
+			float LineEnd = s_LineFeeds[Local] > 0u ? s_Advances[Local] : PenCarry + s_Advances[Local];
+			uint  Line    = LineCarry + s_LineFeeds[Local];
+
+			glyph_info Info;
+			Info.PositionTranslate = vec4(Origin.x + LineEnd - Advance, Origin.y - float(Line) * LineHeight, 0.0, 0.0);
+			Info.Scale             = vec4(0.0, 0.0, Scale, 0.0);
+			Info.Texcoords         = vec4(0.0);
+			Info.FillColor         = FillColor;
+			Info.TextureIndex      = 0u;
+			Info.ObjectIndex       = NO_TEXT_OBJECT;
+
+			// Line feeds, missing and empty glyphs have collapsed quads
+			if (Glyph < LINE_FEED && u_AtlasGlyphs[Glyph * GLYPH_SIZE + GLYPH_HAS_GEOMETRY] != 0u)
+			{
+				vec4 Bounds = ReadGlyphRect(Glyph, GLYPH_PLANE_BOUNDS);
+				vec2 Size   = (Bounds.zw - Bounds.xy) * 0.5;
+
+				Info.PositionTranslate.zw = vec2(Bounds.x, Bounds.y + Size.y);
+				Info.Scale.xy             = Size;
+				Info.Texcoords            = ReadGlyphRect(Glyph, GLYPH_TEXCOORDS);
+				Info.TextureIndex         = u_AtlasGlyphs[Glyph * GLYPH_SIZE + GLYPH_TEXTURE_INDEX];
+			}
+
+			u_GlyphInfos[FirstOutput + Index] = Info;
+		}
+
+		uint  Last          = GROUP_SIZE - 1u;
+		float ChunkAdvance  = s_Advances[Last];
+		uint  ChunkLineFeed = s_LineFeeds[Last];
+
+		PenCarry  = ChunkLineFeed > 0u ? ChunkAdvance : PenCarry + ChunkAdvance;
+		LineCarry = LineCarry + ChunkLineFeed;
+
+		// The next chunk overwrites the shared arrays
+		barrier();
+	}
+}
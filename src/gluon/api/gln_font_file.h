@@ -0,0 +1,62 @@
+#pragma once
+
+#include <gluon/core/gln_defines.h>
+
+namespace gluon
+{
+// Binary font atlas, produced from a msdf-atlas-gen json/png pair by tools/font_converter.
+// The file is laid out as the header, the glyphs sorted by unicode, the kerning pairs sorted by (Unicode1, Unicode2) and the
+// raw texels, top row first. Each section starts on a k_FontFileAlignment boundary so that it can be read in place from a mapping.
+static constexpr u32 k_FontFileMagic     = 0x464E4C47; // GLNF
+static constexpr u32 k_FontFileVersion   = 3;
+static constexpr u64 k_FontFileAlignment = 16;
+
+struct font_file_header
+{
+	u32 Magic;
+	u32 Version;
+
+	f32 LineHeight;
+	f32 Ascender;
+	f32 Descender;
+	f32 UnderlineY;
+	f32 UnderlineThickness;
+
+	u32 Width;
+	u32 Height;
+	u32 ComponentCount; // @see font_atlas_type
+	f32 DistanceRange;
+
+	u32 GlyphCount;
+	u32 KerningCount;
+	u32 Reserved;
+
+	u64 GlyphOffset;
+	u64 KerningOffset;
+	u64 TexelOffset;
+	u64 TexelSize;
+};
+
+struct font_file_glyph
+{
+	u32 Unicode;
+	f32 Advance;
+
+	// Same conventions as glyph, texcoords are normalized
+	f32 PlaneLeft, PlaneRight, PlaneTop, PlaneBottom;
+	f32 TexLeft, TexRight, TexTop, TexBottom;
+
+	u32 HasGeometry;
+};
+
+struct font_file_kerning
+{
+	u32 Unicode1;
+	u32 Unicode2;
+	f32 Advance;
+};
+
+static_assert(sizeof(font_file_header) == 88, "The font file header layout is part of the format");
+static_assert(sizeof(font_file_glyph) == 44, "The font file glyph layout is part of the format");
+static_assert(sizeof(font_file_kerning) == 12, "The font file kerning layout is part of the format");
+}
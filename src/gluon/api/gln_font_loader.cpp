@@ -0,0 +1,127 @@
+#include <gluon/api/gln_font_loader_p.h>
+
+#include <EASTL/string.h>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace gluon
+{
+namespace priv
+{
+	struct font_load_request
+	{
+		u32           FontIndex;
+		eastl::string FontName;
+	};
+
+	struct font_loader
+	{
+		std::thread             Thread;
+		std::mutex              Mutex;
+		std::condition_variable Condition;
+
+		// Both queues are protected by Mutex
+		eastl::vector<font_load_request> Requests;
+		eastl::vector<loaded_font>       LoadedFonts;
+
+		bool Running = false;
+	};
+
+	static font_loader* g_FontLoader = nullptr;
+
+	static void FontLoaderThread(font_loader* Loader)
+	{
+		while (true)
+		{
+			font_load_request Request;
+
+			{
+				std::unique_lock<std::mutex> Lock(Loader->Mutex);
+				Loader->Condition.wait(Lock, [Loader] { return !Loader->Running || !Loader->Requests.empty(); });
+
+				if (!Loader->Running)
+				{
+					return;
+				}
+
+				Request = eastl::move(Loader->Requests.front());
+				Loader->Requests.erase(Loader->Requests.begin());
+			}
+
+			font_atlas Atlas = LoadFontAtlas(Request.FontName.c_str());
+
+			{
+				std::lock_guard<std::mutex> Lock(Loader->Mutex);
+				Loader->LoadedFonts.push_back({Request.FontIndex, eastl::move(Atlas)});
+			}
+		}
+	}
+
+	void StartFontLoader()
+	{
+		if (g_FontLoader != nullptr)
+		{
+			return;
+		}
+
+		g_FontLoader          = new font_loader();
+		g_FontLoader->Running = true;
+		g_FontLoader->Thread  = std::thread(FontLoaderThread, g_FontLoader);
+	}
+
+	void StopFontLoader()
+	{
+		if (g_FontLoader == nullptr)
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> Lock(g_FontLoader->Mutex);
+			g_FontLoader->Running = false;
+		}
+
+		g_FontLoader->Condition.notify_one();
+		g_FontLoader->Thread.join();
+
+		// Fonts decoded but never collected
+		for (auto& LoadedFont : g_FontLoader->LoadedFonts)
+		{
+			ReleaseFontAtlas(&LoadedFont.Atlas);
+		}
+
+		delete g_FontLoader;
+		g_FontLoader = nullptr;
+	}
+
+	void RequestFontLoad(u32 FontIndex, const char* FontName)
+	{
+		{
+			std::lock_guard<std::mutex> Lock(g_FontLoader->Mutex);
+			g_FontLoader->Requests.push_back({FontIndex, FontName});
+		}
+
+		g_FontLoader->Condition.notify_one();
+	}
+
+	void CollectLoadedFonts(eastl::vector<loaded_font>* LoadedFonts)
+	{
+		std::unique_lock<std::mutex> Lock(g_FontLoader->Mutex, std::try_to_lock);
+
+		// The worker only holds the lock briefly, the fonts will be collected next frame
+		if (!Lock.owns_lock() || g_FontLoader->LoadedFonts.empty())
+		{
+			return;
+		}
+
+		for (auto& LoadedFont : g_FontLoader->LoadedFonts)
+		{
+			LoadedFonts->push_back(eastl::move(LoadedFont));
+		}
+
+		g_FontLoader->LoadedFonts.clear();
+	}
+}
+}
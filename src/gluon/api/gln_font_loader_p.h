@@ -0,0 +1,27 @@
+#pragma once
+
+#include <gluon/api/gln_text.h>
+
+#include <EASTL/vector.h>
+
+/// This is a private header, it should not be included outside of the gluon api files.
+namespace gluon
+{
+namespace priv
+{
+	struct loaded_font
+	{
+		u32        FontIndex;
+		font_atlas Atlas;
+	};
+
+	//! Atlases are decoded on a background thread, only the texture upload is left to the render thread
+	void StartFontLoader();
+	void StopFontLoader();
+
+	void RequestFontLoad(u32 FontIndex, const char* FontName);
+
+	//! Appends the fonts decoded since the last call, does not block
+	void CollectLoadedFonts(eastl::vector<loaded_font>* LoadedFonts);
+}
+}
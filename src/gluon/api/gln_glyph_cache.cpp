@@ -0,0 +1,341 @@
+#include <gluon/api/gln_glyph_cache_p.h>
+
+#include <EASTL/algorithm.h>
+
+#include <loguru.hpp>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <string.h>
+
+namespace gluon
+{
+void skyline_packer::Reset(u32 Width, u32 Height)
+{
+	m_Width  = Width;
+	m_Height = Height;
+
+	m_Skyline.clear();
+	m_Skyline.push_back({0, 0, Width});
+}
+
+bool skyline_packer::Pack(u32 Width, u32 Height, u32* X, u32* Y)
+{
+	u32 BestIndex = 0xFFFFFFFF;
+	u32 BestY     = m_Height;
+	u32 BestWidth = m_Width;
+
+	for (u32 Index = 0; Index < (u32)m_Skyline.size(); ++Index)
+	{
+		const u32 Left = m_Skyline[Index].X;
+
+		if (Left + Width > m_Width)
+		{
+			break;
+		}
+
+		// The rectangle rests on the highest segment it spans
+		u32 Top       = 0;
+		u32 Remaining = Width;
+
+		for (u32 Spanned = Index; Remaining > 0; ++Spanned)
+		{
+			const segment& Segment = m_Skyline[Spanned];
+
+			Top       = eastl::max(Top, Segment.Y);
+			Remaining = Remaining > Segment.Width ? Remaining - Segment.Width : 0;
+		}
+
+		if (Top + Height > m_Height)
+		{
+			continue;
+		}
+
+		if (Top < BestY || (Top == BestY && m_Skyline[Index].Width < BestWidth))
+		{
+			BestIndex = Index;
+			BestY     = Top;
+			BestWidth = m_Skyline[Index].Width;
+		}
+	}
+
+	if (BestIndex == 0xFFFFFFFF)
+	{
+		return false;
+	}
+
+	*X = m_Skyline[BestIndex].X;
+	*Y = BestY;
+
+	// The new segment replaces the ones under the rectangle, the last one is shortened
+	const segment NewSegment = {*X, BestY + Height, Width};
+	m_Skyline.insert(m_Skyline.begin() + BestIndex, NewSegment);
+
+	const u32 Right = *X + Width;
+
+	while (BestIndex + 1 < (u32)m_Skyline.size())
+	{
+		segment& Next = m_Skyline[BestIndex + 1];
+
+		if (Next.X >= Right)
+		{
+			break;
+		}
+
+		const u32 Overlap = Right - Next.X;
+
+		if (Overlap < Next.Width)
+		{
+			Next.X += Overlap;
+			Next.Width -= Overlap;
+			break;
+		}
+
+		m_Skyline.erase(m_Skyline.begin() + BestIndex + 1);
+	}
+
+	// Merge segments at the same height
+	for (u32 Index = 0; Index + 1 < (u32)m_Skyline.size();)
+	{
+		if (m_Skyline[Index].Y == m_Skyline[Index + 1].Y)
+		{
+			m_Skyline[Index].Width += m_Skyline[Index + 1].Width;
+			m_Skyline.erase(m_Skyline.begin() + Index + 1);
+		}
+		else
+		{
+			++Index;
+		}
+	}
+
+	return true;
+}
+
+namespace priv
+{
+	bool LoadDynamicFont(const char* FontName, u32 PageCount, dynamic_font* Font, font_atlas* Atlas)
+	{
+		char FontPath[256] = "resources/fonts/";
+		strcat(FontPath, FontName);
+		strcat(FontPath, ".ttf");
+
+		if (!MapFile(FontPath, &Font->File))
+		{
+			LOG_F(ERROR, "Cannot open font %s", FontPath);
+			return false;
+		}
+
+		const i32 Offset = stbtt_GetFontOffsetForIndex(Font->File.Data, 0);
+
+		if (Offset < 0 || !stbtt_InitFont(&Font->Info, Font->File.Data, Offset))
+		{
+			LOG_F(ERROR, "%s is not a valid TrueType font", FontPath);
+			UnmapFile(&Font->File);
+			return false;
+		}
+
+		Font->PixelScale = stbtt_ScaleForMappingEmToPixels(&Font->Info, k_DynamicGlyphSize);
+		Font->EmScale    = stbtt_ScaleForMappingEmToPixels(&Font->Info, 1.0f);
+
+		i32 Ascent, Descent, LineGap;
+		stbtt_GetFontVMetrics(&Font->Info, &Ascent, &Descent, &LineGap);
+
+		Atlas->Width                      = k_GlyphPageWidth;
+		Atlas->Height                     = k_GlyphPageHeight * PageCount;
+		Atlas->Type                       = FontAtlasType_MSDF;
+		Atlas->DistanceRange              = 2.0f * k_DynamicGlyphPadding;
+		Atlas->Metrics.Ascender           = Ascent * Font->EmScale;
+		Atlas->Metrics.Descender          = Descent * Font->EmScale;
+		Atlas->Metrics.LineHeight         = (Ascent - Descent + LineGap) * Font->EmScale;
+		Atlas->Metrics.UnderlineY         = Descent * Font->EmScale * 0.5f;
+		Atlas->Metrics.UnderlineThickness = Atlas->Metrics.LineHeight / 24.0f;
+
+		Font->Pages.resize(PageCount);
+
+		for (glyph_page& Page : Font->Pages)
+		{
+			Page.Packer.Reset(k_GlyphPageWidth, k_GlyphPageHeight);
+		}
+
+		return true;
+	}
+
+	void ReleaseDynamicFont(dynamic_font* Font)
+	{
+		UnmapFile(&Font->File);
+		Font->Pages.clear();
+	}
+
+	bool AddDynamicGlyph(const dynamic_font& Font, u32 Codepoint, glyph_table* Glyphs)
+	{
+		const i32 GlyphIndex = stbtt_FindGlyphIndex(&Font.Info, (i32)Codepoint);
+
+		if (GlyphIndex == 0)
+		{
+			return false;
+		}
+
+		i32 Advance, LeftSideBearing;
+		stbtt_GetGlyphHMetrics(&Font.Info, GlyphIndex, &Advance, &LeftSideBearing);
+
+		glyph Glyph       = {};
+		Glyph.Advance     = Advance * Font.EmScale;
+		Glyph.HasGeometry = stbtt_IsGlyphEmpty(&Font.Info, GlyphIndex) == 0;
+		Glyph.AtlasPage   = k_GlyphNotResident;
+
+		Glyphs->Insert(Codepoint, Glyph);
+
+		return true;
+	}
+
+	f32 GetDynamicKerning(dynamic_font* Font, u32 Left, u32 Right)
+	{
+		const u64 Key = ((u64)Left << 32) | Right;
+
+		auto Iterator = Font->Kernings.find(Key);
+
+		if (Iterator != Font->Kernings.end())
+		{
+			return Iterator->second;
+		}
+
+		const f32 Advance = stbtt_GetCodepointKernAdvance(&Font->Info, (i32)Left, (i32)Right) * Font->EmScale;
+		Font->Kernings.insert({Key, Advance});
+
+		return Advance;
+	}
+
+	struct glyph_raster_request
+	{
+		u32                 FontIndex;
+		u32                 Codepoint;
+		const dynamic_font* Font;
+	};
+
+	struct glyph_rasterizer
+	{
+		eastl::vector<std::thread> Threads;
+		std::mutex                 Mutex;
+		std::condition_variable    Condition;
+
+		// Both queues are protected by Mutex
+		eastl::vector<glyph_raster_request> Requests;
+		eastl::vector<rasterized_glyph>     Glyphs;
+
+		bool Running = false;
+	};
+
+	static glyph_rasterizer* g_GlyphRasterizer = nullptr;
+
+	static void RasterizeGlyph(const glyph_raster_request& Request, rasterized_glyph* Glyph)
+	{
+		const dynamic_font& Font       = *Request.Font;
+		const i32           GlyphIndex = stbtt_FindGlyphIndex(&Font.Info, (i32)Request.Codepoint);
+
+		Glyph->FontIndex = Request.FontIndex;
+		Glyph->Codepoint = Request.Codepoint;
+
+		GenerateGlyphMsdf(Font.Info, GlyphIndex, Font.PixelScale, k_DynamicGlyphPadding, Glyph);
+	}
+
+	static void GlyphRasterizerThread(glyph_rasterizer* Rasterizer)
+	{
+		while (true)
+		{
+			glyph_raster_request Request;
+
+			{
+				std::unique_lock<std::mutex> Lock(Rasterizer->Mutex);
+				Rasterizer->Condition.wait(Lock, [Rasterizer] { return !Rasterizer->Running || !Rasterizer->Requests.empty(); });
+
+				if (!Rasterizer->Running)
+				{
+					return;
+				}
+
+				Request = Rasterizer->Requests.back();
+				Rasterizer->Requests.pop_back();
+			}
+
+			rasterized_glyph Glyph;
+			RasterizeGlyph(Request, &Glyph);
+
+			{
+				std::lock_guard<std::mutex> Lock(Rasterizer->Mutex);
+				Rasterizer->Glyphs.push_back(eastl::move(Glyph));
+			}
+		}
+	}
+
+	void StartGlyphRasterizer()
+	{
+		if (g_GlyphRasterizer != nullptr)
+		{
+			return;
+		}
+
+		g_GlyphRasterizer          = new glyph_rasterizer();
+		g_GlyphRasterizer->Running = true;
+
+		// The render thread and the font loader keep a core each
+		const u32 ThreadCount = eastl::min(eastl::max(std::thread::hardware_concurrency(), 3u), 6u) - 2;
+
+		for (u32 ThreadIndex = 0; ThreadIndex < ThreadCount; ++ThreadIndex)
+		{
+			g_GlyphRasterizer->Threads.push_back(std::thread(GlyphRasterizerThread, g_GlyphRasterizer));
+		}
+	}
+
+	void StopGlyphRasterizer()
+	{
+		if (g_GlyphRasterizer == nullptr)
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> Lock(g_GlyphRasterizer->Mutex);
+			g_GlyphRasterizer->Running = false;
+		}
+
+		g_GlyphRasterizer->Condition.notify_all();
+
+		for (std::thread& Thread : g_GlyphRasterizer->Threads)
+		{
+			Thread.join();
+		}
+
+		delete g_GlyphRasterizer;
+		g_GlyphRasterizer = nullptr;
+	}
+
+	void RequestGlyphRaster(u32 FontIndex, const dynamic_font* Font, u32 Codepoint)
+	{
+		{
+			std::lock_guard<std::mutex> Lock(g_GlyphRasterizer->Mutex);
+			g_GlyphRasterizer->Requests.push_back({FontIndex, Codepoint, Font});
+		}
+
+		g_GlyphRasterizer->Condition.notify_one();
+	}
+
+	void CollectRasterizedGlyphs(eastl::vector<rasterized_glyph>* Glyphs)
+	{
+		std::unique_lock<std::mutex> Lock(g_GlyphRasterizer->Mutex, std::try_to_lock);
+
+		if (!Lock.owns_lock() || g_GlyphRasterizer->Glyphs.empty())
+		{
+			return;
+		}
+
+		for (auto& Glyph : g_GlyphRasterizer->Glyphs)
+		{
+			Glyphs->push_back(eastl::move(Glyph));
+		}
+
+		g_GlyphRasterizer->Glyphs.clear();
+	}
+}
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <gluon/api/gln_text.h>
+
+#include <gluon/core/gln_defines.h>
+#include <gluon/core/gln_mapped_file.h>
+
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+
+#include <stb_truetype.h>
+
+/// This is a private header, it should not be included outside of the gluon api files.
+namespace gluon
+{
+//! Skyline bin packer. The top of the packed area is kept as a list of horizontal segments, each rectangle goes where its top ends
+//! the lowest, which wastes little space with glyphs of similar heights.
+class skyline_packer
+{
+public:
+	void Reset(u32 Width, u32 Height);
+	bool Pack(u32 Width, u32 Height, u32* X, u32* Y);
+
+private:
+	struct segment
+	{
+		u32 X;
+		u32 Y;
+		u32 Width;
+	};
+
+	// Sorted by X, covering the whole width
+	eastl::vector<segment> m_Skyline;
+
+	u32 m_Width  = 0;
+	u32 m_Height = 0;
+};
+
+struct glyph_page
+{
+	skyline_packer     Packer;
+	u64                LastUsedFrame = 0;
+	eastl::vector<u32> Codepoints; // Resident glyphs, evicted with the page
+};
+
+// Glyphs are generated at a single size, the MSDF scales them to any other while keeping their corners sharp
+static constexpr f32 k_DynamicGlyphSize    = 32.0f;
+static constexpr i32 k_DynamicGlyphPadding = 4; // Distance range on each side of the outline
+
+static constexpr u32 k_GlyphPageWidth    = 1024;
+static constexpr u32 k_GlyphPageHeight   = 256;
+static constexpr u32 k_MaxGlyphPageCount = 32; // Pages used by a layout are tracked in a 32 bits mask
+
+//! Atlas filled at runtime from a TrueType font. Glyph metrics are read when a codepoint is first laid out, multi-channel signed
+//! distance fields are generated on worker threads, and the texture is split in pages that are recycled least recently used first.
+struct dynamic_font
+{
+	mapped_file    File;
+	stbtt_fontinfo Info;
+
+	f32 PixelScale; // Font units to k_DynamicGlyphSize pixels
+	f32 EmScale;    // Font units to em, the unit of the glyph metrics
+
+	eastl::vector<glyph_page> Pages;
+
+	// Glyphs which did not fit while every page was in use, they are not queued again before a page is recycled
+	eastl::vector<u32> FailedCodepoints;
+
+	// Kerning advances in em, keyed by the left codepoint in the high bits and the right one in the low bits
+	eastl::unordered_map<u64, f32> Kernings;
+};
+
+namespace priv
+{
+	bool LoadDynamicFont(const char* FontName, u32 PageCount, dynamic_font* Font, font_atlas* Atlas);
+	void ReleaseDynamicFont(dynamic_font* Font);
+
+	//! Reads the metrics of a codepoint, the glyph is not resident until it has been rasterized. False if the font lacks it.
+	bool AddDynamicGlyph(const dynamic_font& Font, u32 Codepoint, glyph_table* Glyphs);
+
+	//! Advance between two codepoints in em, read from the font the first time the pair is laid out
+	f32 GetDynamicKerning(dynamic_font* Font, u32 Left, u32 Right);
+
+	struct rasterized_glyph
+	{
+		u32 FontIndex;
+		u32 Codepoint;
+
+		i32 Width, Height;
+		i32 OffsetX, OffsetY; // From the pen position to the top left texel, y going down
+
+		// Three channels per texel, rows are padded to a multiple of 4 texels
+		i32               Stride;
+		eastl::vector<u8> Texels;
+	};
+
+	//! Multi-channel signed distance field of a glyph outline scaled to pixels, false if the glyph has no outline. @see gln_msdf.cpp
+	bool GenerateGlyphMsdf(const stbtt_fontinfo& Info, i32 GlyphIndex, f32 Scale, i32 Padding, rasterized_glyph* Glyph);
+
+	void StartGlyphRasterizer();
+	void StopGlyphRasterizer();
+
+	//! Font must stay alive until the rasterizer is stopped
+	void RequestGlyphRaster(u32 FontIndex, const dynamic_font* Font, u32 Codepoint);
+
+	//! Appends the glyphs rasterized since the last call, does not block
+	void CollectRasterizedGlyphs(eastl::vector<rasterized_glyph>* Glyphs);
+}
+}
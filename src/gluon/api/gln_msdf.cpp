@@ -0,0 +1,620 @@
+#include <gluon/api/gln_glyph_cache_p.h>
+
+#include <EASTL/algorithm.h>
+#include <EASTL/vector.h>
+
+#include <math.h>
+#include <float.h>
+
+// Multi-channel signed distance fields, generated the way msdfgen does without its error correction pass. Each edge of the outline
+// is given two of the three channels, so that the edges meeting at a corner share a single one. The median of the three distances
+// then keeps the corner sharp, where a single channel field rounds it.
+namespace gluon
+{
+namespace priv
+{
+	struct msdf_point
+	{
+		f64 X, Y;
+	};
+
+	static msdf_point operator+(msdf_point A, msdf_point B) { return {A.X + B.X, A.Y + B.Y}; }
+	static msdf_point operator-(msdf_point A, msdf_point B) { return {A.X - B.X, A.Y - B.Y}; }
+	static msdf_point operator*(f64 Scale, msdf_point A) { return {Scale * A.X, Scale * A.Y}; }
+
+	static f64 Dot(msdf_point A, msdf_point B) { return A.X * B.X + A.Y * B.Y; }
+	static f64 Cross(msdf_point A, msdf_point B) { return A.X * B.Y - A.Y * B.X; }
+	static f64 Length(msdf_point A) { return sqrt(Dot(A, A)); }
+
+	static msdf_point Normalize(msdf_point A)
+	{
+		const f64 L = Length(A);
+		return L > 0.0 ? (1.0 / L) * A : msdf_point{0.0, 1.0};
+	}
+
+	static f64 NonZeroSign(f64 Value) { return Value > 0.0 ? 1.0 : -1.0; }
+
+	static constexpr u32 k_MsdfRed     = 1;
+	static constexpr u32 k_MsdfGreen   = 2;
+	static constexpr u32 k_MsdfBlue    = 4;
+	static constexpr u32 k_MsdfCyan    = k_MsdfGreen | k_MsdfBlue;
+	static constexpr u32 k_MsdfMagenta = k_MsdfRed | k_MsdfBlue;
+	static constexpr u32 k_MsdfYellow  = k_MsdfRed | k_MsdfGreen;
+	static constexpr u32 k_MsdfWhite   = k_MsdfRed | k_MsdfGreen | k_MsdfBlue;
+
+	//! Quadratic Bezier, lines have their control point in the middle so that every edge goes through the same code
+	struct msdf_edge
+	{
+		msdf_point P0, P1, P2;
+		u32        Color;
+	};
+
+	struct msdf_contour
+	{
+		u32 Begin, End; // Range in the edges of the shape
+	};
+
+	//! Distance to the closest point of an edge, positive inside. Dot breaks ties at corners, the edge the point is the most in
+	//! front of wins.
+	struct msdf_distance
+	{
+		f64 Distance = -DBL_MAX;
+		f64 Dot      = 1.0;
+	};
+
+	static bool IsCloser(const msdf_distance& A, const msdf_distance& B)
+	{
+		const f64 DistanceA = fabs(A.Distance), DistanceB = fabs(B.Distance);
+		return DistanceA < DistanceB || (DistanceA == DistanceB && A.Dot < B.Dot);
+	}
+
+	static msdf_point StartDirection(const msdf_edge& Edge)
+	{
+		const msdf_point Direction = Edge.P1 - Edge.P0;
+		return Direction.X == 0.0 && Direction.Y == 0.0 ? Edge.P2 - Edge.P0 : Direction;
+	}
+
+	static msdf_point EndDirection(const msdf_edge& Edge)
+	{
+		const msdf_point Direction = Edge.P2 - Edge.P1;
+		return Direction.X == 0.0 && Direction.Y == 0.0 ? Edge.P2 - Edge.P0 : Direction;
+	}
+
+	static u32 SolveQuadratic(f64 Roots[2], f64 A, f64 B, f64 C)
+	{
+		if (A == 0.0 || fabs(B) > 1e12 * fabs(A))
+		{
+			if (B == 0.0)
+			{
+				return 0;
+			}
+
+			Roots[0] = -C / B;
+			return 1;
+		}
+
+		f64 Discriminant = B * B - 4.0 * A * C;
+
+		if (Discriminant > 0.0)
+		{
+			Discriminant = sqrt(Discriminant);
+			Roots[0]     = (-B + Discriminant) / (2.0 * A);
+			Roots[1]     = (-B - Discriminant) / (2.0 * A);
+			return 2;
+		}
+
+		if (Discriminant == 0.0)
+		{
+			Roots[0] = -B / (2.0 * A);
+			return 1;
+		}
+
+		return 0;
+	}
+
+	//! Real roots of x^3 + A x^2 + B x + C
+	static u32 SolveNormedCubic(f64 Roots[3], f64 A, f64 B, f64 C)
+	{
+		const f64 A2 = A * A;
+		f64       Q  = (A2 - 3.0 * B) / 9.0;
+		const f64 R  = (A * (2.0 * A2 - 9.0 * B) + 27.0 * C) / 54.0;
+		const f64 R2 = R * R;
+		const f64 Q3 = Q * Q * Q;
+
+		A /= 3.0;
+
+		static constexpr f64 k_TwoPi = 6.283185307179586;
+
+		if (R2 < Q3)
+		{
+			const f64 T = acos(eastl::clamp(R / sqrt(Q3), -1.0, 1.0));
+
+			Q        = -2.0 * sqrt(Q);
+			Roots[0] = Q * cos(T / 3.0) - A;
+			Roots[1] = Q * cos((T + k_TwoPi) / 3.0) - A;
+			Roots[2] = Q * cos((T - k_TwoPi) / 3.0) - A;
+			return 3;
+		}
+
+		const f64 U = (R < 0.0 ? 1.0 : -1.0) * pow(fabs(R) + sqrt(R2 - Q3), 1.0 / 3.0);
+		const f64 V = U == 0.0 ? 0.0 : Q / U;
+
+		Roots[0] = (U + V) - A;
+
+		if (U == V || fabs(U - V) < 1e-12 * fabs(U + V))
+		{
+			Roots[1] = -0.5 * (U + V) - A;
+			return 2;
+		}
+
+		return 1;
+	}
+
+	static u32 SolveCubic(f64 Roots[3], f64 A, f64 B, f64 C, f64 D)
+	{
+		if (A != 0.0 && fabs(B / A) < 1e6)
+		{
+			return SolveNormedCubic(Roots, B / A, C / A, D / A);
+		}
+
+		return SolveQuadratic(Roots, B, C, D);
+	}
+
+	//! Param is where the closest point is on the edge, outside of [0, 1] when it is one of the ends
+	static msdf_distance SignedDistance(const msdf_edge& Edge, msdf_point Origin, f64* Param)
+	{
+		const msdf_point Qa = Edge.P0 - Origin;
+		const msdf_point Ab = Edge.P1 - Edge.P0;
+		const msdf_point Br = Edge.P2 - Edge.P1 - Ab;
+
+		// Closest point of the curve, where the derivative of the squared distance is zero
+		f64       Roots[3];
+		const u32 RootCount = SolveCubic(Roots, Dot(Br, Br), 3.0 * Dot(Ab, Br), 2.0 * Dot(Ab, Ab) + Dot(Qa, Br), Dot(Qa, Ab));
+
+		msdf_point StartDir = StartDirection(Edge);
+		f64        Minimum  = NonZeroSign(Cross(StartDir, Qa)) * Length(Qa);
+
+		*Param = -Dot(Qa, StartDir) / Dot(StartDir, StartDir);
+
+		const msdf_point EndDir    = EndDirection(Edge);
+		const f64        EndLength = Length(Edge.P2 - Origin);
+
+		if (EndLength < fabs(Minimum))
+		{
+			Minimum = NonZeroSign(Cross(EndDir, Edge.P2 - Origin)) * EndLength;
+			*Param  = Dot(Origin - Edge.P1, EndDir) / Dot(EndDir, EndDir);
+		}
+
+		for (u32 Index = 0; Index < RootCount; ++Index)
+		{
+			const f64 T = Roots[Index];
+
+			if (T > 0.0 && T < 1.0)
+			{
+				const msdf_point Qe       = Qa + 2.0 * T * Ab + T * T * Br;
+				const f64        Distance = Length(Qe);
+
+				if (Distance <= fabs(Minimum))
+				{
+					Minimum = NonZeroSign(Cross(Ab + T * Br, Qe)) * Distance;
+					*Param  = T;
+				}
+			}
+		}
+
+		if (*Param >= 0.0 && *Param <= 1.0)
+		{
+			return {Minimum, 0.0};
+		}
+
+		if (*Param < 0.5)
+		{
+			return {Minimum, fabs(Dot(Normalize(StartDir), Normalize(Qa)))};
+		}
+
+		return {Minimum, fabs(Dot(Normalize(EndDir), Normalize(Edge.P2 - Origin)))};
+	}
+
+	//! Past the ends of an edge, the distance to its tangent. Channels stay linear there, which is what keeps corners sharp.
+	static void ToPseudoDistance(const msdf_edge& Edge, msdf_point Origin, f64 Param, msdf_distance* Distance)
+	{
+		if (Param < 0.0)
+		{
+			const msdf_point Direction = Normalize(StartDirection(Edge));
+			const msdf_point Aq        = Origin - Edge.P0;
+
+			if (Dot(Aq, Direction) < 0.0)
+			{
+				const f64 Pseudo = Cross(Aq, Direction);
+
+				if (fabs(Pseudo) <= fabs(Distance->Distance))
+				{
+					*Distance = {Pseudo, 0.0};
+				}
+			}
+		}
+		else if (Param > 1.0)
+		{
+			const msdf_point Direction = Normalize(EndDirection(Edge));
+			const msdf_point Bq        = Origin - Edge.P2;
+
+			if (Dot(Bq, Direction) > 0.0)
+			{
+				const f64 Pseudo = Cross(Bq, Direction);
+
+				if (fabs(Pseudo) <= fabs(Distance->Distance))
+				{
+					*Distance = {Pseudo, 0.0};
+				}
+			}
+		}
+	}
+
+	static void SplitEdge(const msdf_edge& Edge, msdf_edge* First, msdf_edge* Second)
+	{
+		const msdf_point Left   = 0.5 * (Edge.P0 + Edge.P1);
+		const msdf_point Right  = 0.5 * (Edge.P1 + Edge.P2);
+		const msdf_point Middle = 0.5 * (Left + Right);
+
+		*First  = {Edge.P0, Left, Middle, Edge.Color};
+		*Second = {Middle, Right, Edge.P2, Edge.Color};
+	}
+
+	static u32 SwitchColor(u32 Color, u32 Banned)
+	{
+		const u32 Combined = Color & Banned;
+
+		if (Combined == k_MsdfRed || Combined == k_MsdfGreen || Combined == k_MsdfBlue)
+		{
+			return Combined ^ k_MsdfWhite;
+		}
+
+		const u32 Shifted = Color << 1;
+		return (Shifted | Shifted >> 3) & k_MsdfWhite;
+	}
+
+	static i32 SymmetricalTrichotomy(i32 Position, i32 Count) { return (i32)(3.0 + 2.875 * Position / (Count - 1) - 1.4375 + 0.5) - 3; }
+
+	//! Edges between two corners get the same color, and two consecutive runs never share more than one channel
+	static void ColorEdges(eastl::vector<msdf_edge>* Edges, msdf_contour* Contour)
+	{
+		// Angles sharper than about 3 degrees, or turning back
+		static constexpr f64 k_CornerCross = 0.14112;
+
+		eastl::vector<u32> Corners;
+
+		for (u32 Index = Contour->Begin; Index < Contour->End; ++Index)
+		{
+			const msdf_edge& Previous = (*Edges)[Index == Contour->Begin ? Contour->End - 1 : Index - 1];
+
+			const msdf_point In  = Normalize(EndDirection(Previous));
+			const msdf_point Out = Normalize(StartDirection((*Edges)[Index]));
+
+			if (Dot(In, Out) <= 0.0 || fabs(Cross(In, Out)) > k_CornerCross)
+			{
+				Corners.push_back(Index - Contour->Begin);
+			}
+		}
+
+		if (Corners.empty())
+		{
+			for (u32 Index = Contour->Begin; Index < Contour->End; ++Index)
+			{
+				(*Edges)[Index].Color = k_MsdfWhite;
+			}
+
+			return;
+		}
+
+		if (Corners.size() == 1)
+		{
+			// Teardrop, the edges are split in three colors going around from the corner
+			u32 Corner = Corners[0];
+
+			while (Contour->End - Contour->Begin < 3)
+			{
+				eastl::vector<msdf_edge> Split;
+
+				for (u32 Index = Contour->Begin; Index < Contour->End; ++Index)
+				{
+					Split.push_back({});
+					Split.push_back({});
+					SplitEdge((*Edges)[Index], &Split[Split.size() - 2], &Split[Split.size() - 1]);
+				}
+
+				Edges->erase(Edges->begin() + Contour->Begin, Edges->begin() + Contour->End);
+				Edges->insert(Edges->begin() + Contour->Begin, Split.begin(), Split.end());
+
+				Contour->End = Contour->Begin + (u32)Split.size();
+				Corner *= 2;
+			}
+
+			const u32 Colors[3] = {k_MsdfCyan, k_MsdfWhite, k_MsdfMagenta};
+			const i32 Count     = (i32)(Contour->End - Contour->Begin);
+
+			for (i32 Position = 0; Position < Count; ++Position)
+			{
+				(*Edges)[Contour->Begin + (Corner + Position) % Count].Color = Colors[1 + SymmetricalTrichotomy(Position, Count)];
+			}
+
+			return;
+		}
+
+		const u32 Count       = Contour->End - Contour->Begin;
+		const u32 CornerCount = (u32)Corners.size();
+
+		u32 Color  = k_MsdfCyan;
+		u32 Spline = 0;
+
+		for (u32 Position = 0; Position < Count; ++Position)
+		{
+			const u32 Index = (Corners[0] + Position) % Count;
+
+			if (Spline + 1 < CornerCount && Corners[Spline + 1] == Index)
+			{
+				++Spline;
+
+				// The last run also differs from the first one
+				Color = SwitchColor(Color, Spline == CornerCount - 1 ? k_MsdfCyan : 0);
+			}
+
+			(*Edges)[Contour->Begin + Index].Color = Color;
+		}
+	}
+
+	//! Cubics only come from CFF outlines, each quarter is close enough to a quadratic at the sizes glyphs are generated at
+	static void AddCubic(msdf_point P0, msdf_point C0, msdf_point C1, msdf_point P1, eastl::vector<msdf_edge>* Edges)
+	{
+		auto Evaluate = [&](f64 T) {
+			const f64 S = 1.0 - T;
+			return (S * S * S) * P0 + (3.0 * S * S * T) * C0 + (3.0 * S * T * T) * C1 + (T * T * T) * P1;
+		};
+
+		auto Derivative = [&](f64 T) {
+			const f64 S = 1.0 - T;
+			return (3.0 * S * S) * (C0 - P0) + (6.0 * S * T) * (C1 - C0) + (3.0 * T * T) * (P1 - C1);
+		};
+
+		static constexpr u32 k_CubicSplit = 4;
+
+		for (u32 Index = 0; Index < k_CubicSplit; ++Index)
+		{
+			const f64 T0 = (f64)Index / k_CubicSplit, T1 = (f64)(Index + 1) / k_CubicSplit;
+
+			const msdf_point Start = Evaluate(T0), End = Evaluate(T1);
+			const msdf_point Control0 = Start + ((T1 - T0) / 3.0) * Derivative(T0);
+			const msdf_point Control1 = End - ((T1 - T0) / 3.0) * Derivative(T1);
+
+			Edges->push_back({Start, 0.25 * (3.0 * (Control0 + Control1) - (Start + End)), End, k_MsdfWhite});
+		}
+	}
+
+	//! Windings of the outline along a horizontal line, sorted left to right
+	struct msdf_crossing
+	{
+		f64 X;
+		i32 Winding;
+	};
+
+	static void FindCrossings(const eastl::vector<msdf_edge>& Edges, f64 Y, eastl::vector<msdf_crossing>* Crossings)
+	{
+		Crossings->clear();
+
+		for (const msdf_edge& Edge : Edges)
+		{
+			const f64 A = Edge.P0.Y - 2.0 * Edge.P1.Y + Edge.P2.Y;
+			const f64 B = 2.0 * (Edge.P1.Y - Edge.P0.Y);
+
+			f64       Roots[2];
+			const u32 RootCount = SolveQuadratic(Roots, A, B, Edge.P0.Y - Y);
+
+			for (u32 Index = 0; Index < RootCount; ++Index)
+			{
+				// Half open, a vertex is only counted once by the two edges it joins
+				const f64 T     = Roots[Index];
+				const f64 Slope = B + 2.0 * A * T;
+
+				if (T < 0.0 || T >= 1.0 || Slope == 0.0)
+				{
+					continue;
+				}
+
+				const f64 S = 1.0 - T;
+				const f64 X = S * S * Edge.P0.X + 2.0 * S * T * Edge.P1.X + T * T * Edge.P2.X;
+
+				Crossings->push_back({X, Slope > 0.0 ? 1 : -1});
+			}
+		}
+
+		eastl::sort(Crossings->begin(), Crossings->end(), [](const msdf_crossing& A, const msdf_crossing& B) { return A.X < B.X; });
+	}
+
+	static f64 Median(f64 A, f64 B, f64 C) { return eastl::max(eastl::min(A, B), eastl::min(eastl::max(A, B), C)); }
+
+	bool GenerateGlyphMsdf(const stbtt_fontinfo& Info, i32 GlyphIndex, f32 Scale, i32 Padding, rasterized_glyph* Glyph)
+	{
+		stbtt_vertex* Vertices    = nullptr;
+		const i32     VertexCount = stbtt_GetGlyphShape(&Info, GlyphIndex, &Vertices);
+
+		eastl::vector<msdf_edge>    Edges;
+		eastl::vector<msdf_contour> Contours;
+
+		msdf_point Start = {0.0, 0.0}, Pen = {0.0, 0.0};
+
+		auto CloseContour = [&]() {
+			if (!Contours.empty() && (Pen.X != Start.X || Pen.Y != Start.Y))
+			{
+				Edges.push_back({Pen, 0.5 * (Pen + Start), Start, k_MsdfWhite});
+			}
+
+			if (!Contours.empty())
+			{
+				Contours.back().End = (u32)Edges.size();
+
+				if (Contours.back().End == Contours.back().Begin)
+				{
+					Contours.pop_back();
+				}
+			}
+		};
+
+		// Outlines are in font units with y going up, scaled to pixels
+		for (i32 Index = 0; Index < VertexCount; ++Index)
+		{
+			const stbtt_vertex& Vertex = Vertices[Index];
+			const msdf_point    To     = {Vertex.x * (f64)Scale, Vertex.y * (f64)Scale};
+			const msdf_point    C0     = {Vertex.cx * (f64)Scale, Vertex.cy * (f64)Scale};
+			const msdf_point    C1     = {Vertex.cx1 * (f64)Scale, Vertex.cy1 * (f64)Scale};
+
+			switch (Vertex.type)
+			{
+				case STBTT_vmove:
+					CloseContour();
+					Contours.push_back({(u32)Edges.size(), (u32)Edges.size()});
+					Start = To;
+					break;
+				case STBTT_vline:
+					if (To.X != Pen.X || To.Y != Pen.Y)
+					{
+						Edges.push_back({Pen, 0.5 * (Pen + To), To, k_MsdfWhite});
+					}
+					break;
+				case STBTT_vcurve:
+					Edges.push_back({Pen, C0, To, k_MsdfWhite});
+					break;
+				case STBTT_vcubic:
+					AddCubic(Pen, C0, C1, To, &Edges);
+					break;
+			}
+
+			Pen = To;
+		}
+
+		CloseContour();
+
+		stbtt_FreeShape(&Info, Vertices);
+
+		if (Edges.empty())
+		{
+			Glyph->Width  = 0;
+			Glyph->Height = 0;
+			Glyph->Stride = 0;
+			return false;
+		}
+
+		for (u32 Index = 0; Index < (u32)Contours.size(); ++Index)
+		{
+			const u32 Count = Contours[Index].End - Contours[Index].Begin;
+
+			ColorEdges(&Edges, &Contours[Index]);
+
+			// Splitting a teardrop shifts the contours after it
+			const u32 Added = Contours[Index].End - Contours[Index].Begin - Count;
+
+			for (u32 Next = Index + 1; Added > 0 && Next < (u32)Contours.size(); ++Next)
+			{
+				Contours[Next].Begin += Added;
+				Contours[Next].End += Added;
+			}
+		}
+
+		i32 X0, Y0, X1, Y1;
+		stbtt_GetGlyphBitmapBox(&Info, GlyphIndex, Scale, Scale, &X0, &Y0, &X1, &Y1);
+
+		Glyph->Width   = X1 - X0 + 2 * Padding;
+		Glyph->Height  = Y1 - Y0 + 2 * Padding;
+		Glyph->OffsetX = X0 - Padding;
+		Glyph->OffsetY = Y0 - Padding;
+
+		// Rows are padded like single channel fields, @see rasterized_glyph. Padding texels are as far outside as possible.
+		Glyph->Stride = (Glyph->Width + 3) & ~3;
+		Glyph->Texels.resize(Glyph->Stride * Glyph->Height * 3, 0);
+
+		// The distance range spans the padding on both sides like in the baked atlases
+		const f64 Range = 2.0 * Padding;
+
+		eastl::vector<msdf_crossing> Crossings;
+
+		for (i32 Row = 0; Row < Glyph->Height; ++Row)
+		{
+			// Texel centers, the bitmap goes down from its top left corner
+			const f64 Y = -(Glyph->OffsetY + Row + 0.5);
+
+			FindCrossings(Edges, Y, &Crossings);
+
+			u32 NextCrossing = 0;
+			i32 Winding      = 0;
+
+			u8* Texels = Glyph->Texels.data() + Row * Glyph->Stride * 3;
+
+			for (i32 Column = 0; Column < Glyph->Width; ++Column)
+			{
+				const msdf_point Origin = {Glyph->OffsetX + Column + 0.5, Y};
+
+				while (NextCrossing < (u32)Crossings.size() && Crossings[NextCrossing].X < Origin.X)
+				{
+					Winding += Crossings[NextCrossing++].Winding;
+				}
+
+				msdf_distance    Closest;
+				msdf_distance    Channels[3];
+				const msdf_edge* ChannelEdges[3]  = {};
+				f64              ChannelParams[3] = {};
+
+				for (const msdf_edge& Edge : Edges)
+				{
+					f64                 Param;
+					const msdf_distance Distance = SignedDistance(Edge, Origin, &Param);
+
+					Closest = IsCloser(Distance, Closest) ? Distance : Closest;
+
+					for (u32 Channel = 0; Channel < 3; ++Channel)
+					{
+						if ((Edge.Color & (1u << Channel)) != 0 && IsCloser(Distance, Channels[Channel]))
+						{
+							Channels[Channel]      = Distance;
+							ChannelEdges[Channel]  = &Edge;
+							ChannelParams[Channel] = Param;
+						}
+					}
+				}
+
+				f64 Values[3];
+
+				for (u32 Channel = 0; Channel < 3; ++Channel)
+				{
+					if (ChannelEdges[Channel] == nullptr)
+					{
+						Channels[Channel] = Closest;
+					}
+					else
+					{
+						ToPseudoDistance(*ChannelEdges[Channel], Origin, ChannelParams[Channel], &Channels[Channel]);
+					}
+
+					Values[Channel] = Channels[Channel].Distance / Range + 0.5;
+				}
+
+				// Pseudo distances can disagree with the outline, the nonzero winding of TrueType decides what is inside
+				const f64  Middle = Median(Values[0], Values[1], Values[2]);
+				const bool Inside = Winding != 0;
+
+				if (Middle != 0.5 && (Middle > 0.5) != Inside)
+				{
+					for (f64& Value : Values)
+					{
+						Value = 1.0 - Value;
+					}
+				}
+
+				for (u32 Channel = 0; Channel < 3; ++Channel)
+				{
+					Texels[Column * 3 + Channel] = (u8)(eastl::clamp(Values[Channel], 0.0, 1.0) * 255.0 + 0.5);
+				}
+			}
+		}
+
+		return true;
+	}
+}
+}
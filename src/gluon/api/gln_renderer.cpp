@@ -1,12 +1,20 @@
 #include <gluon/api/gln_renderer.h>
 #include <gluon/api/gln_renderer_p.h>
 #include <gluon/api/gln_text.h>
+#include <gluon/api/gln_font_loader_p.h>
+#include <gluon/api/gln_text_layout_p.h>
+#include <gluon/api/gln_glyph_cache_p.h>
+#include <gluon/api/gln_text_shaper_p.h>
 
 #include <gluon/render_backend/gln_renderbackend.h>
 
 #include <gluon/core/gln_math.h>
+#include <gluon/core/gln_timer.h>
+#include <gluon/core/gln_embedded.h>
+#include <gluon/core/gln_hash.h>
+#include <gluon/core/gln_utf8.h>
 
-#include <glad/glad.h>
+#include <gln_embedded_shaders.h>
 
 #include <EASTL/numeric_limits.h>
 #include <EASTL/array.h>
@@ -21,6 +29,9 @@
 #include <filesystem>
 #include <atomic>
 
+#include <stdlib.h>
+#include <string.h>
+
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -33,24 +44,21 @@ struct pos_vertex
 {
 	vec2 Position;
 
-	static vertex_layout s_Layout;
-
-	static void Init() { s_Layout.Begin().Add(DataType_Float, 2).End(); }
+	static constexpr vertex_layout k_Layout = MakeVertexLayout<vec2>();
 };
 
-vertex_layout pos_vertex::s_Layout = vertex_layout();
+static_assert(pos_vertex::k_Layout.GetTotalSize() == sizeof(pos_vertex), "pos_vertex layout does not match its declaration");
 
 struct pos_texcoord_vertex
 {
 	vec2 Position;
 	vec2 Texcoords;
 
-	static vertex_layout s_Layout;
-
-	static void Init() { s_Layout.Begin().Add(DataType_Float, 2).Add(DataType_Float, 2).End(); }
+	static constexpr vertex_layout k_Layout = MakeVertexLayout<vec2, vec2>();
 };
 
-vertex_layout pos_texcoord_vertex::s_Layout = vertex_layout();
+static_assert(pos_texcoord_vertex::k_Layout.GetTotalSize() == sizeof(pos_texcoord_vertex),
+              "pos_texcoord_vertex layout does not match its declaration");
 
 constexpr eastl::array<pos_vertex, 4> k_QuadVertices = {
     pos_vertex{vec2{-1.0f, -1.0f} /*, vec2{1.0f, 0.0f}*/},
@@ -69,23 +77,277 @@ struct rectangle
 	color FillColorRadius;
 	color BorderColorSize;
 };
-#pragma pack(pop)
 
-#pragma pack(push, 1)
-struct glyph_data
-{
-	vec2  Position;  // "World" position
-	vec2  Translate; // Internal translation (position w.r.t to glyph's (0, 0))
-	vec2  Scale;     // Rectangle size
-	f32   GlobalScale;
-	f32   Padding;
-	vec4  Texcoords; // tx = int(x + 1.5), ty = int(y + 1.5) + 1
+//! Immediate text laid out by the layout shader, the glyph ids of the runs follow the runs in the input buffer
+struct gpu_text_run
+{
 	color FillColor;
-	u32   TextureIndex;
-	vec3  Padding2;
+	vec2  Origin;
+	f32   Scale;
+	f32   LineHeight;
+	u32   FirstGlyph; // Index of the first glyph id, and of the first glyph written
+	u32   GlyphCount;
+	u32   Flags;
+	u32   Padding;
+};
+
+//! Atlas table entry of the layout shader
+struct gpu_atlas_glyph
+{
+	f32 PlaneBounds[4]; // Left, bottom, right, top
+	f32 Texcoords[4];
+	f32 Advance;
+	u32 TextureIndex;
+	u32 HasGeometry;
+	u32 Codepoint;
+	u32 KerningBegin; // In words from the start of the table, pairs are (right codepoint, advance)
+	u32 KerningCount;
+	u32 Padding[2];
 };
 #pragma pack(pop)
 
+// Must match text_layout.comp.glsl
+static_assert(sizeof(gpu_text_run) == 12 * sizeof(u32), "gpu_text_run does not match the layout shader");
+static_assert(sizeof(gpu_atlas_glyph) == 16 * sizeof(u32), "gpu_atlas_glyph does not match the layout shader");
+
+static constexpr u32 k_GpuGlyphWords   = sizeof(gpu_atlas_glyph) / sizeof(u32);
+static constexpr u32 k_GpuMissingGlyph = 0xFFFFFFFF;
+static constexpr u32 k_GpuLineFeed     = 0xFFFFFFFE;
+static constexpr u32 k_GpuRunKerning   = 1;
+
+// One workgroup per run, GL only guarantees 65535 groups along X. Runs past it in a frame are laid out on the CPU.
+static constexpr u32 k_MaxGpuTextRuns = 65535;
+
+enum font_status
+{
+	FontStatus_Loading,
+	FontStatus_Uploading,
+	FontStatus_Ready,
+	FontStatus_Failed,
+};
+
+static constexpr u32 k_MaxFontStackSize = 255;
+static constexpr u32 k_UnresolvedGlyph  = 0xFFFFFFFF; // None of the fonts has the codepoint
+static constexpr u32 k_UncachedGlyph    = 0xFFFFFFFE; // Not resolved yet
+
+static constexpr u32 k_ResolvedGlyphBits = 24;
+static constexpr u32 k_ResolvedGlyphMask = (1u << k_ResolvedGlyphBits) - 1;
+
+// Positions stop one short of the 8 bits, a resolved glyph never packs to k_UnresolvedGlyph or k_UncachedGlyph
+static_assert(k_MaxFontStackSize - 1 < (k_UncachedGlyph >> k_ResolvedGlyphBits), "Font stack positions overlap the sentinels");
+
+//! Resolutions of a font stack: position of the font in the stack in the high 8 bits, glyph index in the low 24. Laid out like
+//! glyph_table, Latin-1 is indexed directly and the rest of Unicode goes through pages allocated on first use.
+class resolution_table
+{
+public:
+	static constexpr u32 k_DirectCount = glyph_table::k_DirectCount;
+	static constexpr u32 k_PageBits    = glyph_table::k_PageBits;
+	static constexpr u32 k_PageSize    = glyph_table::k_PageSize;
+
+	resolution_table() { Clear(); }
+
+	void Clear()
+	{
+		eastl::fill(m_Direct, m_Direct + k_DirectCount, k_UncachedGlyph);
+		eastl::fill(m_PageIndices.begin(), m_PageIndices.end(), (u16)0);
+		m_Pages.clear();
+	}
+
+	//! k_UncachedGlyph when the codepoint has not been resolved yet
+	GLN_FORCE_INLINE u32 Find(u32 Codepoint) const
+	{
+		if (Codepoint < k_DirectCount)
+		{
+			return m_Direct[Codepoint];
+		}
+
+		const u32 Page = Codepoint >> k_PageBits;
+
+		if (Page >= m_PageIndices.size() || m_PageIndices[Page] == 0)
+		{
+			return k_UncachedGlyph;
+		}
+
+		return m_Pages[m_PageIndices[Page] - 1][Codepoint & (k_PageSize - 1)];
+	}
+
+	void Set(u32 Codepoint, u32 Resolution)
+	{
+		if (Codepoint < k_DirectCount)
+		{
+			m_Direct[Codepoint] = Resolution;
+			return;
+		}
+
+		// Not a codepoint, never cached
+		if (Codepoint > glyph_table::k_MaxCodepoint)
+		{
+			return;
+		}
+
+		if (m_PageIndices.empty())
+		{
+			m_PageIndices.resize((glyph_table::k_MaxCodepoint >> k_PageBits) + 1, 0);
+		}
+
+		u16& PageIndex = m_PageIndices[Codepoint >> k_PageBits];
+
+		if (PageIndex == 0)
+		{
+			m_Pages.emplace_back();
+			m_Pages.back().fill(k_UncachedGlyph);
+			PageIndex = (u16)m_Pages.size();
+		}
+
+		m_Pages[PageIndex - 1][Codepoint & (k_PageSize - 1)] = Resolution;
+	}
+
+private:
+	u32 m_Direct[k_DirectCount];
+
+	// One entry per page of Unicode, index + 1 in m_Pages or 0 when the page has no resolution
+	eastl::vector<u16>                           m_PageIndices;
+	eastl::vector<eastl::array<u32, k_PageSize>> m_Pages;
+};
+
+//! Fonts tried in order for each codepoint. Resolved codepoints are cached, a font of the stack becoming ready clears the cache.
+struct font_stack
+{
+	eastl::vector<u32> Fonts;
+	resolution_table   Resolved;
+};
+
+struct font_resource
+{
+	eastl::string  Name;
+	font_atlas     Atlas;
+	u32            TextureArray = k_InvalidHandle; // Index in rendering_context::FontArrays, valid once the font is uploading
+	u32            Layer        = 0;
+	font_status    Status       = FontStatus_Loading;
+	u32            UploadedRows = 0;
+	timer          LoadTimer;
+
+	// Fonts loaded with LoadDynamicFont(), the generation changes whenever glyphs become resident or are evicted. Allocated on its
+	// own since the rasterizer threads keep a pointer to it.
+	dynamic_font* Dynamic    = nullptr;
+	u32           Generation = 0;
+
+	// Font stacks have no atlas of their own, only the metrics of their first ready font, @see CreateFontStack()
+	font_stack Stack;
+
+	// Id of the first glyph of the font in the atlas table of the layout shader, added on first use
+	u32 GpuGlyphBase = k_InvalidHandle;
+};
+
+struct text_object
+{
+	eastl::u32string String;
+	font_handle      Font      = GLUON_INVALID_HANDLE;
+	f32              PixelSize = 16.0f;
+
+	// Font the glyphs were laid out with, differs from Font while it is loading
+	u32 LaidOutFont       = k_NoTextObject;
+	u32 LaidOutGeneration = 0;
+	u32 PageMask          = 0;
+
+	// Range of the retained glyph buffer, @see glyph_range_allocator
+	u32 GlyphOffset   = 0;
+	u32 GlyphCount    = 0;
+	u32 GlyphCapacity = 0;
+
+	// Font texture arrays of the glyphs, @see GetArrayBit()
+	u32 ArrayMask = 0;
+
+	// Lines of the last layout, greeked texts are drawn from them, @see SetTextLodThresholds()
+	eastl::vector<text_line> Lines;
+
+	bool Alive          = false;
+	bool LayoutDirty    = false;
+	bool DataDirty      = false;
+	bool DrawnThisFrame = false;
+
+	text_object_data Data;
+};
+
+//! Half open range of elements to upload, empty when Begin >= End
+struct dirty_range
+{
+	u32 Begin = eastl::numeric_limits<u32>::max();
+	u32 End   = 0;
+
+	void Add(u32 First, u32 Count)
+	{
+		Begin = eastl::min(Begin, First);
+		End   = eastl::max(End, First + Count);
+	}
+
+	bool IsEmpty() const { return Begin >= End; }
+	void Reset() { *this = dirty_range(); }
+};
+
+//! Glyphs of a buffer drawn with one font texture array, @see SortGlyphsByArray()
+struct glyph_array_range
+{
+	u32 Begin = 0;
+	u32 Count = 0;
+};
+
+//! Bit of a font texture array in the masks of retained texts, the last bit stands for all the arrays after it
+static u32 GetArrayBit(u32 ArrayIndex) { return 1u << eastl::min(ArrayIndex, 31u); }
+
+//! Font atlases of the same size are layers of a texture array, so that texts of any number of fonts are drawn with a draw per array
+//! and a uniform sampler. Arrays cannot grow, the next array of a size gets twice as many layers as the previous one.
+//! The texture format follows the atlas type, which also selects the shading path of the array.
+struct font_texture_array
+{
+	texture_handle  Texture;
+	u32             Width, Height;
+	font_atlas_type Type;
+	f32             DistanceRange;
+	u32             LayerCount;
+	u32             UsedLayers;
+};
+
+//! Small text rasterized in the coverage atlas, @see SetTextBitmapCache(). Offset goes from the origin of the text to the bottom left
+//! corner of its region, the origin is snapped to a pixel when the region is drawn.
+struct bitmap_text
+{
+	u32  X = 0, Y = 0;
+	u32  Width = 0, Height = 0;
+	vec2 Offset;
+
+	u32  DrawnFrames    = 0; // Consecutive frames the text was drawn in
+	u64  LastDrawnFrame = 0;
+	bool Rasterized     = false;
+	bool Ignored        = false; // Empty texts and texts too large for the atlas
+
+	// What the text was laid out from, keys which collide are told apart with it
+	layout_source Source;
+	f32           MaxWidth = 0.0f;
+};
+
+// Value of u_AtlasType for the coverage atlas, the ones of font atlases are their channel count
+static constexpr u32 k_CoverageAtlasType = 0;
+
+// Array index of the cached quads, it never matches the array of a font
+static constexpr u32 k_BitmapTextArray = 0xFFFF;
+
+// Border the rectangle shader draws around every rectangle, whatever its border width, @see rect.frag.glsl
+static constexpr f32 k_RectangleBorder = 4.0f;
+
+// Texels left around the glyphs, the edges of the outlines are antialiased over about a pixel
+static constexpr f32 k_BitmapTextPadding = 1.0f;
+
+// Texts are also keyed by their pixel size and font generation, most entries of a large cache are texts which changed
+static constexpr u32 k_MaxBitmapTexts = 4096;
+
+// Texture upload budget per frame for fonts being loaded, larger atlases are uploaded over several frames
+static constexpr u64 k_FontUploadBudget = 1024 * 1024;
+
+// Default texture memory of each dynamic font, @see SetGlyphAtlasBudget()
+static constexpr u64 k_DefaultGlyphAtlasBudget = 8 * 1024 * 1024;
+
 struct rendering_context
 {
 	f32 ViewMatrix[16];
@@ -106,13 +368,32 @@ struct rendering_context
 	void*         RectangleInfoSSBOPtr = nullptr;
 
 	// Text rendering
-	const char* CurrentFont;
+	font_handle CurrentFont = GLUON_INVALID_HANDLE;
 
 	f32 TextScaleX, TextScaleY;
 
-	eastl::string_hash_map<u32>   FontLookupMap;
-	eastl::vector<font_atlas>     Fonts;
-	eastl::vector<texture_handle> FontTextures;
+	bool KerningEnabled = true;
+
+	layout_cache                LayoutCache;
+	eastl::vector<text_line>    TextLines;         // Scratch storage for line breaking
+	eastl::vector<u32>          ShapingCodepoints; // Run of complex scripts being shaped, @see ShapeText()
+	eastl::vector<shaped_glyph> ShapedGlyphs;
+
+	eastl::string_hash_map<u32>        FontLookupMap;
+	eastl::vector<font_resource>       Fonts;
+	eastl::vector<priv::loaded_font>   LoadedFonts;
+	eastl::vector<font_ready_callback> FontReadyCallbacks;
+	font_load_stats                    FontLoadStats;
+	eastl::vector<font_texture_array>  FontArrays;
+
+	// Used while the current font is not resident yet, the first font to be ready
+	i32 FallbackFont = -1;
+
+	// Dynamic fonts, pages used by a frame are not evicted before the next one
+	u64                                   FrameIndex       = 1;
+	u64                                   GlyphAtlasBudget = k_DefaultGlyphAtlasBudget;
+	eastl::vector<priv::rasterized_glyph> RasterizedGlyphs;
+	glyph_atlas_stats                     GlyphAtlasStats;
 
 	program_handle TextProgram = GLUON_INVALID_HANDLE;
 
@@ -121,227 +402,2113 @@ struct rendering_context
 
 	buffer_handle TextInfoSSBO;
 	void*         TextInfoSSBOPtr = nullptr;
+
+	// Retained texts, the glyph buffer mirrors RetainedGlyphs and is only updated where texts changed
+	eastl::vector<text_object> TextObjects;
+	eastl::vector<u32>         FreeTextObjects;
+
+	eastl::vector<glyph_data>       RetainedGlyphs;
+	eastl::vector<text_object_data> TextObjectData;
+	glyph_range_allocator           RetainedGlyphRanges;
+
+	buffer_handle RetainedGlyphBuffer = GLUON_INVALID_HANDLE;
+	buffer_handle TextObjectBuffer    = GLUON_INVALID_HANDLE;
+	u32           RetainedGlyphBufferCount;
+	u32           TextObjectBufferCount;
+
+	dirty_range DirtyGlyphs;
+	dirty_range DirtyObjects;
+
+	// Arrays used by the retained texts drawn this frame, the retained buffer is drawn once for each of them
+	u32 RetainedArrayMask = 0;
+
+	// Each font texture array draws its own part of the immediate glyphs
+	eastl::vector<glyph_array_range> GlyphRanges;
+
+	text_stats TextStats;
+
+	// Instances dropped at emit time, counted while the frame is built and published by Flush()
+	culling_stats FrameCulling;
+	culling_stats CullingStats;
+
+	// Level of detail, @see SetTextLodThresholds(). Counted while the frame is built, published to TextStats by RenderTexts().
+	f32 GreekingPixelSize = 0.0f;
+	f32 CullingPixelSize  = 0.0f;
+	u32 GreekedTexts      = 0;
+	u32 CulledTexts       = 0;
+	u32 AvoidedGlyphs     = 0;
+
+	// Immediate texts laid out by the GPU, @see SetGpuTextLayoutThreshold(). The atlas table only grows, fonts are appended to it
+	// the first time they are used. The program is created with the first threshold, texts are laid out on the CPU until it is ready.
+	u32            GpuLayoutThreshold = 0;
+	program_handle TextLayoutProgram  = GLUON_INVALID_HANDLE;
+	bool           TextLayoutReady    = false;
+
+	eastl::vector<u32>          GpuAtlasTable;
+	eastl::vector<gpu_text_run> GpuTextRuns;
+	eastl::vector<u32>          GpuRunArrays; // Font texture array of each run
+	eastl::vector<u32>          GpuGlyphIds;
+	eastl::vector<u32>          SortedGpuGlyphIds;
+
+	eastl::vector<glyph_array_range> GpuGlyphRanges;
+
+	buffer_handle GpuAtlasTableBuffer  = GLUON_INVALID_HANDLE;
+	buffer_handle GpuLayoutInputBuffer = GLUON_INVALID_HANDLE;
+	buffer_handle GpuGlyphBuffer       = GLUON_INVALID_HANDLE;
+	u32           GpuAtlasTableBufferCount;
+	u64           GpuLayoutInputBufferSize;
+	u32           GpuGlyphBufferCount;
+
+	// Small immediate texts drawn over several frames are rasterized once in a coverage atlas and then drawn as a single quad,
+	// @see SetTextBitmapCache(). Regions are not freed, the whole atlas is reset once it is full.
+	u32                BitmapAtlasSize    = 0;
+	f32                BitmapMaxPixelSize = 0.0f;
+	u32                BitmapMinFrames    = 0;
+	texture_handle     BitmapAtlas        = GLUON_INVALID_HANDLE;
+	framebuffer_handle BitmapFramebuffer  = GLUON_INVALID_HANDLE;
+	skyline_packer     BitmapPacker;
+	bool               BitmapAtlasFull    = false;
+	bool               BitmapAtlasDirty   = false; // Cleared before the next rasterization
+
+	eastl::unordered_map<u64, bitmap_text> BitmapTexts;
+	glyph_run                              BitmapGlyphs; // Glyphs of the texts entering the cache this frame, in atlas texels
+	glyph_run                              BitmapQuads;  // One per cached text drawn this frame
+	glyph_run                              BitmapScratch;
+	glyph_run                              SortedBitmapGlyphs;
+	u32                                    RasterizedBitmapTexts = 0;
+
+	eastl::vector<glyph_array_range> BitmapGlyphRanges;
+
+	buffer_handle BitmapGlyphBuffer = GLUON_INVALID_HANDLE;
+	buffer_handle BitmapQuadBuffer  = GLUON_INVALID_HANDLE;
+	u32           BitmapGlyphBufferCount;
+	u32           BitmapQuadBufferCount;
+
+	// Startup
+	timer StartupTimer;
+	bool  FirstFrameRendered = false;
 };
 
 static rendering_context* g_Context = nullptr;
 
-namespace fs = std::filesystem;
+//! Fonts which are not resident yet are replaced by the fallback font, returns false when there is nothing to draw with
+static bool ResolveFont(font_handle Font, u32* FontIndex)
+{
+	if (!Font.IsValid())
+	{
+		return false;
+	}
 
-static fs::file_time_type g_RectVShaderTime;
-static fs::file_time_type g_RectFShaderTime;
-static fs::file_time_type g_TextVShaderTime;
-static fs::file_time_type g_TextFShaderTime;
+	if (g_Context->Fonts[Font.Idx].Status == FontStatus_Ready)
+	{
+		*FontIndex = Font.Idx;
+		return true;
+	}
 
-namespace priv
-{
-	void CreateRenderingContext()
+	if (g_Context->FallbackFont < 0)
 	{
-		if (g_Context != nullptr)
-		{
-			return;
-		}
+		return false;
+	}
 
-		InitializeBackend();
-#ifdef _DEBUG
-		EnableDebugging();
-#endif
+	*FontIndex = (u32)g_Context->FallbackFont;
+	return true;
+}
 
-		g_Context = new rendering_context();
+//! Zeroed glyphs have a null scale, their quads are collapsed
+static void ClearRetainedGlyphs(u32 Offset, u32 Count)
+{
+	memset((void*)(g_Context->RetainedGlyphs.data() + Offset), 0, Count * sizeof(glyph_data));
+}
 
+//! Same interface as utf8_decoder, for null terminated UTF-32 texts
+struct utf32_reader
+{
+	static constexpr u32 k_MinCodepointSize = sizeof(char32_t);
+
+	const char32_t* Char;
+
+	GLN_FORCE_INLINE bool Next(u32* Codepoint)
+	{
+		if (*Char == 0)
 		{
-			g_RectVShaderTime = fs::last_write_time(fs::path("shaders/rect.vert.glsl"));
-			g_RectFShaderTime = fs::last_write_time(fs::path("shaders/rect.frag.glsl"));
+			return false;
+		}
 
-			auto VertexShaderHandle   = CreateShaderFromFile("shaders/rect.vert.glsl", ShaderType_Vertex);
-			auto FragmentShaderHandle = CreateShaderFromFile("shaders/rect.frag.glsl", ShaderType_Fragment);
-			auto ProgramHandle        = CreateProgram(VertexShaderHandle, FragmentShaderHandle, true);
+		*Codepoint = (u32)(*Char++);
+		return true;
+	}
+};
 
-			g_Context->RectProgram = ProgramHandle;
+//! Finds a free layer for an atlas, in an array of the same size and type
+static void AllocateFontLayer(font_resource* Font)
+{
+	const font_atlas& Atlas = Font->Atlas;
 
-			pos_vertex::Init();
-			u32 VertexBufferSize = (u32)k_QuadVertices.size() * sizeof(pos_vertex);
-			u32 IndexBufferSize  = (u32)k_QuadIndices.size() * sizeof(uint16_t);
+	const u32 Width  = (u32)Atlas.Width;
+	const u32 Height = (u32)Atlas.Height;
 
-			g_Context->RectVertexBuffer = CreateImmutableBuffer(k_QuadVertices.size() * sizeof(pos_vertex), k_QuadVertices.data());
-			g_Context->RectIndexBuffer  = CreateImmutableBuffer(k_QuadIndices.size() * sizeof(uint16_t), k_QuadIndices.data());
+	u32 LayerCount = 1;
 
-			g_Context->RectVertexArray = CreateVertexArray(g_Context->RectIndexBuffer);
-			AttachVertexBuffer(g_Context->RectVertexArray, g_Context->RectVertexBuffer, pos_vertex::s_Layout);
+	for (u32 ArrayIndex = 0; ArrayIndex < (u32)g_Context->FontArrays.size(); ++ArrayIndex)
+	{
+		font_texture_array& Array = g_Context->FontArrays[ArrayIndex];
 
-			g_Context->LastRectangleCount   = 128 * 128;
-			g_Context->RectangleInfoSSBO    = CreateImmutableBuffer(128 * 128 * sizeof(rectangle));
-			g_Context->RectangleInfoSSBOPtr = MapBuffer(g_Context->RectangleInfoSSBO);
+		if (Array.Width != Width || Array.Height != Height || Array.Type != Atlas.Type || Array.DistanceRange != Atlas.DistanceRange)
+		{
+			continue;
 		}
 
+		if (Array.UsedLayers < Array.LayerCount)
 		{
-			g_TextVShaderTime = fs::last_write_time(fs::path("shaders/text.vert.glsl"));
-			g_TextFShaderTime = fs::last_write_time(fs::path("shaders/text.frag.glsl"));
+			Font->TextureArray = ArrayIndex;
+			Font->Layer        = Array.UsedLayers++;
+			return;
+		}
 
-			auto VertexShaderHandle   = CreateShaderFromFile("shaders/text.vert.glsl", ShaderType_Vertex);
-			auto FragmentShaderHandle = CreateShaderFromFile("shaders/text.frag.glsl", ShaderType_Fragment);
-			auto ProgramHandle        = CreateProgram(VertexShaderHandle, FragmentShaderHandle, true);
+		LayerCount = eastl::max(LayerCount, Array.LayerCount * 2);
+	}
 
-			g_Context->TextProgram = ProgramHandle;
+	font_texture_array Array;
+	Array.Texture       = CreateTextureArray(Width, Height, LayerCount, (u32)Atlas.Type);
+	Array.Width         = Width;
+	Array.Height        = Height;
+	Array.Type          = Atlas.Type;
+	Array.DistanceRange = Atlas.DistanceRange;
+	Array.LayerCount    = LayerCount;
+	Array.UsedLayers    = 1;
 
-			g_Context->LastGlyphCount = 0;
-			g_Context->TextInfoSSBO   = CreateImmutableBuffer(0);
-		}
+	SetTextureWrapping(Array.Texture, WrapMode_ClampToBorder, WrapMode_ClampToBorder);
+
+	Font->TextureArray = (u32)g_Context->FontArrays.size();
+	Font->Layer        = 0;
+
+	g_Context->FontArrays.push_back(Array);
+}
+
+//! Dynamic fonts read the metrics of a glyph the first time it is laid out, and queue its rasterization if it is not resident
+static const glyph* FindGlyph(u32 FontIndex, u32 Codepoint)
+{
+	font_resource& Font  = g_Context->Fonts[FontIndex];
+	glyph*         Glyph = Font.Atlas.Glyphs.Find(Codepoint);
+
+	if (Font.Dynamic == nullptr)
+	{
+		return Glyph;
 	}
 
-	void DestroyRenderingContext()
+	if (Glyph == nullptr)
 	{
-		if (glIsProgram(g_Context->RectProgram.Idx))
+		if (!priv::AddDynamicGlyph(*Font.Dynamic, Codepoint, &Font.Atlas.Glyphs))
 		{
-			glDeleteProgram(g_Context->RectProgram.Idx);
+			return nullptr;
 		}
-		delete g_Context;
-		g_Context = nullptr;
+
+		Glyph = Font.Atlas.Glyphs.Find(Codepoint);
 	}
 
-	void Resize(f32 Width, f32 Height)
+	if (Glyph->HasGeometry && Glyph->AtlasPage == k_GlyphNotResident)
 	{
-		g_Context->ViewportWidth  = Width;
-		g_Context->ViewportHeight = Height;
+		Glyph->AtlasPage = k_GlyphPending;
+		g_Context->GlyphAtlasStats.PendingGlyphs += 1;
 
-		const auto ViewMatrix = glm::mat4(1.0f);
-		const auto ProjMatrix = glm::orthoLH_ZO(0.0f, (f32)Width, (f32)Height, 0.0f, 0.0f, 100.0f);
+		priv::RequestGlyphRaster(FontIndex, Font.Dynamic, Codepoint);
+	}
 
-		memcpy(g_Context->ViewMatrix, glm::value_ptr(ViewMatrix), 16 * sizeof(f32));
-		memcpy(g_Context->ProjMatrix, glm::value_ptr(ProjMatrix), 16 * sizeof(f32));
+	return Glyph;
+}
+
+//! Glyph of a font or of the first font of a stack having it, GlyphFont is the font it was found in
+static const glyph* ResolveGlyph(u32 FontIndex, u32 Codepoint, u32* GlyphFont)
+{
+	font_stack& Stack = g_Context->Fonts[FontIndex].Stack;
+
+	if (Stack.Fonts.empty())
+	{
+		*GlyphFont = FontIndex;
+		return FindGlyph(FontIndex, Codepoint);
 	}
 
-	void SetTextScale(f32 ScaleX, f32 ScaleY)
+	const u32 Resolution = Stack.Resolved.Find(Codepoint);
+
+	if (Resolution == k_UnresolvedGlyph)
 	{
-		g_Context->TextScaleX = ScaleX;
-		g_Context->TextScaleY = ScaleY;
+		return nullptr;
 	}
 
-	void RenderRectangles()
+	if (Resolution != k_UncachedGlyph)
 	{
-		const i32 RectangleCount = (i32)g_Context->Rectangles.size();
+		*GlyphFont = Stack.Fonts[Resolution >> k_ResolvedGlyphBits];
 
-		if (RectangleCount == 0)
+		const font_resource& Font  = g_Context->Fonts[*GlyphFont];
+		const glyph&         Glyph = Font.Atlas.Glyphs.GetGlyph(Resolution & k_ResolvedGlyphMask);
+
+		// Dynamic glyphs may have been evicted since, only those marked out of the atlas go through FindGlyph() to be queued again
+		if (Font.Dynamic == nullptr || !Glyph.HasGeometry || Glyph.AtlasPage != k_GlyphNotResident)
 		{
-			return;
+			return &Glyph;
+		}
+
+		return FindGlyph(*GlyphFont, Codepoint);
+	}
+
+	for (u32 Position = 0; Position < (u32)Stack.Fonts.size(); ++Position)
+	{
+		const u32 MemberIndex = Stack.Fonts[Position];
+
+		if (g_Context->Fonts[MemberIndex].Status != FontStatus_Ready)
+		{
+			continue;
 		}
 
-		auto VertexTime   = fs::last_write_time(fs::path("shaders/rect.vert.glsl"));
-		auto FragmentTime = fs::last_write_time(fs::path("shaders/rect.frag.glsl"));
+		const glyph* Glyph = FindGlyph(MemberIndex, Codepoint);
 
-		if (VertexTime > g_RectVShaderTime || FragmentTime > g_RectFShaderTime)
+		if (Glyph != nullptr)
 		{
-			g_RectVShaderTime = VertexTime;
-			g_RectFShaderTime = FragmentTime;
+			const u32 GlyphIndex = g_Context->Fonts[MemberIndex].Atlas.Glyphs.GetGlyphIndex(Glyph);
 
-			auto VertexShaderHandle   = CreateShaderFromFile("shaders/rect.vert.glsl", ShaderType_Vertex);
-			auto FragmentShaderHandle = CreateShaderFromFile("shaders/rect.frag.glsl", ShaderType_Fragment);
-			auto ProgramHandle        = CreateProgram(VertexShaderHandle, FragmentShaderHandle, true);
+			GLN_ASSERT(Position < k_MaxFontStackSize);
+			GLN_ASSERT(GlyphIndex <= k_ResolvedGlyphMask);
 
-			g_Context->RectProgram = ProgramHandle;
-		}
+			// Glyphs past the 24 bits are resolved again each time rather than cached wrongly
+			if (GlyphIndex <= k_ResolvedGlyphMask)
+			{
+				Stack.Resolved.Set(Codepoint, (Position << k_ResolvedGlyphBits) | GlyphIndex);
+			}
 
-		glUseProgram(g_Context->RectProgram.Idx);
+			*GlyphFont = MemberIndex;
+			return Glyph;
+		}
+	}
 
-		const i32 ViewLoc         = glGetUniformLocation(g_Context->RectProgram.Idx, "u_View");
-		const i32 ProjLoc         = glGetUniformLocation(g_Context->RectProgram.Idx, "u_Proj");
-		const i32 ViewportSizeLoc = glGetUniformLocation(g_Context->RectProgram.Idx, "u_ViewportSize");
+	Stack.Resolved.Set(Codepoint, k_UnresolvedGlyph);
+	return nullptr;
+}
 
-		glUniformMatrix4fv(ViewLoc, 1, GL_FALSE, g_Context->ViewMatrix);
-		glUniformMatrix4fv(ProjLoc, 1, GL_FALSE, g_Context->ProjMatrix);
-		glUniform2f(ViewportSizeLoc, g_Context->ViewportWidth, g_Context->ViewportHeight);
+//! Font stacks take the metrics of their first ready font, and resolve codepoints again since a preceding font may now have them
+static void UpdateFontStack(font_resource* Font)
+{
+	for (u32 MemberIndex : Font->Stack.Fonts)
+	{
+		const font_resource& Member = g_Context->Fonts[MemberIndex];
 
-		if (g_Context->LastRectangleCount < RectangleCount)
+		if (Member.Status == FontStatus_Ready)
 		{
-			UnmapBuffer(g_Context->RectangleInfoSSBO);
-			ResizeImmutableBuffer(&g_Context->RectangleInfoSSBO, RectangleCount * sizeof(rectangle));
+			Font->Atlas.Metrics = Member.Atlas.Metrics;
+			Font->Status        = FontStatus_Ready;
+			break;
+		}
+	}
 
-			g_Context->LastRectangleCount   = RectangleCount;
-			g_Context->RectangleInfoSSBOPtr = MapBuffer(g_Context->RectangleInfoSSBO);
+	Font->Stack.Resolved.Clear();
+	Font->Generation += 1;
+}
+
+static void UpdateFontStacks(u32 ReadyFont)
+{
+	for (font_resource& Font : g_Context->Fonts)
+	{
+		const auto& Members = Font.Stack.Fonts;
+
+		if (eastl::find(Members.begin(), Members.end(), ReadyFont) != Members.end())
+		{
+			UpdateFontStack(&Font);
 		}
+	}
+}
 
-		memcpy(g_Context->RectangleInfoSSBOPtr, g_Context->Rectangles.data(), RectangleCount * sizeof(rectangle));
+//! Changes whenever the layouts made with the font are not valid anymore, font stacks change with any of their fonts
+static u32 GetLayoutGeneration(u32 FontIndex)
+{
+	const font_resource& Font       = g_Context->Fonts[FontIndex];
+	u32                  Generation = Font.Generation;
 
-		glBindVertexArray(g_Context->RectVertexArray.Idx);
+	for (u32 MemberIndex : Font.Stack.Fonts)
+	{
+		Generation += g_Context->Fonts[MemberIndex].Generation;
+	}
 
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, g_Context->RectangleInfoSSBO.Idx);
-		glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr, RectangleCount);
+	return Generation;
+}
 
-		g_Context->Rectangles.clear();
+//! Pages used during a frame are not evicted at the end of it
+static void TouchGlyphPages(u32 FontIndex, u32 PageMask)
+{
+	const font_resource& Font = g_Context->Fonts[FontIndex];
+
+	// The pages of a stack are not told apart, they are kept in all of its dynamic fonts
+	for (u32 MemberIndex : Font.Stack.Fonts)
+	{
+		TouchGlyphPages(MemberIndex, PageMask);
 	}
 
-	void RenderTexts()
+	dynamic_font* Dynamic = Font.Dynamic;
+
+	if (Dynamic == nullptr)
 	{
-		const i32 GlyphCount = (i32)g_Context->GlyphData.size();
+		return;
+	}
 
-		auto VertexTime   = fs::last_write_time(fs::path("shaders/text.vert.glsl"));
-		auto FragmentTime = fs::last_write_time(fs::path("shaders/text.frag.glsl"));
+	while (PageMask != 0)
+	{
+		const u32 Page = CountTrailingZeros(PageMask);
 
-		if (VertexTime > g_TextVShaderTime || FragmentTime > g_TextFShaderTime)
-		{
-			g_TextVShaderTime = VertexTime;
-			g_TextFShaderTime = FragmentTime;
+		Dynamic->Pages[Page].LastUsedFrame = g_Context->FrameIndex;
+		PageMask &= PageMask - 1;
+	}
+}
 
-			auto VertexShaderHandle   = CreateShaderFromFile("shaders/text.vert.glsl", ShaderType_Vertex);
-			auto FragmentShaderHandle = CreateShaderFromFile("shaders/text.frag.glsl", ShaderType_Fragment);
-			auto ProgramHandle        = CreateProgram(VertexShaderHandle, FragmentShaderHandle, true);
+//! Lays a text out on a single baseline and records where lines can be broken, @see BreakLines(). Reader is either an
+//! utf32_reader or an utf8_decoder.
+template <typename reader_t>
+static void ShapeText(reader_t Reader, u32 FontIndex, f32 PixelSize, shaped_text* Text)
+{
+	f32 CursorX = 0.0f;
 
-			g_Context->TextProgram = ProgramHandle;
-		}
+	// Glyphs are scaled by the line height of the font they come from, which is the one of the font stack for single fonts
+	Text->LineHeight = PixelSize;
 
-		glUseProgram(g_Context->TextProgram.Idx);
+	// Codepoints are laid out as they are decoded. Only runs of complex scripts are buffered, the shaper needs them whole.
+	eastl::vector<u32>& Run = g_Context->ShapingCodepoints;
+	Run.clear();
 
-		const i32 ViewLoc         = glGetUniformLocation(g_Context->TextProgram.Idx, "u_View");
-		const i32 ProjLoc         = glGetUniformLocation(g_Context->TextProgram.Idx, "u_Proj");
-		const i32 ViewportSizeLoc = glGetUniformLocation(g_Context->TextProgram.Idx, "u_ViewportSize");
+	u32 RunBegin = 0;
 
-		glUniformMatrix4fv(ViewLoc, 1, GL_FALSE, g_Context->ViewMatrix);
-		glUniformMatrix4fv(ProjLoc, 1, GL_FALSE, g_Context->ProjMatrix);
-		glUniform2f(ViewportSizeLoc, g_Context->ViewportWidth, g_Context->ViewportHeight);
+	const eastl::vector<shaped_glyph>& ShapedGlyphs = g_Context->ShapedGlyphs;
 
-		if (g_Context->LastGlyphCount < GlyphCount)
-		{
-			UnmapBuffer(g_Context->TextInfoSSBO);
-			ResizeImmutableBuffer(&g_Context->TextInfoSSBO, GlyphCount * sizeof(glyph_data));
+	const glyph_query HasGlyph = [FontIndex](u32 Codepoint) {
+		u32 GlyphFont;
+		return ResolveGlyph(FontIndex, Codepoint, &GlyphFont) != nullptr;
+	};
 
-			g_Context->LastGlyphCount  = GlyphCount;
-			g_Context->TextInfoSSBOPtr = MapBuffer(g_Context->TextInfoSSBO);
+	// Left side of the next kerning pair, reset on line breaks and unknown glyphs
+	const glyph* PreviousGlyph     = nullptr;
+	u32          PreviousFont      = k_InvalidHandle;
+	u32          PreviousCodepoint = 0;
+
+	// Marks are placed relatively to the last base glyph
+	f32 BaseX       = 0.0f;
+	f32 BaseAdvance = 0.0f;
+
+	auto AddGlyph = [&](u32 Index, u32 GlyphCodepoint, bool IsMark) {
+		u32          GlyphFontIndex;
+		const glyph* Glyph = ResolveGlyph(FontIndex, GlyphCodepoint, &GlyphFontIndex);
+
+		if (Glyph == nullptr)
+		{
+			PreviousGlyph = IsMark ? PreviousGlyph : nullptr;
+			return;
 		}
 
-		memcpy(g_Context->TextInfoSSBOPtr, g_Context->GlyphData.data(), GlyphCount * sizeof(glyph_data));
+		// Only resident fonts are laid out, their layer does not change anymore
+		const font_resource& GlyphFont    = g_Context->Fonts[GlyphFontIndex];
+		const font_atlas&    Atlas        = GlyphFont.Atlas;
+		const u32            TextureIndex = (GlyphFont.TextureArray << 16) | GlyphFont.Layer;
+		const f32            Scale        = PixelSize / Atlas.Metrics.LineHeight;
 
-		glBindVertexArray(g_Context->RectVertexArray.Idx);
+		// Pairs never span two fonts. FindGlyph() may have grown the glyph table of a dynamic font, PreviousGlyph is only tested
+		// against null for them and their pairs are looked up by codepoint.
+		const bool HasPrevious = !IsMark && g_Context->KerningEnabled && GlyphFontIndex == PreviousFont && PreviousGlyph != nullptr;
 
-		u32 CurrentIndex = 0;
-		for (const auto& Font : g_Context->FontTextures)
+		if (HasPrevious && GlyphFont.Dynamic != nullptr)
+		{
+			CursorX += priv::GetDynamicKerning(GlyphFont.Dynamic, PreviousCodepoint, GlyphCodepoint) * Scale;
+			Text->Offsets.back() = CursorX;
+		}
+		else if (HasPrevious && Atlas.Kernings.GetPairCount() > 0 && PreviousGlyph->KerningCount > 0)
 		{
-			glBindTextureUnit(CurrentIndex++, Font.Idx);
+			CursorX += Atlas.Kernings.GetAdvance(*PreviousGlyph, GlyphCodepoint) * Scale;
+			Text->Offsets.back() = CursorX;
 		}
 
-		i32 TextureBindings[] = {0, 1, 2, 3, 4, 5, 6, 7};
+		// Marks of fonts made for them have no advance and are drawn back over the base, spacing ones are centered on it
+		f32 PenX = CursorX;
 
-		const i32 TexturesLoc = glGetUniformLocation(g_Context->TextProgram.Idx, "u_Textures");
-		glUniform1iv(TexturesLoc, 8, TextureBindings);
+		if (IsMark && Glyph->Advance > 0.0f)
+		{
+			PenX = BaseX + (BaseAdvance - Glyph->Advance * Scale) * 0.5f;
+		}
 
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, g_Context->TextInfoSSBO.Idx);
-		glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr, GlyphCount);
+		// Glyphs being rasterized take their space but are not drawn, the text is laid out again once they are resident
+		if (Glyph->HasGeometry && Glyph->AtlasPage < k_GlyphFailed)
+		{
+			const f32 Left = Glyph->PlaneBounds.Left, Right = Glyph->PlaneBounds.Right;
+			const f32 Bottom = Glyph->PlaneBounds.Bottom, Top = Glyph->PlaneBounds.Top;
 
-		g_Context->GlyphData.clear();
-	}
+			const f32 GlyphWidth  = Right - Left;
+			const f32 GlyphHeight = Top - Bottom;
 
-	void Flush()
-	{
-		glClearColor(0.2f, 0.4f, 0.5f, 1.0f);
-		glViewport(0, 0, (GLsizei)g_Context->ViewportWidth, (GLsizei)g_Context->ViewportHeight);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			const auto& Texcoords = Glyph->Texcoords;
 
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			glyph_data WrittenGlyph;
+			WrittenGlyph.Position     = vec2(PenX, 0.0f);
+			WrittenGlyph.Scale        = vec2(GlyphWidth * 0.5f, GlyphHeight * 0.5f);
+			WrittenGlyph.Translate    = vec2(Left, Bottom + WrittenGlyph.Scale.y);
+			WrittenGlyph.Texcoords    = vec4(Texcoords.Left, Texcoords.Bottom, Texcoords.Right, Texcoords.Top);
+			WrittenGlyph.GlobalScale  = Scale;
+			WrittenGlyph.TextureIndex = TextureIndex;
+			WrittenGlyph.ObjectIndex  = k_NoTextObject;
 
-		RenderRectangles();
-		RenderTexts();
+			Text->Glyphs.push_back(WrittenGlyph);
+			Text->GlyphCodepoints.push_back(Index);
 
-		glDisable(GL_BLEND);
+			Text->PageMask |= 1u << Glyph->AtlasPage;
+		}
+
+		if (!IsMark)
+		{
+			BaseX       = CursorX;
+			BaseAdvance = Glyph->Advance * Scale;
+
+			CursorX += BaseAdvance;
+			PreviousGlyph     = Glyph;
+			PreviousFont      = GlyphFontIndex;
+			PreviousCodepoint = GlyphCodepoint;
+		}
+	};
+
+	// CRLF counts as a single line break
+	bool AfterCarriageReturn = false;
+
+	static constexpr u32 k_NoSpace = 0xFFFFFFFF;
+
+	// Start of the current run of spaces, which becomes a break opportunity once the next word starts
+	u32 SpaceBegin = k_NoSpace;
+
+	// Records the offset of the codepoint and where lines can break, returns false for line breaks which have no glyph
+	auto BeginCodepoint = [&](u32 Index, u32 Codepoint) {
+		Text->Offsets.push_back(CursorX);
+
+		if (Codepoint == U'\n' && AfterCarriageReturn)
+		{
+			AfterCarriageReturn = false;
+			Text->Breaks.back().Next = Index + 1;
+			return false;
+		}
+
+		AfterCarriageReturn = Codepoint == U'\r';
+
+		if (Codepoint == U'\n' || Codepoint == U'\r')
+		{
+			PreviousGlyph = nullptr;
+
+			// Trailing spaces are not part of the line either
+			const u32 End = SpaceBegin != k_NoSpace ? SpaceBegin : Index;
+
+			Text->MandatoryBreaks.push_back((u32)Text->Breaks.size());
+			Text->Breaks.push_back({End, Index + 1, true});
+
+			SpaceBegin = k_NoSpace;
+			return false;
+		}
+
+		const bool IsSpace = Codepoint == U' ' || Codepoint == U'\t' || Codepoint == 0x3000;
+
+		if (IsSpace && SpaceBegin == k_NoSpace)
+		{
+			SpaceBegin = Index;
+		}
+		else if (!IsSpace && SpaceBegin != k_NoSpace)
+		{
+			Text->Breaks.push_back({SpaceBegin, Index, false});
+			SpaceBegin = k_NoSpace;
+		}
+
+		return true;
+	};
+
+	// Shaping is cluster local and clusters never span a codepoint the shaper leaves alone, so runs are shaped on their own. Marks
+	// following a base outside of the run are placed from the base glyph already laid out.
+	auto FlushRun = [&]() {
+		if (Run.empty())
+		{
+			return;
+		}
+
+		const bool IsShaped = priv::ShapeRun(Run.data(), (u32)Run.size(), HasGlyph, &g_Context->ShapedGlyphs);
+
+		u32 NextShapedGlyph = 0;
+
+		for (u32 RunIndex = 0; RunIndex < (u32)Run.size(); ++RunIndex)
+		{
+			const u32 Index = RunBegin + RunIndex;
+
+			// Complex scripts have no line breaks
+			BeginCodepoint(Index, Run[RunIndex]);
+
+			if (!IsShaped)
+			{
+				AddGlyph(Index, Run[RunIndex], false);
+				continue;
+			}
+
+			for (; NextShapedGlyph < (u32)ShapedGlyphs.size() && ShapedGlyphs[NextShapedGlyph].Cluster <= RunIndex; ++NextShapedGlyph)
+			{
+				AddGlyph(Index, ShapedGlyphs[NextShapedGlyph].Codepoint, ShapedGlyphs[NextShapedGlyph].IsMark);
+			}
+		}
+
+		Run.clear();
+	};
+
+	u32 Index = 0;
+
+	for (u32 Codepoint; Reader.Next(&Codepoint); ++Index)
+	{
+		if (priv::NeedsShaping(Codepoint))
+		{
+			RunBegin = Run.empty() ? Index : RunBegin;
+			Run.push_back(Codepoint);
+			continue;
+		}
+
+		FlushRun();
+
+		if (BeginCodepoint(Index, Codepoint))
+		{
+			AddGlyph(Index, Codepoint, false);
+		}
+	}
+
+	FlushRun();
+
+	Text->Offsets.push_back(CursorX);
+}
+
+//! Shapes the text, or reuses a previous layout. Text and Size are the raw bytes of the string, only used as cache key, which is
+//! returned in LayoutKey when it is not null.
+template <typename reader_t>
+static const shaped_text* GetShapedText(reader_t    Reader,
+                                        const void* Text,
+                                        u64         Size,
+                                        u32         FontIndex,
+                                        f32         PixelSize,
+                                        layout_key* LayoutKey = nullptr)
+{
+	// Everything the layout depends on, the fallback font included. The script follows from the text, so shaped runs of complex
+	// scripts are cached like any other layout.
+	layout_key Key;
+	Key.Params.CodeUnitSize = reader_t::k_MinCodepointSize;
+	Key.Params.FontIndex    = FontIndex;
+	Key.Params.PixelSize    = PixelSize;
+	Key.Params.Generation   = GetLayoutGeneration(FontIndex);
+	Key.Params.Kerning      = g_Context->KerningEnabled;
+	Key.Text                = Text;
+	Key.Size                = Size;
+
+	Key.Hash = Hash(Text, Size);
+	Key.Hash = HashCombine(Key.Hash, Key.Params.CodeUnitSize);
+	Key.Hash = HashCombine(Key.Hash, FontIndex);
+	Key.Hash = Hash(&PixelSize, sizeof(PixelSize), Key.Hash);
+	Key.Hash = HashCombine(Key.Hash, Key.Params.Kerning ? 1 : 0);
+	Key.Hash = HashCombine(Key.Hash, Key.Params.Generation);
+
+	if (LayoutKey != nullptr)
+	{
+		*LayoutKey = Key;
+	}
+
+	const shaped_text* Shaped = g_Context->LayoutCache.Find(Key);
+
+	if (Shaped == nullptr)
+	{
+		shaped_text NewText;
+		ShapeText(Reader, FontIndex, PixelSize, &NewText);
+
+		Shaped = g_Context->LayoutCache.Insert(Key, eastl::move(NewText));
+	}
+
+	return Shaped;
+}
+
+enum text_lod
+{
+	TextLod_Glyphs,
+	TextLod_Bars,
+	TextLod_Culled,
+};
+
+// Height of greeking bars relative to the pixel size. Rectangles are opaque, so the bar is thinner than the glyphs to keep about the
+// same ink.
+static constexpr f32 k_GreekingBarHeight = 0.35f;
+
+static text_lod GetTextLod(f32 PixelSize)
+{
+	if (PixelSize < g_Context->CullingPixelSize)
+	{
+		return TextLod_Culled;
+	}
+
+	return PixelSize < g_Context->GreekingPixelSize ? TextLod_Bars : TextLod_Glyphs;
+}
+
+//! Draws a bar over the x-height of each line of a greeked text. Origin is the baseline of the first line.
+static void DrawGreekedLines(const eastl::vector<text_line>& Lines, f32 LineHeight, vec2 Origin, color FillColor)
+{
+	const f32 BarHeight = Max(LineHeight * k_GreekingBarHeight, 1.0f);
+
+	for (u32 LineIndex = 0; LineIndex < (u32)Lines.size(); ++LineIndex)
+	{
+		if (Lines[LineIndex].Width <= 0.0f)
+		{
+			continue;
+		}
+
+		// Texts are positioned from the bottom of the viewport, rectangles from its top
+		const f32 Baseline = Origin.y - LineIndex * LineHeight;
+
+		DrawRectangle(Origin.x, g_Context->ViewportHeight - Baseline - BarHeight, Lines[LineIndex].Width, BarHeight, FillColor);
+	}
+}
+
+//! Texts below the legibility threshold are replaced by bars or skipped, instead of drawing one instance per glyph
+static void DrawLaidOutText(const shaped_text& Text, const eastl::vector<text_line>& Lines, vec2 Origin, color FillColor)
+{
+	const text_lod Lod = GetTextLod(Text.LineHeight);
+
+	if (Lod == TextLod_Glyphs)
+	{
+		PlaceGlyphs(Text, Lines, Origin, FillColor, &g_Context->GlyphData);
+		return;
+	}
+
+	g_Context->AvoidedGlyphs += (u32)Text.Glyphs.size();
+
+	if (Lod == TextLod_Culled)
+	{
+		g_Context->CulledTexts += 1;
+		return;
+	}
+
+	g_Context->GreekedTexts += 1;
+	DrawGreekedLines(Lines, Text.LineHeight, Origin, FillColor);
+}
+
+//! Tells whether a box overlaps the viewport. The box is (Left, Top, Right, Bottom) in pixels from the top left corner, like
+//! rectangles. Boxes only touching it are culled, the four sides are compared at once.
+static bool OverlapsViewport(const vec4& Box)
+{
+	const vec4 Sides  = vec4(Box.x, Box.y, -Box.z, -Box.w);
+	const vec4 Limits = vec4(g_Context->ViewportWidth, g_Context->ViewportHeight, 0.0f, 0.0f);
+
+	return glm::all(glm::lessThan(Sides, Limits));
+}
+
+//! Box of a text whose first baseline starts at Origin, which counts from the bottom of the viewport. Glyphs overhang their advance
+//! and their line by less than a line height.
+static vec4 GetTextBounds(vec2 Origin, f32 LineHeight, f32 Width, f32 LineCount)
+{
+	const f32 Top = g_Context->ViewportHeight - Origin.y - LineHeight;
+
+	return vec4(Origin.x - LineHeight, Top, Origin.x + Width + LineHeight, Top + (LineCount + 1.0f) * LineHeight);
+}
+
+//! Texts starting right of the viewport or under it cannot enter it, they are culled before being laid out
+static bool MayBeVisible(vec2 Origin, f32 PixelSize)
+{
+	const f32 Unbounded = eastl::numeric_limits<f32>::infinity();
+
+	return OverlapsViewport(GetTextBounds(Origin, PixelSize, Unbounded, Unbounded));
+}
+
+static bool IsTextVisible(const eastl::vector<text_line>& Lines, f32 LineHeight, vec2 Origin)
+{
+	f32 Width = 0.0f;
+
+	for (const text_line& Line : Lines)
+	{
+		Width = Max(Width, Line.Width);
+	}
+
+	return OverlapsViewport(GetTextBounds(Origin, LineHeight, Width, (f32)Lines.size()));
+}
+
+static void CountCulledText(u32 GlyphCount)
+{
+	culling_stats& Culling = g_Context->FrameCulling;
+	Culling.CulledTexts += 1;
+	Culling.CulledGlyphs += GlyphCount;
+	Culling.SavedBytes += GlyphCount * sizeof(glyph_data);
+}
+
+//! Allocates a region of the coverage atlas for the text and queues its glyphs to be drawn there by RenderTexts()
+static bool RasterizeBitmapText(const shaped_text& Text, const eastl::vector<text_line>& Lines, bitmap_text* Entry)
+{
+	glyph_run& Glyphs = g_Context->BitmapScratch;
+	Glyphs.clear();
+
+	PlaceGlyphs(Text, Lines, vec2(0.0f), MakeColorFromRGB8(255, 255, 255), &Glyphs);
+
+	vec2 Min = vec2(eastl::numeric_limits<f32>::max());
+	vec2 Max = vec2(eastl::numeric_limits<f32>::lowest());
+
+	// Same corners as the vertex shader
+	for (const glyph_data& Glyph : Glyphs)
+	{
+		Min = glm::min(Min, (vec2(0.0f, -Glyph.Scale.y) + Glyph.Translate) * Glyph.GlobalScale + Glyph.Position);
+		Max = glm::max(Max, (vec2(2.0f * Glyph.Scale.x, Glyph.Scale.y) + Glyph.Translate) * Glyph.GlobalScale + Glyph.Position);
+	}
+
+	const vec2 BottomLeft = glm::floor(Min) - k_BitmapTextPadding;
+	const vec2 TopRight   = glm::ceil(Max) + k_BitmapTextPadding;
+	const u32  Width      = Glyphs.empty() ? 0 : (u32)(TopRight.x - BottomLeft.x);
+	const u32  Height     = Glyphs.empty() ? 0 : (u32)(TopRight.y - BottomLeft.y);
+
+	// A single text should not fill the atlas, it would be reset every frame
+	const u32 MaxSize = g_Context->BitmapAtlasSize / 4;
+
+	if (Width == 0 || Width > MaxSize || Height > MaxSize)
+	{
+		Entry->Ignored = true;
+		return false;
+	}
+
+	if (!g_Context->BitmapPacker.Pack(Width, Height, &Entry->X, &Entry->Y))
+	{
+		g_Context->BitmapAtlasFull = true;
+		return false;
+	}
+
+	Entry->Width      = Width;
+	Entry->Height     = Height;
+	Entry->Offset     = BottomLeft;
+	Entry->Rasterized = true;
+
+	const vec2 Translation = vec2((f32)Entry->X, (f32)Entry->Y) - BottomLeft;
+
+	for (glyph_data& Glyph : Glyphs)
+	{
+		Glyph.Position += Translation;
+		g_Context->BitmapGlyphs.push_back(Glyph);
+	}
+
+	g_Context->RasterizedBitmapTexts += 1;
+
+	return true;
+}
+
+//! Draws the text as a quad of the coverage atlas once it has been drawn BitmapMinFrames frames in a row, rasterizing it on the first
+//! one. The layout key and the wrapping width identify the layout and the line breaks. Returns false when the text has to be drawn
+//! from its glyphs.
+static bool DrawBitmapText(const shaped_text&              Text,
+                           const layout_key&               LayoutKey,
+                           f32                             MaxWidth,
+                           const eastl::vector<text_line>& Lines,
+                           vec2                            Origin,
+                           color                           FillColor)
+{
+	if (!g_Context->BitmapFramebuffer.IsValid() || Text.LineHeight > g_Context->BitmapMaxPixelSize ||
+	    GetTextLod(Text.LineHeight) != TextLod_Glyphs)
+	{
+		return false;
+	}
+
+	bitmap_text& Entry = g_Context->BitmapTexts[Hash(&MaxWidth, sizeof(MaxWidth), LayoutKey.Hash)];
+
+	// A new entry, or another text whose key collides. The region of the previous one stays allocated until the atlas is reset.
+	if (Entry.MaxWidth != MaxWidth || !Entry.Source.Matches(LayoutKey))
+	{
+		Entry = bitmap_text();
+		Entry.Source.Assign(LayoutKey);
+		Entry.MaxWidth = MaxWidth;
+	}
+
+	if (Entry.LastDrawnFrame != g_Context->FrameIndex)
+	{
+		Entry.DrawnFrames    = Entry.LastDrawnFrame + 1 == g_Context->FrameIndex ? Entry.DrawnFrames + 1 : 1;
+		Entry.LastDrawnFrame = g_Context->FrameIndex;
+	}
+
+	if (!Entry.Rasterized)
+	{
+		if (Entry.Ignored || Entry.DrawnFrames < g_Context->BitmapMinFrames || g_Context->BitmapAtlasFull ||
+		    !RasterizeBitmapText(Text, Lines, &Entry))
+		{
+			return false;
+		}
+	}
+
+	const f32 AtlasSize = (f32)g_Context->BitmapAtlasSize;
+
+	// Texels are mapped one to one to pixels
+	glyph_data Quad;
+	Quad.Position     = glm::round(Origin) + Entry.Offset;
+	Quad.Scale        = vec2(Entry.Width * 0.5f, Entry.Height * 0.5f);
+	Quad.Translate    = vec2(0.0f, Quad.Scale.y);
+	Quad.GlobalScale  = 1.0f;
+	Quad.Texcoords    = vec4(Entry.X, Entry.Y, Entry.X + Entry.Width, Entry.Y + Entry.Height) / AtlasSize;
+	Quad.FillColor    = FillColor;
+	Quad.TextureIndex = k_BitmapTextArray << 16;
+	Quad.ObjectIndex  = k_NoTextObject;
+
+	g_Context->BitmapQuads.push_back(Quad);
+
+	return true;
+}
+
+//! Forgets every cached text, the atlas is cleared before the next rasterization. Texts still drawn are rasterized again once they
+//! have been drawn BitmapMinFrames frames in a row.
+static void ResetBitmapTexts()
+{
+	g_Context->BitmapTexts.clear();
+	g_Context->BitmapPacker.Reset(g_Context->BitmapAtlasSize, g_Context->BitmapAtlasSize);
+
+	g_Context->BitmapAtlasFull  = false;
+	g_Context->BitmapAtlasDirty = true;
+}
+
+//! Appends the glyphs and kerning pairs of a pre-baked font to the atlas table of the layout shader the first time it is used,
+//! returns the id of its first glyph
+static u32 GetGpuGlyphBase(font_resource* Font)
+{
+	if (Font->GpuGlyphBase != k_InvalidHandle)
+	{
+		return Font->GpuGlyphBase;
+	}
+
+	eastl::vector<u32>&  Table    = g_Context->GpuAtlasTable;
+	const glyph_table&   Glyphs   = Font->Atlas.Glyphs;
+	const kerning_table& Kernings = Font->Atlas.Kernings;
+
+	// Pairs follow the glyphs, padded so that the next font starts on a glyph boundary
+	const u32 GlyphBase = (u32)Table.size() / k_GpuGlyphWords;
+	const u32 PairBase  = (u32)Table.size() + Glyphs.GetGlyphCount() * k_GpuGlyphWords;
+	const u32 PairWords = (Kernings.GetPairCount() * 2 + k_GpuGlyphWords - 1) / k_GpuGlyphWords * k_GpuGlyphWords;
+
+	Table.resize(PairBase + PairWords, 0);
+
+	const u32 TextureIndex = (Font->TextureArray << 16) | Font->Layer;
+
+	for (u32 GlyphIndex = 0; GlyphIndex < Glyphs.GetGlyphCount(); ++GlyphIndex)
+	{
+		const glyph& Glyph = Glyphs.GetGlyph(GlyphIndex);
+
+		const gpu_atlas_glyph Entry = {
+		    {Glyph.PlaneBounds.Left, Glyph.PlaneBounds.Bottom, Glyph.PlaneBounds.Right, Glyph.PlaneBounds.Top},
+		    {Glyph.Texcoords.Left, Glyph.Texcoords.Bottom, Glyph.Texcoords.Right, Glyph.Texcoords.Top},
+		    Glyph.Advance,
+		    TextureIndex,
+		    Glyph.HasGeometry ? 1u : 0u,
+		    Glyphs.GetCodepoint(GlyphIndex),
+		    PairBase + Glyph.KerningBegin * 2,
+		    Glyph.KerningCount,
+		    {0, 0},
+		};
+
+		memcpy(&Table[(GlyphBase + GlyphIndex) * k_GpuGlyphWords], &Entry, sizeof(Entry));
+	}
+
+	for (u32 PairIndex = 0; PairIndex < Kernings.GetPairCount(); ++PairIndex)
+	{
+		const kerning_pair& Pair = Kernings.GetPair(PairIndex);
+
+		Table[PairBase + PairIndex * 2] = Pair.Right;
+		memcpy(&Table[PairBase + PairIndex * 2 + 1], &Pair.Advance, sizeof(f32));
+	}
+
+	Font->GpuGlyphBase = GlyphBase;
+
+	return GlyphBase;
+}
+
+//! Queues the text for the layout shader, @see SetGpuTextLayoutThreshold(). Returns false, without queuing anything, when the text
+//! is too short or has to be laid out on the CPU.
+template <typename reader_t>
+static bool QueueGpuTextLayout(reader_t Reader, u64 Size, u32 FontIndex, f32 PixelSize, f32 X, f32 Y, color FillColor, u32* LineCount)
+{
+	// The size bounds the codepoint count, texts which cannot reach the threshold are not decoded twice
+	if (!g_Context->TextLayoutReady || Size / reader_t::k_MinCodepointSize < g_Context->GpuLayoutThreshold)
+	{
+		return false;
+	}
+
+	if (g_Context->GpuTextRuns.size() >= k_MaxGpuTextRuns)
+	{
+		return false;
+	}
+
+	font_resource& Font = g_Context->Fonts[FontIndex];
+
+	// Dynamic fonts and font stacks resolve glyphs while laying out
+	if (Font.Dynamic != nullptr || !Font.Stack.Fonts.empty())
+	{
+		return false;
+	}
+
+	eastl::vector<u32>& GlyphIds   = g_Context->GpuGlyphIds;
+	const u32           FirstGlyph = (u32)GlyphIds.size();
+
+	u32 LineFeeds = 0;
+
+	// CRLF counts as a single line break
+	bool AfterCarriageReturn = false;
+
+	for (u32 Codepoint; Reader.Next(&Codepoint);)
+	{
+		if (priv::NeedsShaping(Codepoint))
+		{
+			GlyphIds.resize(FirstGlyph);
+			return false;
+		}
+
+		// The line feed of CRLF is kept as a missing glyph, it takes no space
+		u32 GlyphId = k_GpuMissingGlyph;
+
+		if (Codepoint == U'\r' || (Codepoint == U'\n' && !AfterCarriageReturn))
+		{
+			GlyphId = k_GpuLineFeed;
+			LineFeeds += 1;
+		}
+		else if (Codepoint != U'\n')
+		{
+			// Indices in the font for now, the font is only added to the atlas table once the text is known to be long enough
+			const glyph* Glyph = Font.Atlas.Glyphs.Find(Codepoint);
+			GlyphId            = Glyph != nullptr ? Font.Atlas.Glyphs.GetGlyphIndex(Glyph) : k_GpuMissingGlyph;
+		}
+
+		AfterCarriageReturn = Codepoint == U'\r';
+
+		GlyphIds.push_back(GlyphId);
+	}
+
+	const u32 GlyphCount = (u32)GlyphIds.size() - FirstGlyph;
+
+	if (GlyphCount < g_Context->GpuLayoutThreshold)
+	{
+		GlyphIds.resize(FirstGlyph);
+		return false;
+	}
+
+	const u32 GlyphBase = GetGpuGlyphBase(&Font);
+
+	for (u32 GlyphIndex = FirstGlyph; GlyphIndex < (u32)GlyphIds.size(); ++GlyphIndex)
+	{
+		if (GlyphIds[GlyphIndex] < k_GpuLineFeed)
+		{
+			GlyphIds[GlyphIndex] += GlyphBase;
+		}
+	}
+
+	const bool HasKerning = g_Context->KerningEnabled && Font.Atlas.Kernings.GetPairCount() > 0;
+
+	gpu_text_run Run;
+	Run.FillColor  = FillColor;
+	Run.Origin     = vec2(X, Y);
+	Run.Scale      = PixelSize / Font.Atlas.Metrics.LineHeight;
+	Run.LineHeight = PixelSize;
+	Run.FirstGlyph = FirstGlyph;
+	Run.GlyphCount = GlyphCount;
+	Run.Flags      = HasKerning ? k_GpuRunKerning : 0;
+	Run.Padding    = 0;
+
+	g_Context->GpuTextRuns.push_back(Run);
+	g_Context->GpuRunArrays.push_back(Font.TextureArray);
+
+	*LineCount = LineFeeds + 1;
+
+	return true;
+}
+
+#ifdef GLUON_SHADER_HOT_RELOAD
+namespace fs = std::filesystem;
+
+static fs::file_time_type g_RectVShaderTime;
+static fs::file_time_type g_RectFShaderTime;
+static fs::file_time_type g_TextVShaderTime;
+static fs::file_time_type g_TextFShaderTime;
+
+static fs::path GetShaderPath(const char* ShaderName) { return fs::path(GLUON_SHADER_DIRECTORY) / ShaderName; }
+
+//! Updates the stored write times and returns true when one of the shaders has been modified since the last call
+static bool ShadersChanged(const char*         VertexName,
+                           const char*         FragmentName,
+                           fs::file_time_type* VertexTime,
+                           fs::file_time_type* FragmentTime)
+{
+	const auto NewVertexTime   = fs::last_write_time(GetShaderPath(VertexName));
+	const auto NewFragmentTime = fs::last_write_time(GetShaderPath(FragmentName));
+
+	if (NewVertexTime > *VertexTime || NewFragmentTime > *FragmentTime)
+	{
+		*VertexTime   = NewVertexTime;
+		*FragmentTime = NewFragmentTime;
+		return true;
+	}
+
+	return false;
+}
+#endif
+
+//! Shaders are compiled into the library, unless GLUON_SHADER_HOT_RELOAD is enabled in which case they are read from the source tree
+static program_handle LoadProgram(const char* VertexName, const char* FragmentName)
+{
+#ifdef GLUON_SHADER_HOT_RELOAD
+	return CreateProgramFromFiles(GetShaderPath(VertexName).string().c_str(), GetShaderPath(FragmentName).string().c_str());
+#else
+	const embedded_file* VertexFile   = FindEmbeddedFile(embedded_shaders::k_Files, VertexName);
+	const embedded_file* FragmentFile = FindEmbeddedFile(embedded_shaders::k_Files, FragmentName);
+
+	if (VertexFile == nullptr || FragmentFile == nullptr)
+	{
+		LOG_F(ERROR, "Shaders %s and %s are not embedded", VertexName, FragmentName);
+		return GLUON_INVALID_HANDLE;
+	}
+
+	return CreateProgramFromSources((const char*)VertexFile->Data, (const char*)FragmentFile->Data, VertexName);
+#endif
+}
+
+static program_handle LoadComputeProgram(const char* ShaderName)
+{
+#ifdef GLUON_SHADER_HOT_RELOAD
+	return CreateComputeProgram(CreateShaderFromFile(GetShaderPath(ShaderName).string().c_str(), ShaderType_Compute), true);
+#else
+	const embedded_file* ShaderFile = FindEmbeddedFile(embedded_shaders::k_Files, ShaderName);
+
+	if (ShaderFile == nullptr)
+	{
+		LOG_F(ERROR, "Shader %s is not embedded", ShaderName);
+		return GLUON_INVALID_HANDLE;
+	}
+
+	return CreateComputeProgramFromSource((const char*)ShaderFile->Data, ShaderName);
+#endif
+}
+
+namespace priv
+{
+	//! GLUON_RENDER_BACKEND=vulkan selects the Vulkan backend when it has been compiled in
+	static render_backend_type GetRequestedBackend()
+	{
+		const char* BackendName = getenv("GLUON_RENDER_BACKEND");
+
+		if (BackendName != nullptr && strcmp(BackendName, "vulkan") == 0)
+		{
+			return RenderBackend_Vulkan;
+		}
+
+		return RenderBackend_OpenGL;
+	}
+
+	void CreateRenderingContext()
+	{
+		if (g_Context != nullptr)
+		{
+			return;
+		}
+
+		InitializeBackend(GetRequestedBackend());
+#ifdef _DEBUG
+		EnableDebugging();
+#endif
+
+		g_Context = new rendering_context();
+		g_Context->StartupTimer.Start();
+
+		StartFontLoader();
+
+		{
+#ifdef GLUON_SHADER_HOT_RELOAD
+			ShadersChanged("rect.vert.glsl", "rect.frag.glsl", &g_RectVShaderTime, &g_RectFShaderTime);
+#endif
+
+			auto ProgramHandle = LoadProgram("rect.vert.glsl", "rect.frag.glsl");
+
+			g_Context->RectProgram = ProgramHandle;
+
+			u32 VertexBufferSize = (u32)k_QuadVertices.size() * sizeof(pos_vertex);
+			u32 IndexBufferSize  = (u32)k_QuadIndices.size() * sizeof(uint16_t);
+
+			g_Context->RectVertexBuffer = CreateImmutableBuffer(k_QuadVertices.size() * sizeof(pos_vertex), k_QuadVertices.data());
+			g_Context->RectIndexBuffer  = CreateImmutableBuffer(k_QuadIndices.size() * sizeof(uint16_t), k_QuadIndices.data());
+
+			g_Context->RectVertexArray = CreateVertexArray(g_Context->RectIndexBuffer);
+			AttachVertexBuffer(g_Context->RectVertexArray, g_Context->RectVertexBuffer, pos_vertex::k_Layout);
+
+			g_Context->LastRectangleCount   = 128 * 128;
+			g_Context->RectangleInfoSSBO    = CreateImmutableBuffer(128 * 128 * sizeof(rectangle));
+			g_Context->RectangleInfoSSBOPtr = MapBuffer(g_Context->RectangleInfoSSBO);
+		}
+
+		{
+#ifdef GLUON_SHADER_HOT_RELOAD
+			ShadersChanged("text.vert.glsl", "text.frag.glsl", &g_TextVShaderTime, &g_TextFShaderTime);
+#endif
+
+			auto ProgramHandle = LoadProgram("text.vert.glsl", "text.frag.glsl");
+
+			g_Context->TextProgram = ProgramHandle;
+
+			g_Context->LastGlyphCount = 0;
+			g_Context->TextInfoSSBO   = CreateImmutableBuffer(0);
+
+			// The object buffer is always bound, even without any retained text
+			g_Context->TextObjectData.resize(16);
+			g_Context->TextObjectBufferCount    = 16;
+			g_Context->TextObjectBuffer         = CreateBuffer(16 * sizeof(text_object_data), g_Context->TextObjectData.data());
+			g_Context->RetainedGlyphBuffer      = CreateBuffer(0);
+			g_Context->RetainedGlyphBufferCount = 0;
+
+			g_Context->GpuAtlasTableBuffer      = CreateBuffer(0);
+			g_Context->GpuLayoutInputBuffer     = CreateBuffer(0);
+			g_Context->GpuGlyphBuffer           = CreateBuffer(0);
+			g_Context->GpuAtlasTableBufferCount = 0;
+			g_Context->GpuLayoutInputBufferSize = 0;
+			g_Context->GpuGlyphBufferCount      = 0;
+
+			g_Context->BitmapGlyphBuffer      = CreateBuffer(0);
+			g_Context->BitmapQuadBuffer       = CreateBuffer(0);
+			g_Context->BitmapGlyphBufferCount = 0;
+			g_Context->BitmapQuadBufferCount  = 0;
+		}
+
+		const program_cache_stats CacheStats = GetProgramCacheStats();
+		LOG_F(INFO, "Program cache: %u hits (%.1fms loading), %u misses", CacheStats.Hits, CacheStats.LoadTime * 1000.0, CacheStats.Misses);
+	}
+
+	void DestroyRenderingContext()
+	{
+		StopFontLoader();
+
+		// Workers read the dynamic fonts
+		StopGlyphRasterizer();
+
+		for (auto& Font : g_Context->Fonts)
+		{
+			ReleaseFontAtlas(&Font.Atlas);
+
+			if (Font.Dynamic != nullptr)
+			{
+				ReleaseDynamicFont(Font.Dynamic);
+				delete Font.Dynamic;
+			}
+
+		}
+
+		for (const font_texture_array& Array : g_Context->FontArrays)
+		{
+			DestroyTexture(Array.Texture);
+		}
+
+		if (g_Context->BitmapFramebuffer.IsValid())
+		{
+			DestroyFramebuffer(g_Context->BitmapFramebuffer);
+			DestroyTexture(g_Context->BitmapAtlas);
+		}
+
+		if (g_Context->RectProgram.IsValid())
+		{
+			DestroyProgram(g_Context->RectProgram);
+		}
+
+		if (g_Context->TextProgram.IsValid())
+		{
+			DestroyProgram(g_Context->TextProgram);
+		}
+
+		if (g_Context->TextLayoutProgram.IsValid())
+		{
+			DestroyProgram(g_Context->TextLayoutProgram);
+		}
+
+		DestroyBuffer(g_Context->RetainedGlyphBuffer);
+		DestroyBuffer(g_Context->TextObjectBuffer);
+		DestroyBuffer(g_Context->GpuAtlasTableBuffer);
+		DestroyBuffer(g_Context->GpuLayoutInputBuffer);
+		DestroyBuffer(g_Context->GpuGlyphBuffer);
+		DestroyBuffer(g_Context->BitmapGlyphBuffer);
+		DestroyBuffer(g_Context->BitmapQuadBuffer);
+
+		delete g_Context;
+		g_Context = nullptr;
+
+		ShutdownBackend();
+	}
+
+	void Resize(f32 Width, f32 Height)
+	{
+		g_Context->ViewportWidth  = Width;
+		g_Context->ViewportHeight = Height;
+
+		const auto ViewMatrix = glm::mat4(1.0f);
+		const auto ProjMatrix = glm::orthoLH_ZO(0.0f, (f32)Width, (f32)Height, 0.0f, 0.0f, 100.0f);
+
+		memcpy(g_Context->ViewMatrix, glm::value_ptr(ViewMatrix), 16 * sizeof(f32));
+		memcpy(g_Context->ProjMatrix, glm::value_ptr(ProjMatrix), 16 * sizeof(f32));
+	}
+
+	void SetTextScale(f32 ScaleX, f32 ScaleY)
+	{
+		g_Context->TextScaleX = ScaleX;
+		g_Context->TextScaleY = ScaleY;
+	}
+
+	void RenderRectangles()
+	{
+		const i32 RectangleCount = (i32)g_Context->Rectangles.size();
+
+		if (RectangleCount == 0)
+		{
+			return;
+		}
+
+#ifdef GLUON_SHADER_HOT_RELOAD
+		if (ShadersChanged("rect.vert.glsl", "rect.frag.glsl", &g_RectVShaderTime, &g_RectFShaderTime))
+		{
+			auto ProgramHandle = LoadProgram("rect.vert.glsl", "rect.frag.glsl");
+
+			g_Context->RectProgram = ProgramHandle;
+		}
+#endif
+
+		// Programs still compiling are skipped instead of stalling the frame
+		if (!IsProgramReady(g_Context->RectProgram))
+		{
+			g_Context->Rectangles.clear();
+			return;
+		}
+
+		SetProgram(g_Context->RectProgram);
+
+		SetUniform("u_View", glm::make_mat4(g_Context->ViewMatrix));
+		SetUniform("u_Proj", glm::make_mat4(g_Context->ProjMatrix));
+		SetUniform("u_ViewportSize", vec2(g_Context->ViewportWidth, g_Context->ViewportHeight));
+
+		if (g_Context->LastRectangleCount < RectangleCount)
+		{
+			UnmapBuffer(g_Context->RectangleInfoSSBO);
+			ResizeImmutableBuffer(&g_Context->RectangleInfoSSBO, RectangleCount * sizeof(rectangle));
+
+			g_Context->LastRectangleCount   = RectangleCount;
+			g_Context->RectangleInfoSSBOPtr = MapBuffer(g_Context->RectangleInfoSSBO);
+		}
+
+		memcpy(g_Context->RectangleInfoSSBOPtr, g_Context->Rectangles.data(), RectangleCount * sizeof(rectangle));
+
+		BindVertexArray(g_Context->RectVertexArray);
+
+		BindStorageBuffer(1, g_Context->RectangleInfoSSBO);
+		DrawElementsInstanced((u32)k_QuadIndices.size(), RectangleCount);
+
+		g_Context->Rectangles.clear();
+	}
+
+	//! Ranges follow each other in the order of the arrays, their counts are set already
+	static void SetRangeBegins(eastl::vector<glyph_array_range>* Ranges)
+	{
+		u32 Begin = 0;
+
+		for (glyph_array_range& Range : *Ranges)
+		{
+			Range.Begin = Begin;
+			Begin += Range.Count;
+		}
+	}
+
+	//! Copies glyphs grouped by font texture array, so that each array draws a single instance range of Output. Glyphs keep their
+	//! order within an array.
+	static void SortGlyphsByArray(const glyph_data* Glyphs, u32 Count, glyph_data* Output, eastl::vector<glyph_array_range>* Ranges)
+	{
+		Ranges->clear();
+		Ranges->resize(g_Context->FontArrays.size());
+
+		for (u32 Index = 0; Index < Count; ++Index)
+		{
+			(*Ranges)[Glyphs[Index].TextureIndex >> 16].Count += 1;
+		}
+
+		SetRangeBegins(Ranges);
+
+		// Texts rarely mix arrays, the glyphs are then grouped already
+		if (Count == 0 || (*Ranges)[Glyphs[0].TextureIndex >> 16].Count == Count)
+		{
+			memcpy(Output, Glyphs, Count * sizeof(glyph_data));
+			return;
+		}
+
+		for (glyph_array_range& Range : *Ranges)
+		{
+			Range.Count = 0;
+		}
+
+		for (u32 Index = 0; Index < Count; ++Index)
+		{
+			glyph_array_range& Range = (*Ranges)[Glyphs[Index].TextureIndex >> 16];
+			Output[Range.Begin + Range.Count++] = Glyphs[Index];
+		}
+	}
+
+	static void DrawGlyphRange(const glyph_array_range& Range)
+	{
+		SetUniform("u_GlyphOffset", Range.Begin);
+		DrawElementsInstanced((u32)k_QuadIndices.size(), Range.Count);
+	}
+
+	//! Uploads the immediate texts queued for the layout shader and lays them out into GpuGlyphBuffer, GpuGlyphRanges gets the part
+	//! of the buffer written for each font texture array
+	static void DispatchTextLayout()
+	{
+		const u32 RunCount   = (u32)g_Context->GpuTextRuns.size();
+		const u32 GlyphCount = (u32)g_Context->GpuGlyphIds.size();
+
+		text_stats& Stats      = g_Context->TextStats;
+		Stats.GpuLaidOutTexts  = RunCount;
+		Stats.GpuLaidOutGlyphs = GlyphCount;
+		Stats.GpuLayoutBytes   = 0;
+
+		eastl::vector<glyph_array_range>& Ranges = g_Context->GpuGlyphRanges;
+		Ranges.clear();
+		Ranges.resize(g_Context->FontArrays.size());
+
+		if (RunCount == 0)
+		{
+			return;
+		}
+
+		// The runs of each array write a single range of the output, the shader writes the glyphs of a run where its ids start
+		for (u32 RunIndex = 0; RunIndex < RunCount; ++RunIndex)
+		{
+			Ranges[g_Context->GpuRunArrays[RunIndex]].Count += g_Context->GpuTextRuns[RunIndex].GlyphCount;
+		}
+
+		SetRangeBegins(&Ranges);
+
+		if (Ranges[g_Context->GpuRunArrays[0]].Count != GlyphCount)
+		{
+			eastl::vector<u32>& SortedIds = g_Context->SortedGpuGlyphIds;
+			SortedIds.resize(GlyphCount);
+
+			for (glyph_array_range& Range : Ranges)
+			{
+				Range.Count = 0;
+			}
+
+			for (u32 RunIndex = 0; RunIndex < RunCount; ++RunIndex)
+			{
+				gpu_text_run&      Run   = g_Context->GpuTextRuns[RunIndex];
+				glyph_array_range& Range = Ranges[g_Context->GpuRunArrays[RunIndex]];
+
+				const u32 FirstGlyph = Range.Begin + Range.Count;
+				memcpy(SortedIds.data() + FirstGlyph, g_Context->GpuGlyphIds.data() + Run.FirstGlyph, Run.GlyphCount * sizeof(u32));
+
+				Run.FirstGlyph = FirstGlyph;
+				Range.Count += Run.GlyphCount;
+			}
+
+			g_Context->GpuGlyphIds.swap(SortedIds);
+		}
+
+		const eastl::vector<u32>& Table = g_Context->GpuAtlasTable;
+
+		if (g_Context->GpuAtlasTableBufferCount < (u32)Table.size())
+		{
+			ResizeBuffer(g_Context->GpuAtlasTableBuffer, Table.size() * sizeof(u32), Table.data());
+
+			g_Context->GpuAtlasTableBufferCount = (u32)Table.size();
+			Stats.GpuLayoutBytes += Table.size() * sizeof(u32);
+		}
+
+		const u64 RunsSize  = RunCount * sizeof(gpu_text_run);
+		const u64 InputSize = RunsSize + GlyphCount * sizeof(u32);
+
+		if (g_Context->GpuLayoutInputBufferSize < InputSize)
+		{
+			g_Context->GpuLayoutInputBufferSize = eastl::max(InputSize, g_Context->GpuLayoutInputBufferSize * 2);
+			ResizeBuffer(g_Context->GpuLayoutInputBuffer, g_Context->GpuLayoutInputBufferSize);
+		}
+
+		UpdateBufferData(g_Context->GpuLayoutInputBuffer, g_Context->GpuTextRuns.data(), 0, RunsSize);
+		UpdateBufferData(g_Context->GpuLayoutInputBuffer, g_Context->GpuGlyphIds.data(), RunsSize, GlyphCount * sizeof(u32));
+
+		Stats.GpuLayoutBytes += InputSize;
+
+		if (g_Context->GpuGlyphBufferCount < GlyphCount)
+		{
+			g_Context->GpuGlyphBufferCount = eastl::max(GlyphCount, g_Context->GpuGlyphBufferCount * 2);
+			ResizeBuffer(g_Context->GpuGlyphBuffer, g_Context->GpuGlyphBufferCount * sizeof(glyph_data));
+		}
+
+		SetProgram(g_Context->TextLayoutProgram);
+
+		BindStorageBuffer(1, g_Context->GpuGlyphBuffer);
+		BindStorageBuffer(2, g_Context->GpuAtlasTableBuffer);
+		BindStorageBuffer(3, g_Context->GpuLayoutInputBuffer);
+
+		GLN_ASSERT(RunCount <= k_MaxGpuTextRuns);
+		DispatchCompute(RunCount);
+	}
+
+	//! Streams glyphs to a buffer which only grows
+	static void UploadGlyphRun(buffer_handle Buffer, u32* BufferCount, const glyph_run& Glyphs)
+	{
+		if (*BufferCount < (u32)Glyphs.size())
+		{
+			*BufferCount = eastl::max((u32)Glyphs.size(), *BufferCount * 2);
+			ResizeBuffer(Buffer, *BufferCount * sizeof(glyph_data));
+		}
+
+		UpdateBufferData(Buffer, Glyphs.data(), 0, Glyphs.size() * sizeof(glyph_data));
+	}
+
+	//! Draws the texts entering the bitmap cache into the coverage atlas, with the distance field shading of the screen. Expects the
+	//! text program to be bound, and leaves the uniforms set for the atlas.
+	static void RasterizeBitmapTexts()
+	{
+		const u32 GlyphCount = (u32)g_Context->BitmapGlyphs.size();
+
+		if (!g_Context->BitmapFramebuffer.IsValid() || (GlyphCount == 0 && !g_Context->BitmapAtlasDirty))
+		{
+			return;
+		}
+
+		BindFramebuffer(g_Context->BitmapFramebuffer);
+
+		if (g_Context->BitmapAtlasDirty)
+		{
+			Clear(vec4(0.0f));
+			g_Context->BitmapAtlasDirty = false;
+		}
+
+		if (GlyphCount > 0)
+		{
+			glyph_run& SortedGlyphs = g_Context->SortedBitmapGlyphs;
+			SortedGlyphs.resize(GlyphCount);
+			SortGlyphsByArray(g_Context->BitmapGlyphs.data(), GlyphCount, SortedGlyphs.data(), &g_Context->BitmapGlyphRanges);
+
+			UploadGlyphRun(g_Context->BitmapGlyphBuffer, &g_Context->BitmapGlyphBufferCount, SortedGlyphs);
+
+			// Text positions count from the bottom, which is the first row of the atlas
+			const f32  AtlasSize  = (f32)g_Context->BitmapAtlasSize;
+			const auto ProjMatrix = glm::orthoLH_ZO(0.0f, AtlasSize, AtlasSize, 0.0f, 0.0f, 100.0f);
+
+			SetViewport(0, 0, (i32)AtlasSize, (i32)AtlasSize);
+
+			SetUniform("u_View", glm::make_mat4(g_Context->ViewMatrix));
+			SetUniform("u_Proj", ProjMatrix);
+			SetUniform("u_ViewportSize", vec2(AtlasSize, AtlasSize));
+			SetUniform("u_FontAtlases", 0);
+
+			BindVertexArray(g_Context->RectVertexArray);
+			BindStorageBuffer(1, g_Context->BitmapGlyphBuffer);
+			BindStorageBuffer(2, g_Context->TextObjectBuffer);
+
+			// Coverage accumulates in the red channel with the usual blending
+			for (u32 ArrayIndex = 0; ArrayIndex < (u32)g_Context->FontArrays.size(); ++ArrayIndex)
+			{
+				const font_texture_array& Array = g_Context->FontArrays[ArrayIndex];
+				const glyph_array_range&  Range = g_Context->BitmapGlyphRanges[ArrayIndex];
+
+				if (Range.Count == 0)
+				{
+					continue;
+				}
+
+				BindTexture(0, Array.Texture);
+				SetUniform("u_FontArray", ArrayIndex);
+				SetUniform("u_AtlasType", (u32)Array.Type);
+				SetUniform("u_DistanceRange", Array.DistanceRange);
+
+				DrawGlyphRange(Range);
+			}
+
+			SetViewport(0, 0, (i32)g_Context->ViewportWidth, (i32)g_Context->ViewportHeight);
+		}
+
+		BindFramebuffer(GLUON_INVALID_HANDLE);
+	}
+
+	void RenderTexts()
+	{
+		const i32 GlyphCount = (i32)g_Context->GlyphData.size();
+
+#ifdef GLUON_SHADER_HOT_RELOAD
+		if (ShadersChanged("text.vert.glsl", "text.frag.glsl", &g_TextVShaderTime, &g_TextFShaderTime))
+		{
+			auto ProgramHandle = LoadProgram("text.vert.glsl", "text.frag.glsl");
+
+			g_Context->TextProgram = ProgramHandle;
+		}
+#endif
+
+		g_Context->TextStats.ImmediateBytes = GlyphCount * sizeof(glyph_data);
+		g_Context->TextStats.GreekedTexts   = g_Context->GreekedTexts;
+		g_Context->TextStats.CulledTexts    = g_Context->CulledTexts;
+		g_Context->TextStats.AvoidedGlyphs  = g_Context->AvoidedGlyphs;
+
+		g_Context->TextStats.BitmapTexts           = (u32)g_Context->BitmapQuads.size();
+		g_Context->TextStats.RasterizedBitmapTexts = g_Context->RasterizedBitmapTexts;
+
+		g_Context->GreekedTexts          = 0;
+		g_Context->CulledTexts           = 0;
+		g_Context->AvoidedGlyphs         = 0;
+		g_Context->RasterizedBitmapTexts = 0;
+
+		// Polled until the first frame it can be used, texts of this frame were laid out on the CPU already
+		if (!g_Context->TextLayoutReady && g_Context->TextLayoutProgram.IsValid())
+		{
+			g_Context->TextLayoutReady = IsProgramReady(g_Context->TextLayoutProgram);
+		}
+
+		if (!IsProgramReady(g_Context->TextProgram))
+		{
+			// Texts queued for rasterization are marked as cached already
+			if (!g_Context->BitmapGlyphs.empty())
+			{
+				ResetBitmapTexts();
+			}
+
+			g_Context->GlyphData.clear();
+			g_Context->GpuTextRuns.clear();
+			g_Context->GpuRunArrays.clear();
+			g_Context->GpuGlyphIds.clear();
+			g_Context->BitmapGlyphs.clear();
+			g_Context->BitmapQuads.clear();
+			return;
+		}
+
+		// Before binding the text storage buffers, the dispatch uses the same bindings
+		DispatchTextLayout();
+
+		SetProgram(g_Context->TextProgram);
+
+		RasterizeBitmapTexts();
+
+		SetUniform("u_View", glm::make_mat4(g_Context->ViewMatrix));
+		SetUniform("u_Proj", glm::make_mat4(g_Context->ProjMatrix));
+		SetUniform("u_ViewportSize", vec2(g_Context->ViewportWidth, g_Context->ViewportHeight));
+
+		if (g_Context->LastGlyphCount < GlyphCount)
+		{
+			UnmapBuffer(g_Context->TextInfoSSBO);
+			ResizeImmutableBuffer(&g_Context->TextInfoSSBO, GlyphCount * sizeof(glyph_data));
+
+			g_Context->LastGlyphCount  = GlyphCount;
+			g_Context->TextInfoSSBOPtr = MapBuffer(g_Context->TextInfoSSBO);
+		}
+
+		SortGlyphsByArray(g_Context->GlyphData.data(), GlyphCount, (glyph_data*)g_Context->TextInfoSSBOPtr, &g_Context->GlyphRanges);
+
+		BindVertexArray(g_Context->RectVertexArray);
+
+		SetUniform("u_FontAtlases", 0);
+
+		BindStorageBuffer(2, g_Context->TextObjectBuffer);
+
+		// Free ranges and hidden objects have collapsed quads, the whole buffer is drawn at once
+		const u32 RetainedGlyphCount = g_Context->RetainedGlyphRanges.GetSize();
+
+		// Immediate glyphs are grouped per array. Retained texts keep their range of the buffer, it is drawn for each array they use
+		// and the vertex shader collapses the glyphs of the other arrays.
+		for (u32 ArrayIndex = 0; ArrayIndex < (u32)g_Context->FontArrays.size(); ++ArrayIndex)
+		{
+			const font_texture_array& Array = g_Context->FontArrays[ArrayIndex];
+
+			const glyph_array_range& Immediate    = g_Context->GlyphRanges[ArrayIndex];
+			const glyph_array_range& GpuLaidOut   = g_Context->GpuGlyphRanges[ArrayIndex];
+			const bool               DrawRetained = RetainedGlyphCount > 0 && (g_Context->RetainedArrayMask & GetArrayBit(ArrayIndex)) != 0;
+
+			if (Immediate.Count == 0 && GpuLaidOut.Count == 0 && !DrawRetained)
+			{
+				continue;
+			}
+
+			BindTexture(0, Array.Texture);
+			SetUniform("u_FontArray", ArrayIndex);
+			SetUniform("u_AtlasType", (u32)Array.Type);
+			SetUniform("u_DistanceRange", Array.DistanceRange);
+
+			if (Immediate.Count > 0)
+			{
+				BindStorageBuffer(1, g_Context->TextInfoSSBO);
+				DrawGlyphRange(Immediate);
+			}
+
+			if (GpuLaidOut.Count > 0)
+			{
+				BindStorageBuffer(1, g_Context->GpuGlyphBuffer);
+				DrawGlyphRange(GpuLaidOut);
+			}
+
+			if (DrawRetained)
+			{
+				BindStorageBuffer(1, g_Context->RetainedGlyphBuffer);
+				DrawGlyphRange({0, RetainedGlyphCount});
+			}
+		}
+
+		if (!g_Context->BitmapQuads.empty())
+		{
+			UploadGlyphRun(g_Context->BitmapQuadBuffer, &g_Context->BitmapQuadBufferCount, g_Context->BitmapQuads);
+
+			BindTexture(0, g_Context->BitmapAtlas);
+			SetUniform("u_FontArray", k_BitmapTextArray);
+			SetUniform("u_AtlasType", k_CoverageAtlasType);
+
+			BindStorageBuffer(1, g_Context->BitmapQuadBuffer);
+			DrawGlyphRange({0, (u32)g_Context->BitmapQuads.size()});
+		}
+
+		g_Context->GlyphData.clear();
+		g_Context->GpuTextRuns.clear();
+		g_Context->GpuRunArrays.clear();
+		g_Context->GpuGlyphIds.clear();
+		g_Context->BitmapGlyphs.clear();
+		g_Context->BitmapQuads.clear();
+
+		// Only once the quads of the frame are drawn
+		if (g_Context->BitmapAtlasFull || g_Context->BitmapTexts.size() > k_MaxBitmapTexts)
+		{
+			ResetBitmapTexts();
+		}
+	}
+
+	void UploadFonts()
+	{
+		CollectLoadedFonts(&g_Context->LoadedFonts);
+
+		for (auto& LoadedFont : g_Context->LoadedFonts)
+		{
+			font_resource& Font = g_Context->Fonts[LoadedFont.FontIndex];
+			Font.Atlas          = eastl::move(LoadedFont.Atlas);
+
+			if (Font.Atlas.Data == nullptr)
+			{
+				LOG_F(ERROR, "Font %s could not be loaded", Font.Name.c_str());
+				Font.Status = FontStatus_Failed;
+				continue;
+			}
+
+			AllocateFontLayer(&Font);
+
+			Font.Status = FontStatus_Uploading;
+		}
+
+		g_Context->LoadedFonts.clear();
+
+		u64 Budget = k_FontUploadBudget;
+
+		for (u32 FontIndex = 0; FontIndex < (u32)g_Context->Fonts.size() && Budget > 0; ++FontIndex)
+		{
+			font_resource& Font = g_Context->Fonts[FontIndex];
+
+			if (Font.Status != FontStatus_Uploading)
+			{
+				continue;
+			}
+
+			// Whole rows only, at least one per frame
+			const u64 RowSize  = (u64)Font.Atlas.Width * Font.Atlas.Type;
+			const u32 RowCount = (u32)eastl::min<u64>(Font.Atlas.Height - Font.UploadedRows, eastl::max<u64>(Budget / RowSize, 1));
+
+			const u8* Rows = Font.Atlas.Data + Font.UploadedRows * RowSize;
+			const texture_handle Texture = g_Context->FontArrays[Font.TextureArray].Texture;
+			SetTextureLayerSubData(Texture, Font.Layer, 0, Font.UploadedRows, Font.Atlas.Width, RowCount, Rows);
+
+			Font.UploadedRows += RowCount;
+			Budget -= eastl::min(Budget, RowCount * RowSize);
+
+			if (Font.UploadedRows < (u32)Font.Atlas.Height)
+			{
+				continue;
+			}
+
+			// Binary atlases are uploaded straight from the file mapping
+			ReleaseFontAtlasTexels(&Font.Atlas);
+			Font.Status = FontStatus_Ready;
+
+			const f64 LoadTime = Font.LoadTimer.GetElapsedSeconds();
+
+			font_load_stats& Stats = g_Context->FontLoadStats;
+			Stats.LoadedFonts += 1;
+			Stats.LastLoadTime = LoadTime;
+			Stats.MaxLoadTime  = eastl::max(Stats.MaxLoadTime, LoadTime);
+			Stats.TotalLoadTime += LoadTime;
+
+			LOG_F(INFO, "Font %s ready %.1fms after it was requested", Font.Name.c_str(), LoadTime * 1000.0);
+
+			if (g_Context->FallbackFont < 0)
+			{
+				g_Context->FallbackFont = (i32)FontIndex;
+			}
+
+			UpdateFontStacks(FontIndex);
+
+			for (auto& Callback : g_Context->FontReadyCallbacks)
+			{
+				Callback(font_handle{FontIndex}, Font.Name.c_str());
+			}
+		}
+	}
+
+	//! Glyphs which did not fit are laid out and queued again, now that a page can be recycled
+	static void RetryFailedGlyphs(font_resource* Font)
+	{
+		dynamic_font* Dynamic = Font->Dynamic;
+
+		for (u32 Codepoint : Dynamic->FailedCodepoints)
+		{
+			Font->Atlas.Glyphs.Find(Codepoint)->AtlasPage = k_GlyphNotResident;
+		}
+
+		g_Context->GlyphAtlasStats.FailedGlyphs -= (u32)Dynamic->FailedCodepoints.size();
+		Dynamic->FailedCodepoints.clear();
+
+		Font->Generation += 1;
+	}
+
+	//! Finds room for a glyph in the atlas of a dynamic font, recycling the least recently used page when all of them are full
+	static bool AllocateGlyph(font_resource* Font, u32 Width, u32 Height, u32* Page, u32* X, u32* Y)
+	{
+		dynamic_font* Dynamic = Font->Dynamic;
+
+		for (u32 PageIndex = 0; PageIndex < (u32)Dynamic->Pages.size(); ++PageIndex)
+		{
+			if (Dynamic->Pages[PageIndex].Packer.Pack(Width, Height, X, Y))
+			{
+				*Page = PageIndex;
+				return true;
+			}
+		}
+
+		u32 Evicted = 0;
+		for (u32 PageIndex = 1; PageIndex < (u32)Dynamic->Pages.size(); ++PageIndex)
+		{
+			if (Dynamic->Pages[PageIndex].LastUsedFrame < Dynamic->Pages[Evicted].LastUsedFrame)
+			{
+				Evicted = PageIndex;
+			}
+		}
+
+		glyph_page& EvictedPage = Dynamic->Pages[Evicted];
+
+		// Glyphs of this frame were already placed with their texcoords, the atlas is too small for what is on screen
+		if (EvictedPage.LastUsedFrame == g_Context->FrameIndex)
+		{
+			return false;
+		}
+
+		for (u32 Codepoint : EvictedPage.Codepoints)
+		{
+			Font->Atlas.Glyphs.Find(Codepoint)->AtlasPage = k_GlyphNotResident;
+		}
+
+		g_Context->GlyphAtlasStats.ResidentGlyphs -= (u32)EvictedPage.Codepoints.size();
+		g_Context->GlyphAtlasStats.EvictedPages += 1;
+
+		EvictedPage.Codepoints.clear();
+		EvictedPage.Packer.Reset(k_GlyphPageWidth, k_GlyphPageHeight);
+
+		if (!Dynamic->FailedCodepoints.empty())
+		{
+			RetryFailedGlyphs(Font);
+		}
+
+		// Layouts referencing the evicted glyphs are invalidated
+		Font->Generation += 1;
+
+		*Page = Evicted;
+		return EvictedPage.Packer.Pack(Width, Height, X, Y);
+	}
+
+	//! Copies the glyphs rasterized by the worker threads to the atlases of dynamic fonts
+	void UploadGlyphs()
+	{
+		glyph_atlas_stats& Stats = g_Context->GlyphAtlasStats;
+
+		Stats.RasterizedGlyphs = 0;
+
+		// Failed glyphs wait for a page that was not drawn this frame, instead of failing again on every layout
+		for (u32 FontIndex = 0; Stats.FailedGlyphs > 0 && FontIndex < (u32)g_Context->Fonts.size(); ++FontIndex)
+		{
+			font_resource& Font = g_Context->Fonts[FontIndex];
+
+			if (Font.Dynamic == nullptr || Font.Dynamic->FailedCodepoints.empty())
+			{
+				continue;
+			}
+
+			const bool CanRecycle = eastl::any_of(Font.Dynamic->Pages.begin(), Font.Dynamic->Pages.end(), [](const glyph_page& Page) {
+				return Page.LastUsedFrame != g_Context->FrameIndex;
+			});
+
+			if (CanRecycle)
+			{
+				RetryFailedGlyphs(&Font);
+			}
+		}
+
+		if (Stats.PendingGlyphs == 0)
+		{
+			return;
+		}
+
+		CollectRasterizedGlyphs(&g_Context->RasterizedGlyphs);
+
+		for (const rasterized_glyph& Rasterized : g_Context->RasterizedGlyphs)
+		{
+			font_resource& Font  = g_Context->Fonts[Rasterized.FontIndex];
+			glyph*         Glyph = Font.Atlas.Glyphs.Find(Rasterized.Codepoint);
+
+			Stats.PendingGlyphs -= 1;
+
+			if (Rasterized.Width == 0 || Rasterized.Height == 0)
+			{
+				Glyph->HasGeometry = false;
+				Glyph->AtlasPage   = 0;
+
+				Font.Generation += 1;
+				continue;
+			}
+
+			// One texel apart, so that filtering does not read the neighbouring glyphs. Rows are padded, @see rasterized_glyph.
+			u32 Page, X, Y;
+
+			if (!AllocateGlyph(&Font, Rasterized.Stride + 1, Rasterized.Height + 1, &Page, &X, &Y))
+			{
+				if (Font.Dynamic->FailedCodepoints.empty())
+				{
+					LOG_F(WARNING, "Glyph atlas of %s is full, glyphs are not drawn until a page is recycled", Font.Name.c_str());
+				}
+
+				Glyph->AtlasPage = k_GlyphFailed;
+				Font.Dynamic->FailedCodepoints.push_back(Rasterized.Codepoint);
+
+				Stats.FailedGlyphs += 1;
+				continue;
+			}
+
+			const u32 Top = Page * k_GlyphPageHeight + Y;
+
+			const texture_handle Texture = g_Context->FontArrays[Font.TextureArray].Texture;
+			SetTextureLayerSubData(Texture, Font.Layer, X, Top, Rasterized.Stride, Rasterized.Height, Rasterized.Texels.data());
+
+			const f32 Width  = (f32)Font.Atlas.Width;
+			const f32 Height = (f32)Font.Atlas.Height;
+
+			Glyph->Texcoords.Left   = X / Width;
+			Glyph->Texcoords.Right  = (X + Rasterized.Width) / Width;
+			Glyph->Texcoords.Top    = Top / Height;
+			Glyph->Texcoords.Bottom = (Top + Rasterized.Height) / Height;
+
+			Glyph->PlaneBounds.Left   = Rasterized.OffsetX / k_DynamicGlyphSize;
+			Glyph->PlaneBounds.Right  = (Rasterized.OffsetX + Rasterized.Width) / k_DynamicGlyphSize;
+			Glyph->PlaneBounds.Top    = -Rasterized.OffsetY / k_DynamicGlyphSize;
+			Glyph->PlaneBounds.Bottom = -(Rasterized.OffsetY + Rasterized.Height) / k_DynamicGlyphSize;
+
+			Glyph->AtlasPage = (u16)Page;
+			Font.Dynamic->Pages[Page].Codepoints.push_back(Rasterized.Codepoint);
+
+			Font.Generation += 1;
+
+			Stats.ResidentGlyphs += 1;
+			Stats.RasterizedGlyphs += 1;
+		}
+
+		g_Context->RasterizedGlyphs.clear();
+	}
+
+	//! Uploads the glyphs of the texts which changed, and the records of the ones which moved or whose visibility changed
+	static void UploadRetainedData(buffer_handle Buffer,
+	                               u32*          BufferCount,
+	                               const void*   Data,
+	                               u32           Count,
+	                               u64           ElementSize,
+	                               dirty_range*  DirtyRange)
+	{
+		if (*BufferCount < Count)
+		{
+			// Growing the buffer uploads everything once
+			ResizeBuffer(Buffer, Count * ElementSize, Data);
+
+			*BufferCount = Count;
+			g_Context->TextStats.RetainedBytes += Count * ElementSize;
+		}
+		else if (!DirtyRange->IsEmpty())
+		{
+			const u64 Offset = DirtyRange->Begin * ElementSize;
+			const u64 Length = (DirtyRange->End - DirtyRange->Begin) * ElementSize;
+
+			UpdateBufferData(Buffer, (const u8*)Data + Offset, Offset, Length);
+			g_Context->TextStats.RetainedBytes += Length;
+		}
+
+		DirtyRange->Reset();
+	}
+
+	void UpdateTextObjects()
+	{
+		g_Context->TextStats.RetainedBytes = 0;
+		g_Context->RetainedArrayMask       = 0;
+
+		for (u32 ObjectIndex = 0; ObjectIndex < (u32)g_Context->TextObjects.size(); ++ObjectIndex)
+		{
+			text_object& Object = g_Context->TextObjects[ObjectIndex];
+
+			if (!Object.Alive)
+			{
+				continue;
+			}
+
+			u32 FontIndex;
+
+			const bool HasFont = ResolveFont(Object.Font, &FontIndex);
+
+			// Relayout once the requested font replaces the fallback one, or once the glyphs of a dynamic font changed
+			const bool FontChanged =
+			    HasFont && (FontIndex != Object.LaidOutFont || GetLayoutGeneration(FontIndex) != Object.LaidOutGeneration);
+
+			if (HasFont && (Object.LayoutDirty || FontChanged))
+			{
+				const char32_t*    String = Object.String.c_str();
+				const shaped_text* Shaped =
+				    GetShapedText(utf32_reader{String}, String, Object.String.size() * sizeof(char32_t), FontIndex, Object.PixelSize);
+
+				BreakLines(*Shaped, 0.0f, &g_Context->TextLines);
+
+				glyph_run Run;
+				PlaceGlyphs(*Shaped, g_Context->TextLines, vec2(0.0f), Object.Data.FillColor, &Run);
+
+				const u32 GlyphCount = (u32)Run.size();
+
+				if (GlyphCount > Object.GlyphCapacity)
+				{
+					ClearRetainedGlyphs(Object.GlyphOffset, Object.GlyphCapacity);
+
+					g_Context->RetainedGlyphRanges.Free(Object.GlyphOffset, Object.GlyphCapacity);
+					g_Context->DirtyGlyphs.Add(Object.GlyphOffset, Object.GlyphCapacity);
+
+					Object.GlyphOffset   = g_Context->RetainedGlyphRanges.Allocate(GlyphCount);
+					Object.GlyphCapacity = GlyphCount;
+
+					const u32 RequiredSize = g_Context->RetainedGlyphRanges.GetSize();
+					if (g_Context->RetainedGlyphs.size() < RequiredSize)
+					{
+						// Geometric growth, so that creating texts one by one does not upload the whole buffer each time
+						g_Context->RetainedGlyphs.resize(eastl::max<u32>(RequiredSize, (u32)g_Context->RetainedGlyphs.size() * 2));
+					}
+				}
+
+				glyph_data* Glyphs = g_Context->RetainedGlyphs.data() + Object.GlyphOffset;
+
+				Object.ArrayMask = 0;
+
+				for (u32 GlyphIndex = 0; GlyphIndex < GlyphCount; ++GlyphIndex)
+				{
+					Glyphs[GlyphIndex]             = Run[GlyphIndex];
+					Glyphs[GlyphIndex].ObjectIndex = ObjectIndex;
+
+					Object.ArrayMask |= GetArrayBit(Run[GlyphIndex].TextureIndex >> 16);
+				}
+
+				// Shorter strings keep their range, the remaining quads are collapsed
+				ClearRetainedGlyphs(Object.GlyphOffset + GlyphCount, Object.GlyphCapacity - GlyphCount);
+
+				g_Context->DirtyGlyphs.Add(Object.GlyphOffset, Object.GlyphCapacity);
+
+				Object.Lines             = g_Context->TextLines;
+				Object.GlyphCount        = GlyphCount;
+				Object.LaidOutFont       = FontIndex;
+				Object.LaidOutGeneration = GetLayoutGeneration(FontIndex);
+				Object.PageMask          = Shaped->PageMask;
+				Object.LayoutDirty       = false;
+			}
+
+			if (HasFont && Object.DrawnThisFrame)
+			{
+				TouchGlyphPages(FontIndex, Object.PageMask);
+			}
+
+			// Glyphs of greeked and culled texts stay in the buffer, they are hidden like the texts which are not drawn
+			const text_lod Lod   = GetTextLod(Object.PixelSize);
+			const bool     Drawn = HasFont && Object.DrawnThisFrame;
+
+			if (Drawn && Lod != TextLod_Glyphs)
+			{
+				g_Context->AvoidedGlyphs += Object.GlyphCount;
+
+				if (Lod == TextLod_Bars)
+				{
+					g_Context->GreekedTexts += 1;
+					DrawGreekedLines(Object.Lines, Object.PixelSize, Object.Data.Position, Object.Data.FillColor);
+				}
+				else
+				{
+					g_Context->CulledTexts += 1;
+				}
+			}
+
+			const f32 Visible = (Drawn && Lod == TextLod_Glyphs) ? 1.0f : 0.0f;
+
+			if (Visible > 0.0f)
+			{
+				g_Context->RetainedArrayMask |= Object.ArrayMask;
+			}
+
+			if (Object.Data.Visible != Visible)
+			{
+				Object.Data.Visible = Visible;
+				Object.DataDirty    = true;
+			}
+
+			if (Object.DataDirty)
+			{
+				g_Context->TextObjectData[ObjectIndex] = Object.Data;
+				g_Context->DirtyObjects.Add(ObjectIndex, 1);
+
+				Object.DataDirty = false;
+			}
+
+			Object.DrawnThisFrame = false;
+		}
+
+		// Freed ranges are zeroed by DestroyText(), the mirror never shrinks
+		UploadRetainedData(g_Context->RetainedGlyphBuffer,
+		                   &g_Context->RetainedGlyphBufferCount,
+		                   g_Context->RetainedGlyphs.data(),
+		                   (u32)g_Context->RetainedGlyphs.size(),
+		                   sizeof(glyph_data),
+		                   &g_Context->DirtyGlyphs);
+
+		UploadRetainedData(g_Context->TextObjectBuffer,
+		                   &g_Context->TextObjectBufferCount,
+		                   g_Context->TextObjectData.data(),
+		                   (u32)g_Context->TextObjectData.size(),
+		                   sizeof(text_object_data),
+		                   &g_Context->DirtyObjects);
+	}
+
+	void Flush()
+	{
+		UploadFonts();
+		UploadGlyphs();
+		UpdateTextObjects();
+
+		BeginFrame();
+
+		SetViewport(0, 0, (i32)g_Context->ViewportWidth, (i32)g_Context->ViewportHeight);
+		Clear(vec4(0.2f, 0.4f, 0.5f, 1.0f));
+
+		SetBlending(true);
+
+		RenderRectangles();
+		RenderTexts();
+
+		SetBlending(false);
+
+		EndFrame();
+
+		g_Context->CullingStats = g_Context->FrameCulling;
+		g_Context->FrameCulling = culling_stats();
+
+		if (!g_Context->FirstFrameRendered && IsProgramReady(g_Context->RectProgram) && IsProgramReady(g_Context->TextProgram))
+		{
+			g_Context->FirstFrameRendered = true;
+			LOG_F(INFO, "First complete frame %.1fms after context creation", g_Context->StartupTimer.GetElapsedSeconds() * 1000.0);
+		}
+
+		g_Context->FrameIndex += 1;
 	}
+
+	bool IsFirstFrameRendered() { return g_Context != nullptr && g_Context->FirstFrameRendered; }
 }
 
 void DrawRectangle(f32   X,
@@ -354,6 +2521,17 @@ void DrawRectangle(f32   X,
                    color BorderColor /*= {0.0f, 0.0f, 0.0f, 1.0f}*/
 )
 {
+	// Including the border and its antialiasing
+	const f32 Margin = Max(BorderWidth, k_RectangleBorder) + 1.0f;
+
+	if (!OverlapsViewport(vec4(X - Margin, Y - Margin, X + Width + Margin, Y + Height + Margin)))
+	{
+		culling_stats& Culling = g_Context->FrameCulling;
+		Culling.CulledRectangles += 1;
+		Culling.SavedBytes += sizeof(rectangle);
+		return;
+	}
+
 	rectangle Rectangle;
 	Rectangle.Size              = vec2(Width, Height) / 2.0f;
 	Rectangle.Position          = vec2(X, Y) + Rectangle.Size;
@@ -365,90 +2543,556 @@ void DrawRectangle(f32   X,
 	g_Context->Rectangles.push_back(Rectangle);
 }
 
-void SetFont(const char* FontName)
+font_handle LoadFont(const char* FontName)
 {
-	g_Context->CurrentFont = FontName;
+	auto Iterator = g_Context->FontLookupMap.find(FontName);
 
-	// Load FontData if needed
-	if (g_Context->FontLookupMap.find(FontName) == g_Context->FontLookupMap.end())
+	if (Iterator != g_Context->FontLookupMap.end())
 	{
-		auto Atlas = LoadFontAtlas(FontName);
+		return font_handle{Iterator->second};
+	}
 
-		// FIXME: We probably do not want to upload textures at this point
-		texture_handle Texture = CreateTexture(Atlas.Width, Atlas.Height, 3);
-		SetTextureWrapping(Texture, WrapMode_ClampToBorder, WrapMode_ClampToBorder);
-		SetTextureData(Texture, Atlas.Data);
+	// Fonts are decoded on the loader thread and uploaded by priv::UploadFonts(), DrawText uses the fallback font meanwhile
+	const u32 FontIndex = (u32)g_Context->Fonts.size();
 
-		g_Context->FontLookupMap[FontName] = (u32)g_Context->Fonts.size();
-		g_Context->FontTextures.push_back(Texture);
-		g_Context->Fonts.push_back(std::move(Atlas));
-	}
+	font_resource Font;
+	Font.Name = FontName;
+	Font.LoadTimer.Start();
+
+	g_Context->FontLookupMap[FontName] = FontIndex;
+	g_Context->Fonts.push_back(eastl::move(Font));
+
+	priv::RequestFontLoad(FontIndex, FontName);
+
+	return font_handle{FontIndex};
 }
 
-void DrawText(const char32_t* Text, f32 PixelSize, f32 X, f32 Y, color FillColor)
+font_handle LoadDynamicFont(const char* FontName)
 {
-	const char32_t* Char = Text;
+	auto Iterator = g_Context->FontLookupMap.find(FontName);
+
+	if (Iterator != g_Context->FontLookupMap.end())
+	{
+		return font_handle{Iterator->second};
+	}
+
+	// Three channels per texel, @see GenerateGlyphMsdf()
+	const u64 PageSize  = (u64)k_GlyphPageWidth * k_GlyphPageHeight * FontAtlasType_MSDF;
+	const u32 PageCount = (u32)eastl::min<u64>(eastl::max<u64>(g_Context->GlyphAtlasBudget / PageSize, 1), k_MaxGlyphPageCount);
+
+	font_resource Font;
+	Font.Name    = FontName;
+	Font.Dynamic = new dynamic_font();
+
+	if (!priv::LoadDynamicFont(FontName, PageCount, Font.Dynamic, &Font.Atlas))
+	{
+		delete Font.Dynamic;
+		return GLUON_INVALID_HANDLE;
+	}
+
+	AllocateFontLayer(&Font);
+
+	// Zeroed texels are outside of any glyph, filtering at the border of a glyph never reads garbage
+	eastl::vector<u8> Texels(PageSize * PageCount, 0);
+
+	const texture_handle Texture = g_Context->FontArrays[Font.TextureArray].Texture;
+	SetTextureLayerSubData(Texture, Font.Layer, 0, 0, Font.Atlas.Width, Font.Atlas.Height, Texels.data());
 
-	f32 CursorX = X;
-	f32 CursorY = Y;
+	Font.Status = FontStatus_Ready;
 
-	const u32 FontIndex = g_Context->FontLookupMap[g_Context->CurrentFont];
+	priv::StartGlyphRasterizer();
 
-	const auto& Atlas   = g_Context->Fonts[FontIndex];
-	const auto& Metrics = Atlas.Metrics;
+	const u32 FontIndex = (u32)g_Context->Fonts.size();
 
-	const f32 Scale = PixelSize / Metrics.LineHeight;
+	g_Context->FontLookupMap[FontName] = FontIndex;
+	g_Context->Fonts.push_back(eastl::move(Font));
 
-	const f32 AtlasWidth  = (f32)Atlas.Width;
-	const f32 AtlasHeight = (f32)Atlas.Height;
+	g_Context->GlyphAtlasStats.PageCount += PageCount;
 
-	while (*Char != 0)
+	if (g_Context->FallbackFont < 0)
 	{
-		i32  Codepoint = (u32)(*Char);
-		auto Iterator  = Atlas.Glyphs.find(Codepoint);
+		g_Context->FallbackFont = (i32)FontIndex;
+	}
+
+	return font_handle{FontIndex};
+}
+
+font_handle CreateFontStack(const font_handle* Fonts, u32 FontCount)
+{
+	font_resource Font;
 
-		if (*Char == U'\n' || *Char == U'\r')
+	for (u32 Position = 0; Position < FontCount; ++Position)
+	{
+		if (!Fonts[Position].IsValid())
 		{
-			bool CheckCRLF = *Char == U'\r';
+			continue;
+		}
 
-			CursorX = X;
-			CursorY -= Metrics.LineHeight * Scale;
+		// Nested stacks are flattened
+		const font_stack& Nested = g_Context->Fonts[Fonts[Position].Idx].Stack;
 
-			if (CheckCRLF && *(Char + 1) == U'\n')
-			{
-				++Char;
-			}
+		if (Nested.Fonts.empty())
+		{
+			Font.Stack.Fonts.push_back(Fonts[Position].Idx);
 		}
-		else if (Iterator != Atlas.Glyphs.end())
+		else
 		{
-			auto Glyph = Iterator->second;
-			if (Glyph.HasGeometry)
-			{
-				const f32 Left = Glyph.PlaneBounds.Left, Right = Glyph.PlaneBounds.Right;
-				const f32 Bottom = Glyph.PlaneBounds.Bottom, Top = Glyph.PlaneBounds.Top;
+			Font.Stack.Fonts.insert(Font.Stack.Fonts.end(), Nested.Fonts.begin(), Nested.Fonts.end());
+		}
+	}
+
+	if (Font.Stack.Fonts.empty())
+	{
+		return GLUON_INVALID_HANDLE;
+	}
 
-				const f32 GlyphWidth  = Right - Left;
-				const f32 GlyphHeight = Top - Bottom;
+	if (Font.Stack.Fonts.size() > k_MaxFontStackSize)
+	{
+		LOG_F(WARNING, "Font stacks are limited to %u fonts, the last ones are ignored", k_MaxFontStackSize);
+		Font.Stack.Fonts.resize(k_MaxFontStackSize);
+	}
 
-				const f32 TexLeft = Glyph.AtlasBounds.Left, TexRight = Glyph.AtlasBounds.Right;
-				const f32 TexBottom = AtlasHeight - Glyph.AtlasBounds.Bottom, TexTop = AtlasHeight - Glyph.AtlasBounds.Top;
+	UpdateFontStack(&Font);
 
-				glyph_data WrittenGlyph;
-				WrittenGlyph.Position    = vec2(CursorX, CursorY);
-				WrittenGlyph.Scale       = vec2(GlyphWidth * 0.5f, GlyphHeight * 0.5f);
-				WrittenGlyph.Translate   = vec2(Left, Bottom + WrittenGlyph.Scale.y);
-				WrittenGlyph.Texcoords   = vec4(TexLeft / AtlasWidth, TexBottom / AtlasHeight, TexRight / AtlasWidth, TexTop / AtlasHeight);
-				WrittenGlyph.GlobalScale = Scale;
-				WrittenGlyph.TextureIndex = FontIndex;
+	const u32 FontIndex = (u32)g_Context->Fonts.size();
+	g_Context->Fonts.push_back(eastl::move(Font));
 
-				g_Context->GlyphData.push_back(WrittenGlyph);
-			}
+	return font_handle{FontIndex};
+}
+
+void SetFont(font_handle Font) { g_Context->CurrentFont = Font; }
+void SetFont(const char* FontName) { SetFont(LoadFont(FontName)); }
+
+bool IsFontReady(font_handle Font) { return Font.IsValid() && g_Context->Fonts[Font.Idx].Status == FontStatus_Ready; }
+
+void SubscribeFontReady(font_ready_callback&& Callback) { g_Context->FontReadyCallbacks.push_back(eastl::move(Callback)); }
+
+font_load_stats GetFontLoadStats() { return g_Context->FontLoadStats; }
+
+void SetGlyphAtlasBudget(u64 MemoryBudget) { g_Context->GlyphAtlasBudget = MemoryBudget; }
+
+glyph_atlas_stats GetGlyphAtlasStats()
+{
+	glyph_atlas_stats Stats = g_Context->GlyphAtlasStats;
+
+	Stats.UsedPages = 0;
+	for (const font_resource& Font : g_Context->Fonts)
+	{
+		if (Font.Dynamic != nullptr)
+		{
+			Stats.UsedPages += (u32)eastl::count_if(Font.Dynamic->Pages.begin(), Font.Dynamic->Pages.end(), [](const glyph_page& Page) {
+				return !Page.Codepoints.empty();
+			});
+		}
+	}
+
+	return Stats;
+}
+
+void SetKerningEnabled(bool Enabled) { g_Context->KerningEnabled = Enabled; }
+
+void SetGpuTextLayoutThreshold(u32 MinCodepoints)
+{
+	g_Context->GpuLayoutThreshold = MinCodepoints;
+
+	// Compiled in the background, applications which never set a threshold do not pay for it at startup
+	if (MinCodepoints > 0 && !g_Context->TextLayoutProgram.IsValid())
+	{
+		g_Context->TextLayoutProgram = LoadComputeProgram("text_layout.comp.glsl");
+	}
+}
+
+void SetTextBitmapCache(u32 AtlasSize, f32 MaxPixelSize, u32 MinFrames)
+{
+	if (g_Context->BitmapFramebuffer.IsValid())
+	{
+		DestroyFramebuffer(g_Context->BitmapFramebuffer);
+		DestroyTexture(g_Context->BitmapAtlas);
+
+		g_Context->BitmapFramebuffer = GLUON_INVALID_HANDLE;
+		g_Context->BitmapAtlas       = GLUON_INVALID_HANDLE;
+	}
+
+	// Quads drawn this frame sample the previous atlas
+	g_Context->BitmapTexts.clear();
+	g_Context->BitmapGlyphs.clear();
+	g_Context->BitmapQuads.clear();
+
+	// The Vulkan backend has no offscreen pass to rasterize the atlas with, the cache stays disabled
+	if (AtlasSize > 0 && GetBackendType() == RenderBackend_Vulkan)
+	{
+		static bool s_Warned = false;
+
+		if (!s_Warned)
+		{
+			LOG_F(WARNING, "Text bitmap cache disabled, the Vulkan backend cannot draw to textures");
+			s_Warned = true;
+		}
+
+		AtlasSize = 0;
+	}
+
+	g_Context->BitmapAtlasSize    = AtlasSize;
+	g_Context->BitmapMaxPixelSize = MaxPixelSize;
+	g_Context->BitmapMinFrames    = eastl::max(MinFrames, 1u);
+
+	if (AtlasSize == 0)
+	{
+		return;
+	}
+
+	const texture_handle     Atlas       = CreateTextureArray(AtlasSize, AtlasSize, 1, 1);
+	const framebuffer_handle Framebuffer = CreateFramebuffer(Atlas);
+
+	if (!Framebuffer.IsValid())
+	{
+		LOG_F(WARNING, "Text bitmap cache disabled, the render backend cannot draw to textures");
+		DestroyTexture(Atlas);
+		g_Context->BitmapAtlasSize = 0;
+		return;
+	}
+
+	SetTextureFiltering(Atlas, MinFilter_Nearest, MagFilter_Nearest);
+
+	g_Context->BitmapAtlas       = Atlas;
+	g_Context->BitmapFramebuffer = Framebuffer;
+
+	ResetBitmapTexts();
+}
+
+void SetTextLodThresholds(f32 GreekingPixelSize, f32 CullingPixelSize)
+{
+	g_Context->GreekingPixelSize = GreekingPixelSize;
+	g_Context->CullingPixelSize  = CullingPixelSize;
+}
+
+void SetLayoutCacheBudget(u64 MemoryBudget) { g_Context->LayoutCache.SetMemoryBudget(MemoryBudget); }
+
+layout_cache_stats GetLayoutCacheStats() { return g_Context->LayoutCache.GetStats(); }
+
+static text_object* GetTextObject(text_handle Text)
+{
+	if (!Text.IsValid() || Text.Idx >= g_Context->TextObjects.size() || !g_Context->TextObjects[Text.Idx].Alive)
+	{
+		LOG_F(ERROR, "Invalid text handle %u", Text.Idx);
+		return nullptr;
+	}
+
+	return &g_Context->TextObjects[Text.Idx];
+}
+
+text_handle CreateText()
+{
+	u32 ObjectIndex;
+
+	if (!g_Context->FreeTextObjects.empty())
+	{
+		ObjectIndex = g_Context->FreeTextObjects.back();
+		g_Context->FreeTextObjects.pop_back();
+	}
+	else
+	{
+		ObjectIndex = (u32)g_Context->TextObjects.size();
+		g_Context->TextObjects.push_back(text_object());
 
-			CursorX += (Glyph.Advance * Scale);
+		if (g_Context->TextObjectData.size() < g_Context->TextObjects.size())
+		{
+			g_Context->TextObjectData.resize(g_Context->TextObjectData.size() * 2);
 		}
+	}
+
+	text_object& Object = g_Context->TextObjects[ObjectIndex];
+	Object              = text_object();
+	Object.Font         = g_Context->CurrentFont;
+	Object.Alive        = true;
+	Object.LayoutDirty  = true;
+	Object.DataDirty    = true;
+	Object.Data         = {vec2(0.0f), 0.0f, 0.0f, color{1.0f, 1.0f, 1.0f, 1.0f}};
+
+	g_Context->TextStats.TextObjectCount += 1;
+
+	return text_handle{ObjectIndex};
+}
+
+void DestroyText(text_handle Text)
+{
+	text_object* Object = GetTextObject(Text);
+
+	if (Object == nullptr)
+	{
+		return;
+	}
+
+	ClearRetainedGlyphs(Object->GlyphOffset, Object->GlyphCapacity);
+
+	g_Context->RetainedGlyphRanges.Free(Object->GlyphOffset, Object->GlyphCapacity);
+	g_Context->DirtyGlyphs.Add(Object->GlyphOffset, Object->GlyphCapacity);
+
+	*Object = text_object();
+	g_Context->FreeTextObjects.push_back(Text.Idx);
+
+	g_Context->TextStats.TextObjectCount -= 1;
+}
+
+void SetTextString(text_handle Text, const char32_t* String)
+{
+	text_object* Object = GetTextObject(Text);
+
+	if (Object != nullptr && Object->String != String)
+	{
+		Object->String      = String;
+		Object->LayoutDirty = true;
+	}
+}
+
+void SetTextString(text_handle Text, const char* String)
+{
+	text_object* Object = GetTextObject(Text);
+
+	if (Object == nullptr)
+	{
+		return;
+	}
+
+	Object->String.clear();
+
+	utf8_decoder Decoder(String);
+
+	u32 Codepoint;
+	while (Decoder.Next(&Codepoint))
+	{
+		Object->String.push_back((char32_t)Codepoint);
+	}
+
+	Object->LayoutDirty = true;
+}
+
+void SetTextFont(text_handle Text, font_handle Font, f32 PixelSize)
+{
+	text_object* Object = GetTextObject(Text);
+
+	if (Object != nullptr)
+	{
+		Object->Font        = Font;
+		Object->PixelSize   = PixelSize;
+		Object->LayoutDirty = true;
+	}
+}
+
+void SetTextPosition(text_handle Text, f32 X, f32 Y)
+{
+	text_object* Object = GetTextObject(Text);
+
+	if (Object != nullptr)
+	{
+		Object->Data.Position = vec2(X, Y);
+		Object->DataDirty     = true;
+	}
+}
+
+void SetTextColor(text_handle Text, color FillColor)
+{
+	text_object* Object = GetTextObject(Text);
+
+	if (Object != nullptr)
+	{
+		Object->Data.FillColor = FillColor;
+		Object->DataDirty      = true;
+	}
+}
+
+void DrawText(text_handle Text)
+{
+	text_object* Object = GetTextObject(Text);
+
+	if (Object != nullptr)
+	{
+		Object->DrawnThisFrame = true;
+	}
+}
+
+text_stats GetTextStats() { return g_Context->TextStats; }
+
+culling_stats GetCullingStats() { return g_Context->CullingStats; }
+
+//! Returns the number of lines drawn
+template <typename reader_t>
+static u32 DrawText(reader_t    Reader,
+                    const void* Text,
+                    u64         Size,
+                    font_handle Font,
+                    f32         PixelSize,
+                    f32         MaxWidth,
+                    f32         X,
+                    f32         Y,
+                    color       FillColor)
+{
+	u32 FontIndex;
+
+	// Nothing to draw with until a first font is resident
+	if (!ResolveFont(Font, &FontIndex))
+	{
+		return 0;
+	}
+
+	// No line is drawn, like when there is no font yet
+	if (!MayBeVisible(vec2(X, Y), PixelSize))
+	{
+		CountCulledText(0);
+		return 0;
+	}
+
+	u32 LineCount;
+
+	if (g_Context->GpuLayoutThreshold > 0 && MaxWidth <= 0.0f && GetTextLod(PixelSize) == TextLod_Glyphs &&
+	    QueueGpuTextLayout(Reader, Size, FontIndex, PixelSize, X, Y, FillColor, &LineCount))
+	{
+		return LineCount;
+	}
+
+	layout_key         LayoutKey;
+	const shaped_text* Shaped = GetShapedText(Reader, Text, Size, FontIndex, PixelSize, &LayoutKey);
+
+	TouchGlyphPages(FontIndex, Shaped->PageMask);
+
+	BreakLines(*Shaped, MaxWidth, &g_Context->TextLines);
+
+	// Before any per glyph work, the lines give the bounds of the whole text
+	if (!IsTextVisible(g_Context->TextLines, PixelSize, vec2(X, Y)))
+	{
+		CountCulledText((u32)Shaped->Glyphs.size());
+		return (u32)g_Context->TextLines.size();
+	}
+
+	// The layout key changes with the string, the font and the size, the width changes where lines break
+	if (!DrawBitmapText(*Shaped, LayoutKey, MaxWidth, g_Context->TextLines, vec2(X, Y), FillColor))
+	{
+		DrawLaidOutText(*Shaped, g_Context->TextLines, vec2(X, Y), FillColor);
+	}
+
+	return (u32)g_Context->TextLines.size();
+}
 
-		++Char;
+template <typename reader_t>
+static text_metrics MeasureText(reader_t Reader, const void* Text, u64 Size, f32 PixelSize, f32 MaxWidth)
+{
+	text_metrics Metrics;
+
+	u32 FontIndex;
+
+	if (!ResolveFont(g_Context->CurrentFont, &FontIndex))
+	{
+		return Metrics;
+	}
+
+	// Shares the layout cache with DrawText(), measuring then drawing a text only lays it out once
+	const shaped_text* Shaped = GetShapedText(Reader, Text, Size, FontIndex, PixelSize);
+
+	BreakLines(*Shaped, MaxWidth, &g_Context->TextLines);
+
+	for (const text_line& Line : g_Context->TextLines)
+	{
+		Metrics.Width = Max(Metrics.Width, Line.Width);
+	}
+
+	Metrics.LineCount = (u32)g_Context->TextLines.size();
+	Metrics.Height    = Metrics.LineCount * Shaped->LineHeight;
+
+	return Metrics;
+}
+
+static u64 GetTextLength(const char32_t* Text)
+{
+	u64 Length = 0;
+	while (Text[Length] != 0)
+	{
+		++Length;
 	}
+
+	return Length;
+}
+
+void DrawText(const char32_t* Text, f32 PixelSize, f32 X, f32 Y, color FillColor)
+{
+	DrawText(utf32_reader{Text}, Text, GetTextLength(Text) * sizeof(char32_t), g_Context->CurrentFont, PixelSize, 0.0f, X, Y, FillColor);
+}
+
+void DrawText(const char* Text, u64 Size, f32 PixelSize, f32 X, f32 Y, color FillColor)
+{
+	DrawText(utf8_decoder(Text, Size), Text, Size, g_Context->CurrentFont, PixelSize, 0.0f, X, Y, FillColor);
+}
+
+void DrawText(const char* Text, f32 PixelSize, f32 X, f32 Y, color FillColor)
+{
+	DrawText(Text, strlen(Text), PixelSize, X, Y, FillColor);
+}
+
+void DrawTextWrapped(const char32_t* Text, f32 PixelSize, f32 MaxWidth, f32 X, f32 Y, color FillColor)
+{
+	const u64 Size = GetTextLength(Text) * sizeof(char32_t);
+	DrawText(utf32_reader{Text}, Text, Size, g_Context->CurrentFont, PixelSize, MaxWidth, X, Y, FillColor);
+}
+
+void DrawTextWrapped(const char* Text, f32 PixelSize, f32 MaxWidth, f32 X, f32 Y, color FillColor)
+{
+	DrawText(utf8_decoder(Text), Text, strlen(Text), g_Context->CurrentFont, PixelSize, MaxWidth, X, Y, FillColor);
+}
+
+text_metrics MeasureText(const char32_t* Text, f32 PixelSize, f32 MaxWidth)
+{
+	return MeasureText(utf32_reader{Text}, Text, GetTextLength(Text) * sizeof(char32_t), PixelSize, MaxWidth);
 }
 
+text_metrics MeasureText(const char* Text, f32 PixelSize, f32 MaxWidth)
+{
+	return MeasureText(utf8_decoder(Text), Text, strlen(Text), PixelSize, MaxWidth);
+}
+
+namespace priv
+{
+	u32 DrawTextLine(const char* Text, u64 Size, font_handle Font, f32 PixelSize, f32 MaxWidth, f32 X, f32 Y, color FillColor)
+	{
+		u32 FontIndex;
+
+		if (!ResolveFont(Font, &FontIndex))
+		{
+			return 0;
+		}
+
+		const font_metrics& Metrics  = g_Context->Fonts[FontIndex].Atlas.Metrics;
+		const f32           Baseline = Y - Metrics.Ascender * PixelSize / Metrics.LineHeight;
+
+		return DrawText(utf8_decoder(Text, Size), Text, Size, Font, PixelSize, MaxWidth, X, Baseline, FillColor);
+	}
+
+	bool ResolveTextFont(font_handle Font, u32* FontIndex) { return ResolveFont(Font, FontIndex); }
+
+	u32 GetFontGeneration(u32 FontIndex) { return GetLayoutGeneration(FontIndex); }
+
+	void ShapeParagraph(const char32_t* Text, u32 FontIndex, f32 PixelSize, shaped_text* Shaped)
+	{
+		Shaped->Clear();
+		ShapeText(utf32_reader{Text}, FontIndex, PixelSize, Shaped);
+	}
+
+	u32 DrawShapedText(const shaped_text& Text, u32 FontIndex, f32 MaxWidth, f32 X, f32 Y, color FillColor)
+	{
+		const font_metrics& Metrics  = g_Context->Fonts[FontIndex].Atlas.Metrics;
+		const f32           Baseline = Y - Metrics.Ascender * Text.LineHeight / Metrics.LineHeight;
+
+		TouchGlyphPages(FontIndex, Text.PageMask);
+
+		BreakLines(Text, MaxWidth, &g_Context->TextLines);
+
+		if (!IsTextVisible(g_Context->TextLines, Text.LineHeight, vec2(X, Baseline)))
+		{
+			CountCulledText((u32)Text.Glyphs.size());
+			return (u32)g_Context->TextLines.size();
+		}
+
+		DrawLaidOutText(Text, g_Context->TextLines, vec2(X, Baseline), FillColor);
+
+		return (u32)g_Context->TextLines.size();
+	}
+}
 }
@@ -4,6 +4,10 @@
 
 #include <gluon/core/gln_color.h>
 
+#include <gluon/render_backend/gln_renderbackend.h>
+
+#include <EASTL/functional.h>
+
 namespace gluon
 {
 
@@ -20,6 +24,152 @@ GLUON_API_EXPORT void DrawRectangle(f32   X,
                                     f32   BorderWidth = 0.0f,
                                     color BorderColor = {0.0f, 0.0f, 0.0f, 1.0f});
 
-GLUON_API_EXPORT void SetFont(const char* FontName);
+struct culling_stats
+{
+	u32 CulledRectangles = 0; // Instances outside of the viewport which were not streamed during the last frame
+	u32 CulledTexts      = 0; // DrawText() strings, rejected from their origin before being laid out when possible
+	u32 CulledGlyphs     = 0; // Glyph instances of the culled texts which had been laid out
+	u64 SavedBytes       = 0; // Instance data they would have streamed
+};
+
+//! DrawRectangle() and DrawText() drop what does not overlap the viewport as they are called, one item at a time. Texts are tested
+//! as a whole from their bounds, partly visible texts keep all their glyphs. There is no clip rectangle, only the viewport is tested,
+//! and retained texts are never culled.
+GLUON_API_EXPORT culling_stats GetCullingStats();
+
+struct font_load_stats
+{
+	u32 LoadedFonts   = 0;
+	f64 LastLoadTime  = 0.0; // In seconds, from the first SetFont() call to the texture being resident
+	f64 MaxLoadTime   = 0.0;
+	f64 TotalLoadTime = 0.0;
+};
+
+GLUON_HANDLE(font_handle);
+
+using font_ready_callback = eastl::function<void(font_handle Font, const char* FontName)>;
+
+//! Fonts are loaded in the background on first use. Until then, DrawText() uses the first font that was loaded, or draws nothing.
+//! Loading a font again returns the same handle.
+GLUON_API_EXPORT font_handle LoadFont(const char* FontName);
+GLUON_API_EXPORT void        SetFont(font_handle Font);
+GLUON_API_EXPORT void        SetFont(const char* FontName);
+GLUON_API_EXPORT bool        IsFontReady(font_handle Font);
+GLUON_API_EXPORT void SubscribeFontReady(font_ready_callback&& Callback);
+
+//! Font stacks are used like fonts. Each codepoint is drawn with the first font of the stack having it, the line metrics are the
+//! ones of the first font which is ready. Resolutions are cached per stack, so mixing scripts only costs a lookup per codepoint.
+GLUON_API_EXPORT font_handle CreateFontStack(const font_handle* Fonts, u32 FontCount);
+
+GLUON_API_EXPORT font_load_stats GetFontLoadStats();
+
+struct glyph_atlas_stats
+{
+	u32 ResidentGlyphs   = 0;
+	u32 PendingGlyphs    = 0; // Queued for rasterization, laid out but not drawn yet
+	u32 FailedGlyphs     = 0; // Did not fit while every page was drawn, not drawn until a page is recycled
+	u32 RasterizedGlyphs = 0; // Uploaded during the last frame
+	u32 EvictedPages     = 0;
+	u32 UsedPages        = 0;
+	u32 PageCount        = 0;
+};
+
+//! Dynamic fonts are read from resources/fonts/<FontName>.ttf and are ready as soon as the call returns. Glyphs are generated as
+//! multi-channel signed distance fields on worker threads the first time they are laid out, they appear a few frames later. The
+//! atlas is split in pages, the least recently drawn one is recycled when it is full. Kerning is read from the font.
+GLUON_API_EXPORT font_handle LoadDynamicFont(const char* FontName);
+
+//! Texture memory of the atlas of each dynamic font, only applies to fonts loaded afterwards
+GLUON_API_EXPORT void              SetGlyphAtlasBudget(u64 MemoryBudget);
+GLUON_API_EXPORT glyph_atlas_stats GetGlyphAtlasStats();
+
+struct layout_cache_stats
+{
+	u32 Hits       = 0;
+	u32 Misses     = 0;
+	u32 Evictions  = 0;
+	u32 EntryCount = 0;
+	u64 MemoryUsed = 0;
+};
+
+//! DrawText() memoizes layouts per text, font and size, so that redrawing the same strings only costs a translation. This includes
+//! the shaping of combining marks and of the Thai and Lao scripts.
+GLUON_API_EXPORT void               SetLayoutCacheBudget(u64 MemoryBudget);
+GLUON_API_EXPORT layout_cache_stats GetLayoutCacheStats();
+
+//! Kerning from the font atlas is applied by DrawText(), enabled by default
+GLUON_API_EXPORT void SetKerningEnabled(bool Enabled);
+
+//! DrawText() strings of at least MinCodepoints codepoints are laid out by a compute shader, the CPU only maps them to glyph ids.
+//! This only applies to unwrapped texts drawn with a pre-baked font and without complex scripts, others are laid out on the CPU.
+//! These texts bypass the layout cache. 0 disables it, which is the default, @see text_stats
+//! The first non zero threshold compiles the layout shader in the background, texts are laid out on the CPU until it is ready.
+GLUON_API_EXPORT void SetGpuTextLayoutThreshold(u32 MinCodepoints);
+
+//! Texts whose pixel size is below GreekingPixelSize are drawn as a bar per line instead of their glyphs, texts below
+//! CullingPixelSize are not drawn at all. This applies to immediate and retained texts, which keep their layout and line count.
+//! Bars are rectangles, they are drawn under the texts. Both thresholds are 0 by default, which disables it, @see text_stats
+GLUON_API_EXPORT void SetTextLodThresholds(f32 GreekingPixelSize, f32 CullingPixelSize);
+
+//! DrawText() strings of at most MaxPixelSize pixels drawn MinFrames frames in a row are rasterized once in a coverage atlas of
+//! AtlasSize texels, then drawn as a single quad without distance field shading. The string, font, size and wrapping width identify
+//! a cached text, its color and position can change. Cached texts are snapped to whole pixels and drawn after the other texts.
+//! The atlas is reset once it is full. 0 disables it, which is the default. The Vulkan backend cannot draw to textures, the cache
+//! stays disabled with it and a warning is logged the first time, @see text_stats
+GLUON_API_EXPORT void SetTextBitmapCache(u32 AtlasSize, f32 MaxPixelSize = 24.0f, u32 MinFrames = 4);
+
 GLUON_API_EXPORT void DrawText(const char32_t* Text, f32 PixelSize, f32 X, f32 Y, color FillColor);
+
+//! UTF-8 texts are decoded on the fly, malformed sequences are drawn as U+FFFD
+GLUON_API_EXPORT void DrawText(const char* Text, f32 PixelSize, f32 X, f32 Y, color FillColor);
+GLUON_API_EXPORT void DrawText(const char* Text, u64 Size, f32 PixelSize, f32 X, f32 Y, color FillColor);
+
+struct text_metrics
+{
+	f32 Width     = 0.0f;
+	f32 Height    = 0.0f;
+	u32 LineCount = 0;
+};
+
+//! Lines are broken on spaces to fit in MaxWidth, words wider than MaxWidth overflow. MaxWidth <= 0 only breaks at line feeds.
+//! Measuring and drawing the same text share the layout, and wrapping it at another width does not lay it out again.
+GLUON_API_EXPORT text_metrics MeasureText(const char32_t* Text, f32 PixelSize, f32 MaxWidth = 0.0f);
+GLUON_API_EXPORT text_metrics MeasureText(const char* Text, f32 PixelSize, f32 MaxWidth = 0.0f);
+GLUON_API_EXPORT void         DrawTextWrapped(const char32_t* Text, f32 PixelSize, f32 MaxWidth, f32 X, f32 Y, color FillColor);
+GLUON_API_EXPORT void         DrawTextWrapped(const char* Text, f32 PixelSize, f32 MaxWidth, f32 X, f32 Y, color FillColor);
+
+GLUON_HANDLE(text_handle);
+
+//! Retained texts keep their glyphs in a GPU buffer across frames. Moving, recoloring or hiding one only updates a small per
+//! object record, the glyphs are uploaded again when the string or the font changes.
+GLUON_API_EXPORT text_handle CreateText();
+GLUON_API_EXPORT void        DestroyText(text_handle Text);
+GLUON_API_EXPORT void        SetTextString(text_handle Text, const char32_t* String);
+GLUON_API_EXPORT void        SetTextString(text_handle Text, const char* String);
+GLUON_API_EXPORT void        SetTextFont(text_handle Text, font_handle Font, f32 PixelSize);
+GLUON_API_EXPORT void        SetTextPosition(text_handle Text, f32 X, f32 Y);
+GLUON_API_EXPORT void        SetTextColor(text_handle Text, color FillColor);
+
+//! Retained texts are only visible on frames where they are drawn
+GLUON_API_EXPORT void DrawText(text_handle Text);
+
+struct text_stats
+{
+	u64 ImmediateBytes  = 0; // Glyph data streamed for DrawText() strings during the last frame
+	u64 RetainedBytes   = 0; // Glyph and object data uploaded for retained texts during the last frame
+	u32 TextObjectCount = 0;
+
+	u32 GpuLaidOutTexts  = 0; // DrawText() strings laid out by the GPU during the last frame, @see SetGpuTextLayoutThreshold()
+	u32 GpuLaidOutGlyphs = 0;
+	u64 GpuLayoutBytes   = 0; // Glyph ids, runs and atlas table data uploaded for them
+
+	u32 GreekedTexts  = 0; // Texts drawn as bars during the last frame, @see SetTextLodThresholds()
+	u32 CulledTexts   = 0;
+	u32 AvoidedGlyphs = 0; // Glyph instances the greeked and culled texts would have drawn
+
+	u32 BitmapTexts           = 0; // Texts drawn from the bitmap cache during the last frame, @see SetTextBitmapCache()
+	u32 RasterizedBitmapTexts = 0; // Texts that entered it
+};
+
+GLUON_API_EXPORT text_stats GetTextStats();
 }
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <gluon/api/gln_renderer.h>
+
 #include <gluon/core/gln_defines.h>
 
 namespace gluon
 {
+struct shaped_text;
+
 namespace priv
 {
 	void CreateRenderingContext();
@@ -13,5 +17,18 @@ namespace priv
 	void SetTextScale(f32 ScaleX, f32 ScaleY);
 
 	void Flush();
+
+	//! Programs compile while the first frames are drawn, this is true once a frame has been drawn with all of them
+	bool IsFirstFrameRendered();
+
+	//! Draws an UTF-8 line with a given font, Y being the top of the line instead of its baseline. Returns the number of lines after
+	//! wrapping, or 0 when there is no font to draw with.
+	u32 DrawTextLine(const char* Text, u64 Size, font_handle Font, f32 PixelSize, f32 MaxWidth, f32 X, f32 Y, color FillColor);
+
+	//! For texts which keep their own layouts, @see text_buffer. The font index changes once the font replaces the fallback one.
+	bool ResolveTextFont(font_handle Font, u32* FontIndex);
+	u32  GetFontGeneration(u32 FontIndex); // Layouts made with an older generation miss glyphs of dynamic fonts or stacks
+	void ShapeParagraph(const char32_t* Text, u32 FontIndex, f32 PixelSize, shaped_text* Shaped);
+	u32  DrawShapedText(const shaped_text& Text, u32 FontIndex, f32 MaxWidth, f32 X, f32 Y, color FillColor);
 }
 }
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <gluon/core/gln_defines.h>
+
+#include <EASTL/algorithm.h>
+#include <EASTL/vector.h>
+
+/// This is a private header, it should not be included outside of the gluon api files.
+namespace gluon
+{
+//! Number of rows of each line in a Fenwick tree, so that the row offset of a line and the line at a given row are both found in
+//! O(log n), and updating the height of a line once it has been wrapped is O(log n) as well. The text buffer uses it for the sums of
+//! its paragraph and piece chunks.
+class row_index
+{
+public:
+	//! Every line starts with a single row, built in O(n)
+	void Reset(u32 LineCount)
+	{
+		m_Tree.resize(LineCount + 1);
+		m_Tree[0] = 0;
+
+		// Node i covers the lowbit(i) lines ending at line i
+		for (u32 Node = 1; Node <= LineCount; ++Node)
+		{
+			m_Tree[Node] = Node & (~Node + 1);
+		}
+
+		m_Total = LineCount;
+	}
+
+	void Append(u32 Rows)
+	{
+		const u32 Node = (u32)m_Tree.size();
+
+		m_Tree.push_back(Rows + GetRowOffset(Node - 1) - GetRowOffset(Node - (Node & (~Node + 1))));
+		m_Total += Rows;
+	}
+
+	void Add(u32 Line, i32 Delta)
+	{
+		for (u32 Node = Line + 1; Node < (u32)m_Tree.size(); Node += Node & (~Node + 1))
+		{
+			m_Tree[Node] += Delta;
+		}
+
+		m_Total += Delta;
+	}
+
+	//! Rows before Line
+	u64 GetRowOffset(u32 Line) const
+	{
+		u64 Offset = 0;
+
+		for (u32 Node = Line; Node > 0; Node &= Node - 1)
+		{
+			Offset += m_Tree[Node];
+		}
+
+		return Offset;
+	}
+
+	u32 GetRowCount(u32 Line) const { return (u32)(GetRowOffset(Line + 1) - GetRowOffset(Line)); }
+
+	//! Line covering Row, the last line when Row is past the end
+	u32 FindLine(u64 Row) const
+	{
+		const u32 LineCount = GetLineCount();
+
+		u32 Line = 0;
+		u32 Step = 1;
+
+		while (Step * 2 <= LineCount)
+		{
+			Step *= 2;
+		}
+
+		// Largest Line with GetRowOffset(Line) <= Row
+		for (; Step > 0; Step /= 2)
+		{
+			if (Line + Step <= LineCount && m_Tree[Line + Step] <= Row)
+			{
+				Line += Step;
+				Row -= m_Tree[Line];
+			}
+		}
+
+		return eastl::min(Line, LineCount > 0 ? LineCount - 1 : 0);
+	}
+
+	u32 GetLineCount() const { return m_Tree.empty() ? 0 : (u32)m_Tree.size() - 1; }
+	u64 GetTotalRows() const { return m_Total; }
+
+private:
+	eastl::vector<u32> m_Tree;
+	u64                m_Total = 0;
+};
+}
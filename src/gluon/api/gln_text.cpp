@@ -1,4 +1,9 @@
 #include "gln_text.h"
+#include "gln_font_file.h"
+
+#include <gluon/core/gln_embedded.h>
+
+#include <gln_embedded_fonts.h>
 
 #include <stb_image.h>
 
@@ -6,64 +11,294 @@
 
 #include <loguru.hpp>
 
+#include <EASTL/vector.h>
+#include <EASTL/sort.h>
+
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 namespace gluon
 {
 
-font_atlas LoadFontAtlas(const char* FontName)
+glyph_table::glyph_table()
 {
-	font_atlas Atlas;
+	for (u32& GlyphIndex : m_DirectIndices)
+	{
+		GlyphIndex = k_InvalidGlyph;
+	}
+}
+
+void glyph_table::Reserve(u32 GlyphCount)
+{
+	m_Glyphs.reserve(GlyphCount);
+	m_Codepoints.reserve(GlyphCount);
+}
+
+u32* glyph_table::GetSlot(u32 Codepoint)
+{
+	if (Codepoint < k_DirectCount)
+	{
+		return &m_DirectIndices[Codepoint];
+	}
+
+	if (m_PageIndices.empty())
+	{
+		m_PageIndices.resize((k_MaxCodepoint >> k_PageBits) + 1, 0);
+	}
+
+	u16& PageIndex = m_PageIndices[Codepoint >> k_PageBits];
+
+	if (PageIndex == 0)
+	{
+		eastl::array<u32, k_PageSize> Page;
+		Page.fill(k_InvalidGlyph);
+
+		m_Pages.push_back(Page);
+		PageIndex = (u16)m_Pages.size();
+	}
+
+	return &m_Pages[PageIndex - 1][Codepoint & (k_PageSize - 1)];
+}
+
+void glyph_table::Insert(u32 Codepoint, const glyph& Glyph)
+{
+	if (Codepoint > k_MaxCodepoint)
+	{
+		return;
+	}
+
+	u32* Slot = GetSlot(Codepoint);
+
+	// Duplicates replace the previous glyph
+	if (*Slot != k_InvalidGlyph)
+	{
+		m_Glyphs[*Slot] = Glyph;
+		return;
+	}
+
+	*Slot = (u32)m_Glyphs.size();
+	m_Glyphs.push_back(Glyph);
+	m_Codepoints.push_back(Codepoint);
+}
+
+glyph* glyph_table::Append(u32 Codepoint)
+{
+	GLN_ASSERT(Codepoint <= k_MaxCodepoint && (m_Codepoints.empty() || Codepoint > m_Codepoints.back()));
+
+	*GetSlot(Codepoint) = (u32)m_Glyphs.size();
+	m_Codepoints.push_back(Codepoint);
+	m_Glyphs.push_back({});
+
+	return &m_Glyphs.back();
+}
+
+void kerning_table::Build(eastl::vector<kerning_pair>&& Pairs, glyph_table* Glyphs)
+{
+	m_ReferencedPairs = nullptr;
+	m_ReferencedCount = 0;
+
+	eastl::sort(Pairs.begin(), Pairs.end(), [](const kerning_pair& A, const kerning_pair& B) {
+		return A.Left != B.Left ? A.Left < B.Left : A.Right < B.Right;
+	});
+
+	m_Pairs.clear();
+	m_Pairs.reserve(Pairs.size());
+
+	for (u32 PairIndex = 0; PairIndex < (u32)Pairs.size();)
+	{
+		const u32 Left = Pairs[PairIndex].Left;
+
+		u32 RangeEnd = PairIndex;
+		while (RangeEnd < (u32)Pairs.size() && Pairs[RangeEnd].Left == Left)
+		{
+			++RangeEnd;
+		}
+
+		if (glyph* Glyph = Glyphs->Find(Left))
+		{
+			Glyph->KerningBegin = (u32)m_Pairs.size();
+			Glyph->KerningCount = RangeEnd - PairIndex;
+
+			m_Pairs.insert(m_Pairs.end(), Pairs.begin() + PairIndex, Pairs.begin() + RangeEnd);
+		}
+
+		PairIndex = RangeEnd;
+	}
+}
+
+bool kerning_table::Reference(const kerning_pair* Pairs, u32 PairCount, glyph_table* Glyphs)
+{
+	for (u32 PairIndex = 1; PairIndex < PairCount; ++PairIndex)
+	{
+		const kerning_pair& Previous = Pairs[PairIndex - 1];
+		const kerning_pair& Pair     = Pairs[PairIndex];
+
+		if (Pair.Left < Previous.Left || (Pair.Left == Previous.Left && Pair.Right < Previous.Right))
+		{
+			return false;
+		}
+	}
+
+	m_Pairs.clear();
+	m_ReferencedPairs = Pairs;
+	m_ReferencedCount = PairCount;
+
+	// Pairs of a missing left glyph stay in the table, no range points to them
+	for (u32 PairIndex = 0; PairIndex < PairCount;)
+	{
+		const u32 Left = Pairs[PairIndex].Left;
+
+		u32 RangeEnd = PairIndex;
+		while (RangeEnd < PairCount && Pairs[RangeEnd].Left == Left)
+		{
+			++RangeEnd;
+		}
+
+		if (glyph* Glyph = Glyphs->Find(Left))
+		{
+			Glyph->KerningBegin = PairIndex;
+			Glyph->KerningCount = RangeEnd - PairIndex;
+		}
+
+		PairIndex = RangeEnd;
+	}
+
+	return true;
+}
+
+static bool ReadFile(const char* FileName, eastl::vector<u8>* Content)
+{
+	FILE* File = fopen(FileName, "rb");
+
+	if (File == nullptr)
+	{
+		LOG_F(ERROR, "Cannot find or open %s", FileName);
+		return false;
+	}
 
+	fseek(File, 0, SEEK_END);
+	u64 FileSize = ftell(File);
+	rewind(File);
+
+	// Null terminated, so that json files can be handed to rapidjson as is
+	Content->resize(FileSize + 1);
+	size_t Read      = fread(Content->data(), 1, FileSize, File);
+	(*Content)[Read] = '\0';
+	Content->resize(Read + 1);
+
+	fclose(File);
+
+	return true;
+}
+
+font_atlas LoadFontAtlas(const char* FontName)
+{
 	// Assume FontName.png / FontName.json
 	char FontAtlas[256] = {};
 	char FontData[256]  = {};
 
-	strcat(FontAtlas, "resources/fonts/");
 	strcat(FontAtlas, FontName);
 	strcat(FontAtlas, ".png");
 
-	strcat(FontData, "resources/fonts/");
 	strcat(FontData, FontName);
 	strcat(FontData, ".json");
 
-	// Load png
-	i32 Channels;
-	// stbi_set_flip_vertically_on_load(true);
-	u8* Data = stbi_load(FontAtlas, &Atlas.Width, &Atlas.Height, &Channels, 3);
+	// Fonts compiled into the library do not touch the disk, see GLUON_EMBEDDED_FONTS
+	const embedded_file* EmbeddedAtlas = FindEmbeddedFile(embedded_fonts::k_Files, FontAtlas);
+	const embedded_file* EmbeddedData  = FindEmbeddedFile(embedded_fonts::k_Files, FontData);
 
-	if (Data == nullptr)
+	if (EmbeddedAtlas != nullptr && EmbeddedData != nullptr)
 	{
-		LOG_F(ERROR, "Cannot find or open %s", FontAtlas);
-		return Atlas;
+		return LoadFontAtlasFromMemory(EmbeddedAtlas->Data, EmbeddedAtlas->Size, (const char*)EmbeddedData->Data);
 	}
 
-	u32 TotalSize = Atlas.Width * Atlas.Height * Channels;
-	Atlas.Data    = (u8*)malloc(TotalSize);
-	memcpy(Atlas.Data, Data, TotalSize);
-
-	stbi_image_free(Data);
+	char FontBinaryPath[256] = "resources/fonts/";
+	char FontAtlasPath[256]  = "resources/fonts/";
+	char FontDataPath[256]   = "resources/fonts/";
 
-	FILE* JsonFile = fopen(FontData, "r");
+	strcat(FontBinaryPath, FontName);
+	strcat(FontBinaryPath, ".glnfont");
+	strcat(FontAtlasPath, FontAtlas);
+	strcat(FontDataPath, FontData);
 
-	if (JsonFile == nullptr)
+	// Converted atlases are used straight from the mapping, without any decoding, see tools/font_converter
+	mapped_file File;
+	if (MapFile(FontBinaryPath, &File))
 	{
-		LOG_F(ERROR, "Cannot find or open %s", FontData);
-		return Atlas;
+		font_atlas Atlas = LoadFontAtlasFromBinary(File.Data, File.Size);
+
+		if (Atlas.Data != nullptr)
+		{
+			Atlas.File = File;
+			return Atlas;
+		}
+
+		LOG_F(WARNING, "%s is not a valid font file, falling back to %s", FontBinaryPath, FontDataPath);
+		UnmapFile(&File);
 	}
 
-	fseek(JsonFile, SEEK_SET, SEEK_END);
-	u32 FileSize = ftell(JsonFile);
-	rewind(JsonFile);
+	eastl::vector<u8> AtlasContent, DataContent;
 
-	char*  Buffer = (char*)malloc(FileSize + 1);
-	size_t Read   = fread(Buffer, 1, FileSize, JsonFile);
-	Buffer[Read]  = '\0';
+	if (!ReadFile(FontAtlasPath, &AtlasContent) || !ReadFile(FontDataPath, &DataContent))
+	{
+		return font_atlas();
+	}
 
-	fclose(JsonFile);
+	return LoadFontAtlasFromMemory(AtlasContent.data(), AtlasContent.size() - 1, (const char*)DataContent.data());
+}
+
+font_atlas LoadFontAtlasFromMemory(const u8* AtlasData, u64 AtlasSize, const char* JsonData)
+{
+	font_atlas Atlas;
 
 	rapidjson::Document Document;
-	Document.Parse(Buffer);
+	Document.Parse(JsonData);
+
+	// The atlas type decides how many channels are kept from the png
+	if (Document.IsObject() && Document.HasMember("atlas") && Document["atlas"].IsObject())
+	{
+		const auto& AtlasInfo = Document["atlas"].GetObject();
+
+		if (AtlasInfo.HasMember("type") && AtlasInfo["type"].IsString())
+		{
+			const char* Type = AtlasInfo["type"].GetString();
+
+			if (strcmp(Type, "sdf") == 0 || strcmp(Type, "psdf") == 0)
+			{
+				Atlas.Type = FontAtlasType_SDF;
+			}
+			else if (strcmp(Type, "mtsdf") == 0)
+			{
+				Atlas.Type = FontAtlasType_MTSDF;
+			}
+			else if (strcmp(Type, "msdf") != 0)
+			{
+				LOG_F(WARNING, "Unsupported font atlas type %s, reading it as a msdf", Type);
+			}
+		}
+
+		if (AtlasInfo.HasMember("distanceRange"))
+		{
+			Atlas.DistanceRange = AtlasInfo["distanceRange"].GetFloat();
+		}
+	}
+
+	// Load png
+	i32 Channels;
+	// stbi_set_flip_vertically_on_load(true);
+	u8* Data = stbi_load_from_memory(AtlasData, (i32)AtlasSize, &Atlas.Width, &Atlas.Height, &Channels, (i32)Atlas.Type);
+
+	if (Data == nullptr)
+	{
+		LOG_F(ERROR, "Cannot decode font atlas: %s", stbi_failure_reason());
+		return Atlas;
+	}
+
+	// Freed by ReleaseFontAtlasTexels()
+	Atlas.Data     = Data;
+	Atlas.OwnsData = true;
 
 	if (Document.IsObject())
 	{
@@ -92,6 +327,8 @@ font_atlas LoadFontAtlas(const char* FontName)
 		{
 			const auto& Glyphs = Document["glyphs"].GetArray();
 
+			Atlas.Glyphs.Reserve(Glyphs.Size());
+
 			for (const auto& Glyph : Glyphs)
 			{
 				if (!Glyph.HasMember("unicode") || !Glyph.HasMember("advance"))
@@ -99,17 +336,22 @@ font_atlas LoadFontAtlas(const char* FontName)
 					continue;
 				}
 
-				glyph GlyphInfo;
-				GlyphInfo.Unicode = Glyph["unicode"].GetUint();
+				const u32 Unicode = Glyph["unicode"].GetUint();
+
+				glyph GlyphInfo   = {};
 				GlyphInfo.Advance = Glyph["advance"].GetFloat();
 
 				if (Glyph.HasMember("planeBounds") && Glyph.HasMember("atlasBounds"))
 				{
+					const f32 AtlasWidth  = (f32)Atlas.Width;
+					const f32 AtlasHeight = (f32)Atlas.Height;
+
+					// Atlas bounds are given in texels, from the bottom of the atlas
 					GlyphInfo.HasGeometry        = true;
-					GlyphInfo.AtlasBounds.Left   = Glyph["atlasBounds"]["left"].GetFloat();
-					GlyphInfo.AtlasBounds.Bottom = Glyph["atlasBounds"]["bottom"].GetFloat();
-					GlyphInfo.AtlasBounds.Right  = Glyph["atlasBounds"]["right"].GetFloat();
-					GlyphInfo.AtlasBounds.Top    = Glyph["atlasBounds"]["top"].GetFloat();
+					GlyphInfo.Texcoords.Left     = Glyph["atlasBounds"]["left"].GetFloat() / AtlasWidth;
+					GlyphInfo.Texcoords.Bottom   = 1.0f - Glyph["atlasBounds"]["bottom"].GetFloat() / AtlasHeight;
+					GlyphInfo.Texcoords.Right    = Glyph["atlasBounds"]["right"].GetFloat() / AtlasWidth;
+					GlyphInfo.Texcoords.Top      = 1.0f - Glyph["atlasBounds"]["top"].GetFloat() / AtlasHeight;
 					GlyphInfo.PlaneBounds.Left   = Glyph["planeBounds"]["left"].GetFloat();
 					GlyphInfo.PlaneBounds.Bottom = Glyph["planeBounds"]["bottom"].GetFloat();
 					GlyphInfo.PlaneBounds.Right  = Glyph["planeBounds"]["right"].GetFloat();
@@ -121,7 +363,7 @@ font_atlas LoadFontAtlas(const char* FontName)
 					GlyphInfo.HasGeometry = false;
 				}
 
-				Atlas.Glyphs[GlyphInfo.Unicode] = GlyphInfo;
+				Atlas.Glyphs.Insert(Unicode, GlyphInfo);
 
 				// LOG_F(INFO, "Glyph: %d %c", Glyph["unicode"].GetUint(), Glyph["unicode"].GetUint());
 			}
@@ -131,21 +373,238 @@ font_atlas LoadFontAtlas(const char* FontName)
 		{
 			const auto& Kernings = Document["kerning"].GetArray();
 
+			eastl::vector<kerning_pair> Pairs;
+			Pairs.reserve(Kernings.Size());
+
 			for (const auto& Kerning : Kernings)
 			{
 				if (Kerning.HasMember("unicode1") && Kerning.HasMember("unicode2") && Kerning.HasMember("advance"))
 				{
-					const i32 Unicode1                      = Kerning["unicode1"].GetInt();
-					const i32 Unicode2                      = Kerning["unicode2"].GetInt();
-					const f32 Advance                       = Kerning["advance"].GetFloat();
-					Atlas.GlyphKernings[Unicode1][Unicode2] = Advance;
+					Pairs.push_back({Kerning["unicode1"].GetUint(), Kerning["unicode2"].GetUint(), Kerning["advance"].GetFloat()});
 				}
 			}
+
+			Atlas.Kernings.Build(eastl::move(Pairs), &Atlas.Glyphs);
+		}
+	}
+
+	return Atlas;
+}
+
+static_assert(sizeof(kerning_pair) == sizeof(font_file_kerning) && offsetof(kerning_pair, Right) == offsetof(font_file_kerning, Unicode2) &&
+                  offsetof(kerning_pair, Advance) == offsetof(font_file_kerning, Advance),
+              "Kerning pairs are read in place from font files");
+
+font_atlas LoadFontAtlasFromBinary(const u8* Data, u64 Size)
+{
+	font_atlas Atlas;
+
+	// Sections are cast in place
+	if (((uintptr_t)Data & (k_FontFileAlignment - 1)) != 0)
+	{
+		LOG_F(ERROR, "Font file data is not aligned on %u bytes", (u32)k_FontFileAlignment);
+		return Atlas;
+	}
+
+	if (Size < sizeof(font_file_header))
+	{
+		LOG_F(ERROR, "Font file is too small");
+		return Atlas;
+	}
+
+	const font_file_header* Header = (const font_file_header*)Data;
+
+	if (Header->Magic != k_FontFileMagic || Header->Version != k_FontFileVersion)
+	{
+		LOG_F(ERROR, "Unsupported font file version %u", Header->Version);
+		return Atlas;
+	}
+
+	const u64 GlyphEnd   = Header->GlyphOffset + (u64)Header->GlyphCount * sizeof(font_file_glyph);
+	const u64 KerningEnd = Header->KerningOffset + (u64)Header->KerningCount * sizeof(font_file_kerning);
+	const u64 TexelEnd   = Header->TexelOffset + Header->TexelSize;
+	const u64 TexelSize  = (u64)Header->Width * Header->Height * Header->ComponentCount;
+
+	const bool ValidType = Header->ComponentCount == FontAtlasType_SDF || Header->ComponentCount == FontAtlasType_MSDF ||
+	                       Header->ComponentCount == FontAtlasType_MTSDF;
+
+	const bool Aligned = (Header->GlyphOffset & (k_FontFileAlignment - 1)) == 0 && (Header->KerningOffset & (k_FontFileAlignment - 1)) == 0;
+
+	if (GlyphEnd > Size || KerningEnd > Size || TexelEnd > Size || Header->TexelSize != TexelSize || !ValidType || !Aligned)
+	{
+		LOG_F(ERROR, "Font file is truncated or corrupted");
+		return Atlas;
+	}
+
+	Atlas.Type          = (font_atlas_type)Header->ComponentCount;
+	Atlas.DistanceRange = Header->DistanceRange;
+
+	Atlas.Metrics.LineHeight         = Header->LineHeight;
+	Atlas.Metrics.Ascender           = Header->Ascender;
+	Atlas.Metrics.Descender          = Header->Descender;
+	Atlas.Metrics.UnderlineY         = Header->UnderlineY;
+	Atlas.Metrics.UnderlineThickness = Header->UnderlineThickness;
+
+	const font_file_glyph* Glyphs   = (const font_file_glyph*)(Data + Header->GlyphOffset);
+	const kerning_pair*    Kernings = (const kerning_pair*)(Data + Header->KerningOffset);
+
+	// Glyphs are sorted by the converter, which fills the lookup pages in order
+	for (u32 GlyphIndex = 0; GlyphIndex < Header->GlyphCount; ++GlyphIndex)
+	{
+		const u32 Unicode = Glyphs[GlyphIndex].Unicode;
+
+		if (Unicode > glyph_table::k_MaxCodepoint || (GlyphIndex > 0 && Unicode <= Glyphs[GlyphIndex - 1].Unicode))
+		{
+			LOG_F(ERROR, "Font file glyphs are not sorted");
+			return Atlas;
 		}
 	}
 
-	free(Buffer);
+	Atlas.Glyphs.Reserve(Header->GlyphCount);
+
+	for (u32 GlyphIndex = 0; GlyphIndex < Header->GlyphCount; ++GlyphIndex)
+	{
+		const font_file_glyph& Glyph = Glyphs[GlyphIndex];
+
+		glyph& GlyphInfo             = *Atlas.Glyphs.Append(Glyph.Unicode);
+		GlyphInfo                    = {};
+		GlyphInfo.Advance            = Glyph.Advance;
+		GlyphInfo.HasGeometry        = Glyph.HasGeometry != 0;
+		GlyphInfo.PlaneBounds.Left   = Glyph.PlaneLeft;
+		GlyphInfo.PlaneBounds.Right  = Glyph.PlaneRight;
+		GlyphInfo.PlaneBounds.Top    = Glyph.PlaneTop;
+		GlyphInfo.PlaneBounds.Bottom = Glyph.PlaneBottom;
+		GlyphInfo.Texcoords.Left     = Glyph.TexLeft;
+		GlyphInfo.Texcoords.Right    = Glyph.TexRight;
+		GlyphInfo.Texcoords.Top      = Glyph.TexTop;
+		GlyphInfo.Texcoords.Bottom   = Glyph.TexBottom;
+	}
+
+	if (!Atlas.Kernings.Reference(Kernings, Header->KerningCount, &Atlas.Glyphs))
+	{
+		LOG_F(ERROR, "Font file kerning pairs are not sorted");
+		return font_atlas();
+	}
+
+	Atlas.Width  = (i32)Header->Width;
+	Atlas.Height = (i32)Header->Height;
+	Atlas.Data   = Data + Header->TexelOffset;
 
 	return Atlas;
 }
+
+static u64 AlignFontFileOffset(u64 Offset) { return (Offset + k_FontFileAlignment - 1) & ~(k_FontFileAlignment - 1); }
+
+bool WriteFontAtlasBinary(const font_atlas& Atlas, const char* FileName)
+{
+	if (Atlas.Data == nullptr)
+	{
+		LOG_F(ERROR, "Cannot write %s, the atlas has no texels", FileName);
+		return false;
+	}
+
+	eastl::vector<font_file_glyph> Glyphs;
+	Glyphs.reserve(Atlas.Glyphs.GetGlyphCount());
+
+	for (u32 GlyphIndex = 0; GlyphIndex < Atlas.Glyphs.GetGlyphCount(); ++GlyphIndex)
+	{
+		const glyph& GlyphInfo = Atlas.Glyphs.GetGlyph(GlyphIndex);
+
+		font_file_glyph Glyph = {};
+		Glyph.Unicode         = Atlas.Glyphs.GetCodepoint(GlyphIndex);
+		Glyph.Advance         = GlyphInfo.Advance;
+		Glyph.HasGeometry     = GlyphInfo.HasGeometry ? 1 : 0;
+
+		// Spaces have no bounds
+		if (GlyphInfo.HasGeometry)
+		{
+			Glyph.PlaneLeft   = GlyphInfo.PlaneBounds.Left;
+			Glyph.PlaneRight  = GlyphInfo.PlaneBounds.Right;
+			Glyph.PlaneTop    = GlyphInfo.PlaneBounds.Top;
+			Glyph.PlaneBottom = GlyphInfo.PlaneBounds.Bottom;
+			Glyph.TexLeft     = GlyphInfo.Texcoords.Left;
+			Glyph.TexRight    = GlyphInfo.Texcoords.Right;
+			Glyph.TexTop      = GlyphInfo.Texcoords.Top;
+			Glyph.TexBottom   = GlyphInfo.Texcoords.Bottom;
+		}
+
+		Glyphs.push_back(Glyph);
+	}
+
+	// Already sorted by kerning_table::Build()
+	eastl::vector<font_file_kerning> Kernings;
+	Kernings.reserve(Atlas.Kernings.GetPairCount());
+
+	for (u32 PairIndex = 0; PairIndex < Atlas.Kernings.GetPairCount(); ++PairIndex)
+	{
+		const kerning_pair& Pair = Atlas.Kernings.GetPair(PairIndex);
+		Kernings.push_back({Pair.Left, Pair.Right, Pair.Advance});
+	}
+
+	eastl::sort(Glyphs.begin(), Glyphs.end(), [](const font_file_glyph& A, const font_file_glyph& B) { return A.Unicode < B.Unicode; });
+
+	font_file_header Header = {};
+
+	Header.Magic              = k_FontFileMagic;
+	Header.Version            = k_FontFileVersion;
+	Header.LineHeight         = Atlas.Metrics.LineHeight;
+	Header.Ascender           = Atlas.Metrics.Ascender;
+	Header.Descender          = Atlas.Metrics.Descender;
+	Header.UnderlineY         = Atlas.Metrics.UnderlineY;
+	Header.UnderlineThickness = Atlas.Metrics.UnderlineThickness;
+	Header.Width              = (u32)Atlas.Width;
+	Header.Height             = (u32)Atlas.Height;
+	Header.ComponentCount     = (u32)Atlas.Type;
+	Header.DistanceRange      = Atlas.DistanceRange;
+	Header.GlyphCount         = (u32)Glyphs.size();
+	Header.KerningCount       = (u32)Kernings.size();
+	Header.GlyphOffset        = AlignFontFileOffset(sizeof(font_file_header));
+	Header.KerningOffset      = AlignFontFileOffset(Header.GlyphOffset + Glyphs.size() * sizeof(font_file_glyph));
+	Header.TexelOffset        = AlignFontFileOffset(Header.KerningOffset + Kernings.size() * sizeof(font_file_kerning));
+	Header.TexelSize          = (u64)Header.Width * Header.Height * Header.ComponentCount;
+
+	eastl::vector<u8> Content(Header.TexelOffset + Header.TexelSize, 0);
+
+	memcpy(Content.data(), &Header, sizeof(Header));
+	memcpy(Content.data() + Header.GlyphOffset, Glyphs.data(), Glyphs.size() * sizeof(font_file_glyph));
+	memcpy(Content.data() + Header.KerningOffset, Kernings.data(), Kernings.size() * sizeof(font_file_kerning));
+	memcpy(Content.data() + Header.TexelOffset, Atlas.Data, Header.TexelSize);
+
+	FILE* File = fopen(FileName, "wb");
+
+	if (File == nullptr)
+	{
+		LOG_F(ERROR, "Cannot open %s for writing", FileName);
+		return false;
+	}
+
+	const size_t Written = fwrite(Content.data(), 1, Content.size(), File);
+	fclose(File);
+
+	return Written == Content.size();
+}
+
+void ReleaseFontAtlasTexels(font_atlas* Atlas)
+{
+	if (Atlas->OwnsData)
+	{
+		stbi_image_free((void*)Atlas->Data);
+	}
+
+	Atlas->Data     = nullptr;
+	Atlas->OwnsData = false;
+}
+
+void ReleaseFontAtlas(font_atlas* Atlas)
+{
+	ReleaseFontAtlasTexels(Atlas);
+
+	// The kerning pairs point into the mapping
+	Atlas->Kernings.Build({}, &Atlas->Glyphs);
+
+	if (Atlas->File.IsValid())
+	{
+		UnmapFile(&Atlas->File);
+	}
+}
 }
@@ -1,15 +1,20 @@
 #pragma once
 
+#include <gluon/api/gln_api_defs.h>
+
 #include <gluon/core/gln_defines.h>
+#include <gluon/core/gln_mapped_file.h>
 
-#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+#include <EASTL/array.h>
+#include <EASTL/algorithm.h>
 
 namespace gluon
 {
 
+//! Texcoords are normalized at load time, with V going up as the text shader expects
 struct glyph
 {
-	u32 Unicode;
 	f32 Advance;
 
 	struct
@@ -20,11 +25,85 @@ struct glyph
 	struct
 	{
 		f32 Left, Right, Top, Bottom;
-	} AtlasBounds;
+	} Texcoords;
+
+	// Range of the kerning pairs having this glyph on the left side, @see kerning_table
+	u32 KerningBegin;
+	u32 KerningCount;
+
+	// Page of dynamic atlases the glyph is stored in, always 0 for pre-baked ones, @see dynamic_font
+	u16 AtlasPage;
 
 	bool HasGeometry;
 };
 
+static constexpr u16 k_GlyphNotResident = 0xFFFF;
+static constexpr u16 k_GlyphPending     = 0xFFFE;
+static constexpr u16 k_GlyphFailed      = 0xFFFD; // Did not fit in the atlas, retried once a page can be recycled
+
+//! Codepoint to glyph lookup. Latin-1 is indexed directly, the rest of Unicode goes through a two-level page table, so a lookup
+//! is a couple of dependent loads at most. Glyphs themselves are stored contiguously.
+class GLUON_API_EXPORT glyph_table
+{
+public:
+	static constexpr u32 k_DirectCount  = 256;
+	static constexpr u32 k_PageBits     = 8;
+	static constexpr u32 k_PageSize     = 1 << k_PageBits;
+	static constexpr u32 k_MaxCodepoint = 0x10FFFF;
+	static constexpr u32 k_InvalidGlyph = 0xFFFFFFFF;
+
+	glyph_table();
+
+	void Reserve(u32 GlyphCount);
+	void Insert(u32 Codepoint, const glyph& Glyph);
+
+	//! Adds an uninitialized glyph, codepoints must be appended in increasing order as the sorted glyphs of font files are
+	glyph* Append(u32 Codepoint);
+
+	GLN_FORCE_INLINE glyph* Find(u32 Codepoint) { return const_cast<glyph*>(static_cast<const glyph_table*>(this)->Find(Codepoint)); }
+
+	GLN_FORCE_INLINE const glyph* Find(u32 Codepoint) const
+	{
+		u32 GlyphIndex;
+
+		if (Codepoint < k_DirectCount)
+		{
+			GlyphIndex = m_DirectIndices[Codepoint];
+		}
+		else
+		{
+			const u32 Page = Codepoint >> k_PageBits;
+
+			// Also covers tables without any page
+			if (Page >= m_PageIndices.size() || m_PageIndices[Page] == 0)
+			{
+				return nullptr;
+			}
+
+			GlyphIndex = m_Pages[m_PageIndices[Page] - 1][Codepoint & (k_PageSize - 1)];
+		}
+
+		return GlyphIndex != k_InvalidGlyph ? &m_Glyphs[GlyphIndex] : nullptr;
+	}
+
+	u32          GetGlyphCount() const { return (u32)m_Glyphs.size(); }
+	const glyph& GetGlyph(u32 GlyphIndex) const { return m_Glyphs[GlyphIndex]; }
+	u32          GetCodepoint(u32 GlyphIndex) const { return m_Codepoints[GlyphIndex]; }
+	u32          GetGlyphIndex(const glyph* Glyph) const { return (u32)(Glyph - m_Glyphs.data()); }
+
+private:
+	u32* GetSlot(u32 Codepoint);
+
+	eastl::vector<glyph> m_Glyphs;
+	eastl::vector<u32>   m_Codepoints;
+
+	u32 m_DirectIndices[k_DirectCount];
+
+	// One entry per page of Unicode, index + 1 in m_Pages or 0 when the page has no glyph
+	eastl::vector<u16>                           m_PageIndices;
+	eastl::vector<eastl::array<u32, k_PageSize>> m_Pages;
+};
+
 struct font_metrics
 {
 	f32 LineHeight         = 0.0f;
@@ -34,20 +113,90 @@ struct font_metrics
 	f32 UnderlineThickness = 0.0f;
 };
 
-using glyph_kernings = eastl::unordered_map<u32, eastl::unordered_map<u32, f32>>;
-using glyph_infos    = eastl::unordered_map<u32, glyph>;
+struct kerning_pair
+{
+	u32 Left;
+	u32 Right;
+	f32 Advance;
+};
+
+//! Kerning pairs sorted by (Left, Right). Each glyph stores the range of pairs it starts, so that applying kerning during layout
+//! only searches the few pairs of the previous glyph instead of hashing both codepoints.
+class GLUON_API_EXPORT kerning_table
+{
+public:
+	//! Sorts the pairs and assigns the glyph ranges, pairs referencing a missing left glyph are dropped
+	void Build(eastl::vector<kerning_pair>&& Pairs, glyph_table* Glyphs);
+
+	//! Uses pairs already sorted by (Left, Right) in place, they must outlive the table. Returns false when they are not sorted.
+	bool Reference(const kerning_pair* Pairs, u32 PairCount, glyph_table* Glyphs);
+
+	GLN_FORCE_INLINE f32 GetAdvance(const glyph& Left, u32 Right) const
+	{
+		const kerning_pair* Begin = GetPairs() + Left.KerningBegin;
+		const kerning_pair* End   = Begin + Left.KerningCount;
+
+		const kerning_pair* Pair = eastl::lower_bound(Begin, End, Right, [](const kerning_pair& Entry, u32 Codepoint) {
+			return Entry.Right < Codepoint;
+		});
+
+		return (Pair != End && Pair->Right == Right) ? Pair->Advance : 0.0f;
+	}
+
+	u32                 GetPairCount() const { return m_ReferencedPairs != nullptr ? m_ReferencedCount : (u32)m_Pairs.size(); }
+	const kerning_pair& GetPair(u32 PairIndex) const { return GetPairs()[PairIndex]; }
+
+private:
+	const kerning_pair* GetPairs() const { return m_ReferencedPairs != nullptr ? m_ReferencedPairs : m_Pairs.data(); }
+
+	eastl::vector<kerning_pair> m_Pairs;
+
+	// Pairs read in place from a font file mapping, @see Reference()
+	const kerning_pair* m_ReferencedPairs = nullptr;
+	u32                 m_ReferencedCount = 0;
+};
+
+//! Distance field flavours of msdf-atlas-gen, the value is the number of channels of the atlas texels
+enum font_atlas_type
+{
+	FontAtlasType_SDF   = 1, // Rounds the corners of large glyphs, but takes a third of the memory of a MSDF
+	FontAtlasType_MSDF  = 3,
+	FontAtlasType_MTSDF = 4, // MSDF with the true distance in alpha
+};
 
 struct font_atlas
 {
-	i32 Width = -1, Height = -1;
-	u8* Data = nullptr;
+	i32       Width = -1, Height = -1;
+	const u8* Data  = nullptr;
+
+	font_atlas_type Type          = FontAtlasType_MSDF;
+	f32             DistanceRange = 8.0f; // In atlas texels, across both sides of the outline
+
+	// Binary atlases keep their mapping for their whole life, the kerning pairs are read from it in place.
+	// Json/png ones own a decoded copy of the texels.
+	mapped_file File;
+	bool        OwnsData = false;
 
 	font_metrics Metrics;
 
-	glyph_infos    Glyphs;
-	glyph_kernings GlyphKernings;
+	glyph_table   Glyphs;
+	kerning_table Kernings;
 };
 
-// Assumes font to be in resources/fonts path.
-font_atlas LoadFontAtlas(const char* FontName);
+// Looks for the font in the embedded fonts first, then in resources/fonts path, preferring the binary .glnfont format.
+GLUON_API_EXPORT font_atlas LoadFontAtlas(const char* FontName);
+
+//! AtlasData holds the encoded png, JsonData the null terminated msdf-atlas-gen description
+GLUON_API_EXPORT font_atlas LoadFontAtlasFromMemory(const u8* AtlasData, u64 AtlasSize, const char* JsonData);
+
+//! Data must be aligned on k_FontFileAlignment and outlive the atlas, the kerning pairs are used in place. @see gln_font_file.h
+GLUON_API_EXPORT font_atlas LoadFontAtlasFromBinary(const u8* Data, u64 Size);
+GLUON_API_EXPORT bool       WriteFontAtlasBinary(const font_atlas& Atlas, const char* FileName);
+
+//! Texels are not needed anymore once they are uploaded to the GPU. The mapping of binary atlases is kept, its pages are clean
+//! and reclaimed by the system once the texels are not touched anymore.
+GLUON_API_EXPORT void ReleaseFontAtlasTexels(font_atlas* Atlas);
+
+//! Releases the texels and the file mapping, the atlas cannot be used anymore
+GLUON_API_EXPORT void ReleaseFontAtlas(font_atlas* Atlas);
 }
@@ -0,0 +1,726 @@
+#include <gluon/api/gln_text_buffer.h>
+#include <gluon/api/gln_renderer_p.h>
+#include <gluon/api/gln_row_index_p.h>
+#include <gluon/api/gln_text_layout_p.h>
+
+#include <gluon/core/gln_math.h>
+
+#include <EASTL/array.h>
+#include <EASTL/vector.h>
+#include <EASTL/algorithm.h>
+#include <EASTL/iterator.h>
+
+namespace gluon
+{
+//! Items stored in chunks of about k_ChunkSize, with the sums of their measures per chunk in a row_index: the item at an offset of a
+//! measure is found in O(log n) plus the scan of a chunk, and inserting or erasing items only moves the end of their chunk.
+//! item_t provides k_MeasureCount and GetMeasure().
+template <typename item_t>
+class chunk_list
+{
+public:
+	static constexpr u32 k_MeasureCount = item_t::k_MeasureCount;
+	static constexpr u32 k_ChunkSize    = 64; // Chunks above twice this size are split, below a quarter they are merged
+
+	struct cursor
+	{
+		u32 Chunk = 0;
+		u32 Index = 0;
+	};
+
+	chunk_list() { Clear(); }
+
+	void Clear()
+	{
+		m_Chunks.clear();
+		m_Chunks.emplace_back();
+		m_Count = 0;
+
+		Reindex();
+	}
+
+	u32 GetCount() const { return m_Count; }
+	u64 GetTotal(u32 Measure) const { return m_Indices[Measure].GetTotalRows(); }
+
+	item_t&       Get(const cursor& Cursor) { return m_Chunks[Cursor.Chunk].Items[Cursor.Index]; }
+	const item_t& Get(const cursor& Cursor) const { return m_Chunks[Cursor.Chunk].Items[Cursor.Index]; }
+
+	bool IsEnd(const cursor& Cursor) const
+	{
+		return Cursor.Chunk + 1 == (u32)m_Chunks.size() && Cursor.Index == (u32)m_Chunks[Cursor.Chunk].Items.size();
+	}
+
+	void Next(cursor* Cursor) const
+	{
+		Cursor->Index += 1;
+
+		if (Cursor->Index == (u32)m_Chunks[Cursor->Chunk].Items.size() && Cursor->Chunk + 1 < (u32)m_Chunks.size())
+		{
+			Cursor->Chunk += 1;
+			Cursor->Index = 0;
+		}
+	}
+
+	//! False at the first item
+	bool Previous(cursor* Cursor) const
+	{
+		if (Cursor->Index > 0)
+		{
+			Cursor->Index -= 1;
+			return true;
+		}
+
+		if (Cursor->Chunk == 0)
+		{
+			return false;
+		}
+
+		Cursor->Chunk -= 1;
+		Cursor->Index = (u32)m_Chunks[Cursor->Chunk].Items.size() - 1;
+		return true;
+	}
+
+	//! Item covering Offset of a measure and the offset it starts at, the end when Offset is past the last item
+	cursor Find(u32 Measure, u64 Offset, u64* Start) const
+	{
+		cursor Cursor;
+
+		if (Offset >= GetTotal(Measure))
+		{
+			Cursor.Chunk = (u32)m_Chunks.size() - 1;
+			Cursor.Index = (u32)m_Chunks[Cursor.Chunk].Items.size();
+
+			*Start = GetTotal(Measure);
+			return Cursor;
+		}
+
+		Cursor.Chunk = m_Indices[Measure].FindLine(Offset);
+
+		const eastl::vector<item_t>& Items     = m_Chunks[Cursor.Chunk].Items;
+		u64                          ItemStart = m_Indices[Measure].GetRowOffset(Cursor.Chunk);
+
+		while (ItemStart + Items[Cursor.Index].GetMeasure(Measure) <= Offset)
+		{
+			ItemStart += Items[Cursor.Index].GetMeasure(Measure);
+			Cursor.Index += 1;
+		}
+
+		*Start = ItemStart;
+		return Cursor;
+	}
+
+	//! Offset of a measure the item starts at
+	u64 GetOffset(const cursor& Cursor, u32 Measure) const
+	{
+		const eastl::vector<item_t>& Items  = m_Chunks[Cursor.Chunk].Items;
+		u64                          Offset = m_Indices[Measure].GetRowOffset(Cursor.Chunk);
+
+		for (u32 Index = 0; Index < Cursor.Index; ++Index)
+		{
+			Offset += Items[Index].GetMeasure(Measure);
+		}
+
+		return Offset;
+	}
+
+	//! Has to be called when a measure of an item changes
+	void Adjust(const cursor& Cursor, u32 Measure, i32 Delta)
+	{
+		m_Chunks[Cursor.Chunk].Sums[Measure] += Delta;
+		m_Indices[Measure].Add(Cursor.Chunk, Delta);
+	}
+
+	void PushBack(item_t&& Item)
+	{
+		if (m_Chunks.back().Items.size() == k_ChunkSize)
+		{
+			m_Chunks.emplace_back();
+
+			for (u32 Measure = 0; Measure < k_MeasureCount; ++Measure)
+			{
+				m_Indices[Measure].Append(0);
+			}
+		}
+
+		const cursor Last = {(u32)m_Chunks.size() - 1, (u32)m_Chunks.back().Items.size()};
+
+		m_Chunks.back().Items.push_back(eastl::move(Item));
+		m_Count += 1;
+
+		for (u32 Measure = 0; Measure < k_MeasureCount; ++Measure)
+		{
+			Adjust(Last, Measure, (i32)Get(Last).GetMeasure(Measure));
+		}
+	}
+
+	//! Moves Count items in before Where, cursors are invalidated
+	void Insert(const cursor& Where, item_t* Items, u32 Count)
+	{
+		eastl::vector<item_t>& Chunk = m_Chunks[Where.Chunk].Items;
+
+		Chunk.insert(Chunk.begin() + Where.Index, eastl::make_move_iterator(Items), eastl::make_move_iterator(Items + Count));
+		m_Count += Count;
+
+		for (u32 Measure = 0; Measure < k_MeasureCount; ++Measure)
+		{
+			Adjust(Where, Measure, (i32)SumMeasure(Chunk, Where.Index, Where.Index + Count, Measure));
+		}
+
+		Rebalance(Where.Chunk, Where.Chunk);
+	}
+
+	//! Erases Count items from From, they may span several chunks. Cursors are invalidated.
+	void Erase(const cursor& From, u32 Count)
+	{
+		cursor Cursor    = From;
+		u32    LastChunk = From.Chunk;
+
+		m_Count -= Count;
+
+		while (Count > 0)
+		{
+			eastl::vector<item_t>& Chunk = m_Chunks[Cursor.Chunk].Items;
+
+			if (Cursor.Index == (u32)Chunk.size())
+			{
+				Cursor.Chunk += 1;
+				Cursor.Index = 0;
+				continue;
+			}
+
+			const u32 Erased = eastl::min(Count, (u32)Chunk.size() - Cursor.Index);
+
+			for (u32 Measure = 0; Measure < k_MeasureCount; ++Measure)
+			{
+				Adjust(Cursor, Measure, -(i32)SumMeasure(Chunk, Cursor.Index, Cursor.Index + Erased, Measure));
+			}
+
+			Chunk.erase(Chunk.begin() + Cursor.Index, Chunk.begin() + Cursor.Index + Erased);
+
+			Count -= Erased;
+			LastChunk = Cursor.Chunk;
+		}
+
+		Rebalance(From.Chunk, LastChunk);
+	}
+
+private:
+	struct chunk
+	{
+		eastl::vector<item_t>             Items;
+		eastl::array<u32, k_MeasureCount> Sums = {};
+	};
+
+	static u32 SumMeasure(const eastl::vector<item_t>& Items, u32 Begin, u32 End, u32 Measure)
+	{
+		u32 Sum = 0;
+
+		for (u32 Index = Begin; Index < End; ++Index)
+		{
+			Sum += Items[Index].GetMeasure(Measure);
+		}
+
+		return Sum;
+	}
+
+	//! Splits the chunks in [First, Last] that grew too large and merges the ones that became too small, the chunks after them move
+	void Rebalance(u32 First, u32 Last)
+	{
+		bool Changed = false;
+
+		// From the end, so that the chunks left to visit keep their index
+		for (u32 ChunkIndex = Last + 1; ChunkIndex-- > First;)
+		{
+			const u32 Size = (u32)m_Chunks[ChunkIndex].Items.size();
+
+			if (Size > 2 * k_ChunkSize)
+			{
+				Split(ChunkIndex);
+				Changed = true;
+			}
+			else if (Size < k_ChunkSize / 4 && m_Chunks.size() > 1)
+			{
+				Merge(ChunkIndex, ChunkIndex + 1 < (u32)m_Chunks.size() ? ChunkIndex + 1 : ChunkIndex - 1);
+				Changed = true;
+			}
+		}
+
+		if (Changed)
+		{
+			Reindex();
+		}
+	}
+
+	void Split(u32 ChunkIndex)
+	{
+		eastl::vector<item_t> Items      = eastl::move(m_Chunks[ChunkIndex].Items);
+		const u32             ChunkCount = ((u32)Items.size() + k_ChunkSize - 1) / k_ChunkSize;
+
+		m_Chunks.insert(m_Chunks.begin() + ChunkIndex + 1, ChunkCount - 1, chunk());
+
+		for (u32 Index = 0; Index < ChunkCount; ++Index)
+		{
+			chunk&    Chunk = m_Chunks[ChunkIndex + Index];
+			const u32 Begin = Index * k_ChunkSize;
+			const u32 End   = eastl::min(Begin + k_ChunkSize, (u32)Items.size());
+
+			Chunk.Items.clear();
+			Chunk.Items.insert(Chunk.Items.end(),
+			                   eastl::make_move_iterator(Items.begin() + Begin),
+			                   eastl::make_move_iterator(Items.begin() + End));
+
+			for (u32 Measure = 0; Measure < k_MeasureCount; ++Measure)
+			{
+				Chunk.Sums[Measure] = SumMeasure(Chunk.Items, 0, (u32)Chunk.Items.size(), Measure);
+			}
+		}
+	}
+
+	//! Moves the items of a chunk into a neighbour, and removes it
+	void Merge(u32 ChunkIndex, u32 Neighbour)
+	{
+		chunk& Source = m_Chunks[ChunkIndex];
+		chunk& Target = m_Chunks[Neighbour];
+
+		Target.Items.insert(Neighbour > ChunkIndex ? Target.Items.begin() : Target.Items.end(),
+		                    eastl::make_move_iterator(Source.Items.begin()),
+		                    eastl::make_move_iterator(Source.Items.end()));
+
+		for (u32 Measure = 0; Measure < k_MeasureCount; ++Measure)
+		{
+			Target.Sums[Measure] += Source.Sums[Measure];
+		}
+
+		m_Chunks.erase(m_Chunks.begin() + ChunkIndex);
+	}
+
+	//! Rebuilds the indices from the sums of the chunks, in O(c log c) for c chunks
+	void Reindex()
+	{
+		for (u32 Measure = 0; Measure < k_MeasureCount; ++Measure)
+		{
+			m_Indices[Measure].Reset(0);
+
+			for (const chunk& Chunk : m_Chunks)
+			{
+				m_Indices[Measure].Append(Chunk.Sums[Measure]);
+			}
+		}
+	}
+
+	eastl::vector<chunk> m_Chunks; // Never empty, a single empty chunk holds no item
+	row_index            m_Indices[k_MeasureCount];
+	u32                  m_Count = 0;
+};
+
+struct piece
+{
+	static constexpr u32 k_MeasureCount = 1;
+
+	bool Added; // Offset in the added buffer, otherwise in the original one
+	u32  Offset;
+	u32  Length;
+
+	u32 GetMeasure(u32 Measure) const
+	{
+		GLN_UNUSED(Measure);
+		return Length;
+	}
+};
+
+struct paragraph
+{
+	static constexpr u32 k_MeasureCount     = 2;
+	static constexpr u32 k_CodepointMeasure = 0; // Line feed included
+	static constexpr u32 k_LineMeasure      = 1;
+
+	u32 Length = 0; // Line feed excluded
+
+	// Estimated to a single line until the paragraph is laid out
+	u32 LineCount = 1;
+
+	// Font index and size the layout was made with, it is invalid while Dirty is set
+	u32         FontIndex  = 0xFFFFFFFF;
+	u32         Generation = 0;
+	f32         PixelSize  = 0.0f;
+	bool        Dirty      = true;
+	shaped_text Layout;
+
+	u32 GetMeasure(u32 Measure) const { return Measure == k_CodepointMeasure ? Length + 1 : LineCount; }
+};
+
+using piece_cursor     = chunk_list<piece>::cursor;
+using paragraph_cursor = chunk_list<paragraph>::cursor;
+
+struct text_buffer_impl
+{
+	eastl::u32string  Original;
+	eastl::u32string  Added;
+	chunk_list<piece> Pieces;
+	u32               Length = 0;
+
+	// Paragraphs are indexed by codepoint and by line, to find the one being edited and the first visible one
+	chunk_list<paragraph> Paragraphs;
+
+	font_handle Font      = GLUON_INVALID_HANDLE;
+	f32         PixelSize = 16.0f;
+	f32         Scroll    = 0.0f;
+
+	eastl::u32string  Scratch;
+	text_buffer_stats Stats;
+
+	const char32_t* GetPieceData(const piece& Piece) const { return (Piece.Added ? Added.data() : Original.data()) + Piece.Offset; }
+
+	//! Splits the piece covering Position if needed, returns the piece starting at Position
+	piece_cursor SplitPieces(u32 Position)
+	{
+		u64          Start;
+		piece_cursor Cursor = Pieces.Find(0, Position, &Start);
+
+		if (Pieces.IsEnd(Cursor) || Position == Start)
+		{
+			return Cursor;
+		}
+
+		piece&    Piece = Pieces.Get(Cursor);
+		const u32 Split = Position - (u32)Start;
+		piece     Tail  = {Piece.Added, Piece.Offset + Split, Piece.Length - Split};
+
+		Piece.Length = Split;
+		Pieces.Adjust(Cursor, 0, -(i32)Tail.Length);
+
+		Cursor.Index += 1;
+		Pieces.Insert(Cursor, &Tail, 1);
+
+		// The chunk may have been split
+		return Pieces.Find(0, Position, &Start);
+	}
+
+	//! Paragraph containing Position, a position right before a line feed belongs to the paragraph it ends
+	paragraph_cursor FindParagraph(u32 Position, u32* Start) const
+	{
+		u64                    ParagraphStart;
+		const paragraph_cursor Cursor = Paragraphs.Find(paragraph::k_CodepointMeasure, Position, &ParagraphStart);
+
+		*Start = (u32)ParagraphStart;
+		return Cursor;
+	}
+
+	void Read(u32 Position, u32 Count, eastl::u32string* Text) const
+	{
+		Text->clear();
+
+		u64          Start;
+		piece_cursor Cursor = Pieces.Find(0, Position, &Start);
+		u32          Offset = Position - (u32)Start;
+
+		for (; Count > 0 && !Pieces.IsEnd(Cursor); Pieces.Next(&Cursor))
+		{
+			const piece& Piece  = Pieces.Get(Cursor);
+			const u32    Length = eastl::min(Piece.Length - Offset, Count);
+
+			Text->append(GetPieceData(Piece) + Offset, Length);
+
+			Count -= Length;
+			Offset = 0;
+		}
+	}
+
+	void Reset()
+	{
+		Pieces.Clear();
+		Paragraphs.Clear();
+
+		if (!Original.empty())
+		{
+			Pieces.PushBack({false, 0, (u32)Original.size()});
+		}
+
+		Length = (u32)Original.size();
+
+		// Paragraphs are laid out lazily, only their lengths are known upfront
+		paragraph Paragraph;
+
+		for (char32_t Codepoint : Original)
+		{
+			if (Codepoint == U'\n')
+			{
+				Paragraphs.PushBack(eastl::move(Paragraph));
+				Paragraph = paragraph();
+			}
+			else
+			{
+				Paragraph.Length += 1;
+			}
+		}
+
+		Paragraphs.PushBack(eastl::move(Paragraph));
+	}
+};
+
+text_buffer::text_buffer()
+{
+	m_Buffer = new text_buffer_impl();
+	m_Buffer->Reset();
+}
+
+text_buffer::~text_buffer() { delete m_Buffer; }
+
+void text_buffer::SetText(const char32_t* Text)
+{
+	m_Buffer->Original = Text;
+	m_Buffer->Added.clear();
+	m_Buffer->Reset();
+}
+
+void text_buffer::Insert(u32 Position, const char32_t* Text, u32 Length)
+{
+	text_buffer_impl* Buffer = m_Buffer;
+
+	if (Length == 0 || Position > Buffer->Length)
+	{
+		return;
+	}
+
+	// Pieces
+	const u32 AddedOffset = (u32)Buffer->Added.size();
+	Buffer->Added.append(Text, Length);
+
+	const piece_cursor PieceCursor = Buffer->SplitPieces(Position);
+
+	// Typing extends the piece of the previous keystroke instead of creating a new one
+	piece_cursor PreviousCursor = PieceCursor;
+	piece*       Previous       = Buffer->Pieces.Previous(&PreviousCursor) ? &Buffer->Pieces.Get(PreviousCursor) : nullptr;
+
+	if (Previous != nullptr && Previous->Added && Previous->Offset + Previous->Length == AddedOffset)
+	{
+		Previous->Length += Length;
+		Buffer->Pieces.Adjust(PreviousCursor, 0, (i32)Length);
+	}
+	else
+	{
+		piece Piece = {true, AddedOffset, Length};
+		Buffer->Pieces.Insert(PieceCursor, &Piece, 1);
+	}
+
+	Buffer->Length += Length;
+
+	// Paragraphs, the one containing Position is split at each inserted line feed
+	u32                    Start;
+	const paragraph_cursor Cursor    = Buffer->FindParagraph(Position, &Start);
+	paragraph&             Paragraph = Buffer->Paragraphs.Get(Cursor);
+	const u32              Offset    = Position - Start;
+	const u32              OldLength = Paragraph.Length;
+
+	u32 NewParagraphs = 0;
+
+	for (u32 Index = 0; Index < Length; ++Index)
+	{
+		if (Text[Index] == U'\n')
+		{
+			++NewParagraphs;
+		}
+	}
+
+	Paragraph.Dirty = true;
+
+	if (NewParagraphs == 0)
+	{
+		Paragraph.Length += Length;
+		Buffer->Paragraphs.Adjust(Cursor, paragraph::k_CodepointMeasure, (i32)Length);
+		return;
+	}
+
+	// The paragraph ends at the first inserted line feed, the new ones follow it
+	eastl::vector<paragraph> Inserted(NewParagraphs);
+
+	u32 Current = 0;
+	u32 Segment = 0;
+
+	for (u32 Index = 0; Index < Length; ++Index)
+	{
+		if (Text[Index] != U'\n')
+		{
+			++Segment;
+			continue;
+		}
+
+		if (Current == 0)
+		{
+			Paragraph.Length = Offset + Segment;
+		}
+		else
+		{
+			Inserted[Current - 1].Length = Segment;
+		}
+
+		++Current;
+		Segment = 0;
+	}
+
+	Inserted.back().Length = Segment + OldLength - Offset;
+
+	Buffer->Paragraphs.Adjust(Cursor, paragraph::k_CodepointMeasure, (i32)Paragraph.Length - (i32)OldLength);
+	Buffer->Paragraphs.Insert({Cursor.Chunk, Cursor.Index + 1}, Inserted.data(), NewParagraphs);
+}
+
+void text_buffer::Erase(u32 Position, u32 Count)
+{
+	text_buffer_impl* Buffer = m_Buffer;
+
+	Count = eastl::min(Count, Buffer->Length - eastl::min(Position, Buffer->Length));
+
+	if (Count == 0)
+	{
+		return;
+	}
+
+	// Only the erased range is read, to count the paragraphs it merges
+	Buffer->Read(Position, Count, &Buffer->Scratch);
+
+	const u32 RemovedParagraphs = (u32)eastl::count(Buffer->Scratch.begin(), Buffer->Scratch.end(), U'\n');
+
+	// Pieces, the end is split first as splitting the start invalidates cursors
+	Buffer->SplitPieces(Position + Count);
+
+	const piece_cursor First = Buffer->SplitPieces(Position);
+
+	piece_cursor Piece      = First;
+	u32          PieceCount = 0;
+
+	for (u32 Erased = 0; Erased < Count; Buffer->Pieces.Next(&Piece))
+	{
+		Erased += Buffer->Pieces.Get(Piece).Length;
+		++PieceCount;
+	}
+
+	Buffer->Pieces.Erase(First, PieceCount);
+	Buffer->Length -= Count;
+
+	// Paragraphs
+	u32                    Start;
+	const paragraph_cursor Cursor    = Buffer->FindParagraph(Position, &Start);
+	paragraph&             Paragraph = Buffer->Paragraphs.Get(Cursor);
+
+	paragraph_cursor Removed      = Cursor;
+	u32              MergedLength = Paragraph.Length;
+
+	for (u32 Index = 0; Index < RemovedParagraphs; ++Index)
+	{
+		Buffer->Paragraphs.Next(&Removed);
+		MergedLength += Buffer->Paragraphs.Get(Removed).Length + 1;
+	}
+
+	const u32 OldLength = Paragraph.Length;
+
+	Paragraph.Length = MergedLength - Count;
+	Paragraph.Dirty  = true;
+
+	Buffer->Paragraphs.Adjust(Cursor, paragraph::k_CodepointMeasure, (i32)Paragraph.Length - (i32)OldLength);
+
+	if (RemovedParagraphs > 0)
+	{
+		paragraph_cursor FirstRemoved = Cursor;
+		Buffer->Paragraphs.Next(&FirstRemoved);
+		Buffer->Paragraphs.Erase(FirstRemoved, RemovedParagraphs);
+	}
+}
+
+u32 text_buffer::GetLength() const { return m_Buffer->Length; }
+
+void text_buffer::GetText(u32 Position, u32 Count, eastl::u32string* Text) const { m_Buffer->Read(Position, Count, Text); }
+
+void text_buffer::SetFont(font_handle Font, f32 PixelSize)
+{
+	m_Buffer->Font      = Font;
+	m_Buffer->PixelSize = PixelSize;
+}
+
+void text_buffer::SetScroll(f32 Scroll) { m_Buffer->Scroll = Max(Scroll, 0.0f); }
+
+void text_buffer::Draw(f32 X, f32 Y, f32 MaxWidth, f32 Height, color FillColor)
+{
+	text_buffer_impl* Buffer = m_Buffer;
+
+	Buffer->Stats.LaidOutParagraphs = 0;
+
+	u32 FontIndex;
+
+	if (!priv::ResolveTextFont(Buffer->Font, &FontIndex))
+	{
+		return;
+	}
+
+	const u32 Generation = priv::GetFontGeneration(FontIndex);
+
+	// Lines are exactly PixelSize high, @see ShapeText()
+	const f32 LineHeight = Buffer->PixelSize;
+
+	chunk_list<paragraph>& Paragraphs = Buffer->Paragraphs;
+
+	// The paragraphs above the scroll offset are skipped through the line index, without being visited
+	const u64        ScrollLine = LineHeight > 0.0f ? (u64)(Buffer->Scroll / LineHeight) : 0;
+	u64              FirstLine;
+	paragraph_cursor Cursor = Paragraphs.Find(paragraph::k_LineMeasure, ScrollLine, &FirstLine);
+
+	u32 Start = (u32)Paragraphs.GetOffset(Cursor, paragraph::k_CodepointMeasure);
+	f32 Top   = (f32)((f64)FirstLine * LineHeight - Buffer->Scroll);
+
+	for (; !Paragraphs.IsEnd(Cursor); Paragraphs.Next(&Cursor))
+	{
+		paragraph& Paragraph = Paragraphs.Get(Cursor);
+
+		if (Height > 0.0f && Top >= Height)
+		{
+			break;
+		}
+
+		const f32 Bottom = Top + Paragraph.LineCount * LineHeight;
+
+		if (Bottom > 0.0f)
+		{
+			// The fallback font being replaced, new glyphs of a dynamic font or the size changing invalidate the layout as well
+			const bool FontChanged = Paragraph.FontIndex != FontIndex || Paragraph.Generation != Generation;
+
+			if (Paragraph.Dirty || FontChanged || Paragraph.PixelSize != Buffer->PixelSize)
+			{
+				Buffer->Read(Start, Paragraph.Length, &Buffer->Scratch);
+				priv::ShapeParagraph(Buffer->Scratch.c_str(), FontIndex, Buffer->PixelSize, &Paragraph.Layout);
+
+				Paragraph.FontIndex  = FontIndex;
+				Paragraph.Generation = Generation;
+				Paragraph.PixelSize  = Buffer->PixelSize;
+				Paragraph.Dirty      = false;
+
+				Buffer->Stats.LaidOutParagraphs += 1;
+			}
+
+			const u32 LineCount = priv::DrawShapedText(Paragraph.Layout, FontIndex, MaxWidth, X, Y - Top, FillColor);
+
+			Paragraphs.Adjust(Cursor, paragraph::k_LineMeasure, (i32)LineCount - (i32)Paragraph.LineCount);
+			Paragraph.LineCount = LineCount;
+		}
+
+		Top += Paragraph.LineCount * LineHeight;
+		Start += Paragraph.Length + 1;
+	}
+}
+
+text_buffer_stats text_buffer::GetStats() const
+{
+	const chunk_list<paragraph>& Paragraphs = m_Buffer->Paragraphs;
+
+	text_buffer_stats Stats = m_Buffer->Stats;
+
+	Stats.PieceCount     = m_Buffer->Pieces.GetCount();
+	Stats.ParagraphCount = Paragraphs.GetCount();
+
+	Stats.CachedParagraphs = 0;
+	for (paragraph_cursor Cursor; !Paragraphs.IsEnd(Cursor); Paragraphs.Next(&Cursor))
+	{
+		Stats.CachedParagraphs += Paragraphs.Get(Cursor).Dirty ? 0 : 1;
+	}
+
+	return Stats;
+}
+}
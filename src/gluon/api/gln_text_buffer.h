@@ -0,0 +1,60 @@
+#pragma once
+
+#include <gluon/api/gln_api_defs.h>
+#include <gluon/api/gln_renderer.h>
+
+#include <gluon/core/gln_defines.h>
+#include <gluon/core/gln_color.h>
+
+#include <EASTL/string.h>
+
+namespace gluon
+{
+struct text_buffer_impl;
+
+struct text_buffer_stats
+{
+	u32 PieceCount        = 0;
+	u32 ParagraphCount    = 0;
+	u32 LaidOutParagraphs = 0; // During the last Draw()
+	u32 CachedParagraphs  = 0; // Paragraphs holding a layout
+};
+
+/**
+ * Editable text stored as a piece table: the original text is never moved, insertions are appended to a second buffer and the
+ * document is a sequence of pieces referencing both, so edits do not depend on the size of the document. Each paragraph keeps its
+ * own layout, only the paragraphs touched by an edit are laid out again, and only once they are visible. Pieces and paragraphs are
+ * kept in chunks whose sums are indexed, positions and the first visible paragraph are found in O(log n).
+ * Positions are in codepoints.
+ */
+class GLUON_API_EXPORT text_buffer
+{
+public:
+	text_buffer();
+	~text_buffer();
+
+	text_buffer(const text_buffer&)            = delete;
+	text_buffer& operator=(const text_buffer&) = delete;
+
+	void SetText(const char32_t* Text);
+
+	void Insert(u32 Position, const char32_t* Text, u32 Length);
+	void Erase(u32 Position, u32 Count);
+
+	u32  GetLength() const;
+	void GetText(u32 Position, u32 Count, eastl::u32string* Text) const;
+
+	void SetFont(font_handle Font, f32 PixelSize);
+
+	//! Offset in pixels from the top of the text, paragraphs above it are neither laid out nor drawn
+	void SetScroll(f32 Scroll);
+
+	//! X, Y is the top left corner, in DrawText() coordinates. MaxWidth <= 0 disables wrapping, Height <= 0 draws everything.
+	void Draw(f32 X, f32 Y, f32 MaxWidth, f32 Height, color FillColor);
+
+	text_buffer_stats GetStats() const;
+
+private:
+	text_buffer_impl* m_Buffer;
+};
+}
@@ -0,0 +1,278 @@
+#include <gluon/api/gln_text_layout_p.h>
+
+#include <EASTL/algorithm.h>
+#include <EASTL/numeric_limits.h>
+
+#include <string.h>
+
+namespace gluon
+{
+void shaped_text::Clear()
+{
+	Glyphs.clear();
+	GlyphCodepoints.clear();
+	Offsets.clear();
+	Breaks.clear();
+	MandatoryBreaks.clear();
+
+	PageMask = 0;
+}
+
+u64 shaped_text::GetMemoryUsage() const
+{
+	return Glyphs.capacity() * sizeof(glyph_data) + GlyphCodepoints.capacity() * sizeof(u32) + Offsets.capacity() * sizeof(f32) +
+	       Breaks.capacity() * sizeof(line_break) + MandatoryBreaks.capacity() * sizeof(u32);
+}
+
+void BreakLines(const shaped_text& Text, f32 MaxWidth, eastl::vector<text_line>* Lines)
+{
+	Lines->clear();
+
+	const u32 CodepointCount = (u32)Text.Offsets.size() - 1;
+	const u32 BreakCount     = (u32)Text.Breaks.size();
+
+	if (MaxWidth <= 0.0f)
+	{
+		MaxWidth = eastl::numeric_limits<f32>::max();
+	}
+
+	auto AddLine = [&](u32 Begin, u32 End) { Lines->push_back({Begin, End, Text.Offsets[End] - Text.Offsets[Begin]}); };
+
+	u32 Begin     = 0;
+	u32 BreakIt   = 0; // First break after Begin
+	u32 Mandatory = 0; // In MandatoryBreaks, first one after Begin
+
+	for (;;)
+	{
+		// Either the next line feed or the end of the text bounds the line
+		const u32 LastBreak = Mandatory < Text.MandatoryBreaks.size() ? Text.MandatoryBreaks[Mandatory] : BreakCount;
+		const u32 LastEnd   = LastBreak < BreakCount ? Text.Breaks[LastBreak].End : CodepointCount;
+
+		const f32 Limit = Text.Offsets[Begin] + MaxWidth;
+
+		u32 Selected = LastBreak;
+
+		if (Text.Offsets[LastEnd] > Limit && BreakIt < LastBreak)
+		{
+			// Offsets only decrease with negative kerning, the search is exact for all practical purposes
+			const line_break* First = Text.Breaks.data() + BreakIt;
+			const line_break* Last  = Text.Breaks.data() + LastBreak;
+
+			const line_break* Fitting = eastl::upper_bound(First, Last, Limit, [&](f32 Value, const line_break& Break) {
+				return Value < Text.Offsets[Break.End];
+			});
+
+			// The first word is kept on the line even when it does not fit
+			Selected = Fitting == First ? BreakIt : (u32)(Fitting - Text.Breaks.data()) - 1;
+		}
+
+		if (Selected == BreakCount)
+		{
+			AddLine(Begin, CodepointCount);
+			return;
+		}
+
+		const line_break& Break = Text.Breaks[Selected];
+		AddLine(Begin, Break.End);
+
+		Begin   = Break.Next;
+		BreakIt = Selected + 1;
+
+		if (Selected == LastBreak)
+		{
+			++Mandatory;
+		}
+	}
+}
+
+void PlaceGlyphs(const shaped_text& Text, const eastl::vector<text_line>& Lines, vec2 Origin, color FillColor, glyph_run* Glyphs)
+{
+	u32 LineIndex = 0;
+
+	for (u32 GlyphIndex = 0; GlyphIndex < (u32)Text.Glyphs.size(); ++GlyphIndex)
+	{
+		const u32 Codepoint = Text.GlyphCodepoints[GlyphIndex];
+
+		while (LineIndex + 1 < (u32)Lines.size() && Codepoint >= Lines[LineIndex + 1].Begin)
+		{
+			++LineIndex;
+		}
+
+		// Spaces at the end of wrapped lines are not drawn
+		if (Codepoint >= Lines[LineIndex].End)
+		{
+			continue;
+		}
+
+		Glyphs->push_back(Text.Glyphs[GlyphIndex]);
+
+		glyph_data& Glyph = Glyphs->back();
+		Glyph.Position.x += Origin.x - Text.Offsets[Lines[LineIndex].Begin];
+		Glyph.Position.y  = Origin.y - LineIndex * Text.LineHeight;
+		Glyph.FillColor   = FillColor;
+	}
+}
+
+void layout_source::Assign(const layout_key& Key)
+{
+	m_Params = Key.Params;
+	m_Bytes.assign((const u8*)Key.Text, (const u8*)Key.Text + Key.Size);
+}
+
+bool layout_source::Matches(const layout_key& Key) const
+{
+	const layout_params& Params = Key.Params;
+
+	if (Params.CodeUnitSize != m_Params.CodeUnitSize || Params.FontIndex != m_Params.FontIndex || Params.PixelSize != m_Params.PixelSize ||
+	    Params.Generation != m_Params.Generation || Params.Kerning != m_Params.Kerning)
+	{
+		return false;
+	}
+
+	return Key.Size == m_Bytes.size() && (Key.Size == 0 || memcmp(Key.Text, m_Bytes.data(), Key.Size) == 0);
+}
+
+const shaped_text* layout_cache::Find(const layout_key& Key)
+{
+	auto Iterator = m_Lookup.find(Key.Hash);
+
+	if (Iterator == m_Lookup.end() || !Iterator->second->Source.Matches(Key))
+	{
+		m_Stats.Misses += 1;
+		return nullptr;
+	}
+
+	m_Stats.Hits += 1;
+
+	// Move to the front, iterators stay valid
+	m_Entries.splice(m_Entries.begin(), m_Entries, Iterator->second);
+
+	return &Iterator->second->Text;
+}
+
+const shaped_text* layout_cache::Insert(const layout_key& Key, shaped_text&& Text)
+{
+	// Also replaces the entry of another text whose key collides
+	auto Iterator = m_Lookup.find(Key.Hash);
+
+	if (Iterator != m_Lookup.end())
+	{
+		m_Stats.MemoryUsed -= GetEntrySize(*Iterator->second);
+		m_Entries.erase(Iterator->second);
+		m_Lookup.erase(Iterator);
+	}
+
+	m_Entries.push_front({Key.Hash, layout_source(), eastl::move(Text)});
+	m_Entries.front().Source.Assign(Key);
+	m_Lookup[Key.Hash] = m_Entries.begin();
+
+	m_Stats.MemoryUsed += GetEntrySize(m_Entries.front());
+
+	Evict();
+
+	m_Stats.EntryCount = (u32)m_Lookup.size();
+
+	return &m_Entries.front().Text;
+}
+
+void layout_cache::Clear()
+{
+	m_Entries.clear();
+	m_Lookup.clear();
+
+	m_Stats.MemoryUsed = 0;
+	m_Stats.EntryCount = 0;
+}
+
+void layout_cache::SetMemoryBudget(u64 MemoryBudget)
+{
+	m_MemoryBudget = MemoryBudget;
+
+	Evict();
+
+	m_Stats.EntryCount = (u32)m_Lookup.size();
+}
+
+u64 layout_cache::GetEntrySize(const entry& Entry)
+{
+	// List node and lookup entry are approximated by the entry itself
+	return 2 * sizeof(entry) + Entry.Source.GetMemoryUsage() + Entry.Text.GetMemoryUsage();
+}
+
+void layout_cache::Evict()
+{
+	// The most recent entry is always kept, even when it is larger than the budget on its own
+	while (m_Stats.MemoryUsed > m_MemoryBudget && m_Entries.size() > 1)
+	{
+		const entry& Entry = m_Entries.back();
+
+		m_Stats.MemoryUsed -= GetEntrySize(Entry);
+		m_Stats.Evictions += 1;
+
+		m_Lookup.erase(Entry.Key);
+		m_Entries.pop_back();
+	}
+}
+
+u32 glyph_range_allocator::Allocate(u32 Count)
+{
+	for (u32 RangeIndex = 0; RangeIndex < (u32)m_FreeRanges.size(); ++RangeIndex)
+	{
+		range& Range = m_FreeRanges[RangeIndex];
+
+		if (Range.Count < Count)
+		{
+			continue;
+		}
+
+		const u32 Offset = Range.Offset;
+
+		Range.Offset += Count;
+		Range.Count -= Count;
+
+		if (Range.Count == 0)
+		{
+			m_FreeRanges.erase(m_FreeRanges.begin() + RangeIndex);
+		}
+
+		return Offset;
+	}
+
+	const u32 Offset = m_Size;
+	m_Size += Count;
+
+	return Offset;
+}
+
+void glyph_range_allocator::Free(u32 Offset, u32 Count)
+{
+	if (Count == 0)
+	{
+		return;
+	}
+
+	auto Iterator = eastl::lower_bound(m_FreeRanges.begin(), m_FreeRanges.end(), Offset, [](const range& Range, u32 Value) {
+		return Range.Offset < Value;
+	});
+
+	Iterator = m_FreeRanges.insert(Iterator, {Offset, Count});
+
+	// Merge with the next range, then with the previous one
+	auto Next = Iterator + 1;
+	if (Next != m_FreeRanges.end() && Iterator->Offset + Iterator->Count == Next->Offset)
+	{
+		Iterator->Count += Next->Count;
+		m_FreeRanges.erase(Next);
+	}
+
+	if (Iterator != m_FreeRanges.begin())
+	{
+		auto Previous = Iterator - 1;
+		if (Previous->Offset + Previous->Count == Iterator->Offset)
+		{
+			Previous->Count += Iterator->Count;
+			m_FreeRanges.erase(Iterator);
+		}
+	}
+}
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <gluon/api/gln_renderer.h>
+
+#include <gluon/core/gln_defines.h>
+#include <gluon/core/gln_color.h>
+
+#include <EASTL/vector.h>
+#include <EASTL/list.h>
+#include <EASTL/unordered_map.h>
+
+/// This is a private header, it should not be included outside of the gluon api files.
+namespace gluon
+{
+#pragma pack(push, 1)
+struct glyph_data
+{
+	vec2  Position;  // "World" position
+	vec2  Translate; // Internal translation (position w.r.t to glyph's (0, 0))
+	vec2  Scale;     // Rectangle size
+	f32   GlobalScale;
+	f32   Padding;
+	vec4  Texcoords; // tx = int(x + 1.5), ty = int(y + 1.5) + 1
+	color FillColor;
+	u32   TextureIndex; // Font texture array in the high 16 bits, layer in the low ones
+	u32   ObjectIndex;  // k_NoTextObject for immediate texts, see text_object_data
+	vec2  Padding2;
+};
+#pragma pack(pop)
+
+static constexpr u32 k_NoTextObject = 0xFFFFFFFF;
+
+//! Per object record of retained texts, glyph positions are relative to Position
+#pragma pack(push, 1)
+struct text_object_data
+{
+	vec2  Position;
+	f32   Visible;
+	f32   Padding;
+	color FillColor;
+};
+#pragma pack(pop)
+
+using glyph_run = eastl::vector<glyph_data>;
+
+//! Line break opportunity. End is the first codepoint not drawn on the line (trailing spaces or the line feed), Next is the first
+//! codepoint of the following line.
+struct line_break
+{
+	u32  End;
+	u32  Next;
+	bool Mandatory;
+};
+
+struct text_line
+{
+	u32 Begin;
+	u32 End;
+	f32 Width;
+};
+
+//! A text laid out on a single baseline, which can then be broken in lines at any width without being laid out again
+struct shaped_text
+{
+	// Position.x is the pen position of the glyph, GlyphCodepoints the index of the codepoint it was made from
+	glyph_run          Glyphs;
+	eastl::vector<u32> GlyphCodepoints;
+
+	// Pen position before each codepoint, that is the prefix sum of the advances with kerning applied, plus the total advance
+	eastl::vector<f32> Offsets;
+
+	// Sorted by End. Mandatory ones are also indexed on their own, so that breaking stops at them without scanning.
+	eastl::vector<line_break> Breaks;
+	eastl::vector<u32>        MandatoryBreaks;
+
+	f32 LineHeight = 0.0f;
+
+	// Pages of a dynamic atlas the glyphs are stored in, drawing the text keeps them resident, @see dynamic_font
+	u32 PageMask = 0;
+
+	void Clear();
+	u64  GetMemoryUsage() const;
+};
+
+//! Greedy line breaking, costs O(log n) per line. Words wider than MaxWidth overflow, MaxWidth <= 0 only breaks at line feeds.
+void BreakLines(const shaped_text& Text, f32 MaxWidth, eastl::vector<text_line>* Lines);
+
+//! Appends the glyphs of the text, broken in Lines, translated to Origin
+void PlaceGlyphs(const shaped_text& Text, const eastl::vector<text_line>& Lines, vec2 Origin, color FillColor, glyph_run* Glyphs);
+
+//! Hands out ranges of the retained glyph buffer, first fit. Freed ranges are coalesced, the buffer only grows at its end.
+class glyph_range_allocator
+{
+public:
+	u32  Allocate(u32 Count);
+	void Free(u32 Offset, u32 Count);
+
+	//! Number of glyphs spanned by the ranges, free ones in between included
+	u32 GetSize() const { return m_Size; }
+
+private:
+	struct range
+	{
+		u32 Offset;
+		u32 Count;
+	};
+
+	// Sorted by offset
+	eastl::vector<range> m_FreeRanges;
+	u32                  m_Size = 0;
+};
+
+//! Everything a layout depends on besides the string. The code unit size tells UTF-8 and UTF-32 bytes apart, the generation changes
+//! once the fallback font is replaced or the glyphs of a dynamic font change.
+struct layout_params
+{
+	u32  CodeUnitSize = 0;
+	u32  FontIndex    = 0;
+	f32  PixelSize    = 0.0f;
+	u32  Generation   = 0;
+	bool Kerning      = false;
+};
+
+//! A layout as looked up in the caches: the hash of the string and of its parameters, and what it was computed from. The string is
+//! not owned.
+struct layout_key
+{
+	u64           Hash = 0;
+	layout_params Params;
+	const void*   Text = nullptr;
+	u64           Size = 0;
+};
+
+//! Copy of the string and parameters of a layout_key, kept by cached entries so that hits are told apart from hash collisions
+class layout_source
+{
+public:
+	void Assign(const layout_key& Key);
+	bool Matches(const layout_key& Key) const;
+
+	u64 GetMemoryUsage() const { return m_Bytes.capacity(); }
+
+private:
+	layout_params     m_Params;
+	eastl::vector<u8> m_Bytes;
+};
+
+//! Shaped texts, keyed by a hash of everything the layout depends on. Hits are compared with the string and parameters of the entry,
+//! a collision is a miss. Least recently used texts are evicted when the memory budget is exceeded.
+class layout_cache
+{
+public:
+	static constexpr u64 k_DefaultMemoryBudget = 4 * 1024 * 1024;
+
+	//! Returns nullptr on misses, the text stays valid until the next Insert()
+	const shaped_text* Find(const layout_key& Key);
+	const shaped_text* Insert(const layout_key& Key, shaped_text&& Text);
+
+	void Clear();
+	void SetMemoryBudget(u64 MemoryBudget);
+
+	const layout_cache_stats& GetStats() const { return m_Stats; }
+
+private:
+	struct entry
+	{
+		u64           Key;
+		layout_source Source;
+		shaped_text   Text;
+	};
+
+	using entry_list = eastl::list<entry>;
+
+	static u64 GetEntrySize(const entry& Entry);
+
+	void Evict();
+
+	// Most recently used first
+	entry_list                                      m_Entries;
+	eastl::unordered_map<u64, entry_list::iterator> m_Lookup;
+	u64                                             m_MemoryBudget = k_DefaultMemoryBudget;
+	layout_cache_stats                              m_Stats;
+};
+}
@@ -0,0 +1,329 @@
+#include <gluon/api/gln_text_shaper_p.h>
+
+namespace gluon
+{
+// Thai and Lao share their layout, Lao codepoints are the Thai ones plus 0x80
+static constexpr u32 k_ThaiLaoMask = ~0x80u;
+
+static bool IsThaiOrLao(u32 Codepoint) { return Codepoint >= 0x0E00 && Codepoint <= 0x0EFF; }
+
+static bool IsThaiLaoMark(u32 Codepoint)
+{
+	const u32 Thai = Codepoint & k_ThaiLaoMask;
+	return IsThaiOrLao(Codepoint) && (Thai == 0x0E31 || (Thai >= 0x0E34 && Thai <= 0x0E3C) || (Thai >= 0x0E47 && Thai <= 0x0E4E));
+}
+
+static bool IsCombiningMark(u32 Codepoint)
+{
+	return (Codepoint >= 0x0300 && Codepoint <= 0x036F) || (Codepoint >= 0x1AB0 && Codepoint <= 0x1AFF) ||
+	       (Codepoint >= 0x1DC0 && Codepoint <= 0x1DFF) || (Codepoint >= 0x20D0 && Codepoint <= 0x20FF) ||
+	       (Codepoint >= 0xFE20 && Codepoint <= 0xFE2F);
+}
+
+// SARA AM is drawn as a NIKHAHIT over the consonant followed by a SARA AA
+static bool IsSaraAm(u32 Codepoint) { return (Codepoint & k_ThaiLaoMask) == 0x0E33; }
+
+static u32 NikhahitFromSaraAm(u32 Codepoint) { return Codepoint - 0x0E33 + 0x0E4D; }
+static u32 SaraAaFromSaraAm(u32 Codepoint) { return Codepoint - 1; }
+
+//! Marks the NIKHAHIT of a SARA AM goes before, so that they are stacked above it
+static bool IsAboveMark(u32 Codepoint)
+{
+	const u32 Thai = Codepoint & k_ThaiLaoMask;
+	return IsThaiOrLao(Codepoint) &&
+	       (Thai == 0x0E31 || Thai == 0x0E3B || (Thai >= 0x0E34 && Thai <= 0x0E37) || (Thai >= 0x0E47 && Thai <= 0x0E4E));
+}
+
+// Fonts without GSUB tables, which are the only ones our atlases can represent, place Thai marks for the common case and provide
+// shifted variants in the private use area, following the Windows convention. The variant of a mark depends on the consonant it
+// sits on and on the marks before it, which two small state machines track.
+enum thai_consonant_type
+{
+	ThaiConsonant_Normal,
+	ThaiConsonant_Ascender,           // Tall, above marks are shifted left
+	ThaiConsonant_RemovableDescender, // Its descender is removed when a below mark is attached
+	ThaiConsonant_Descender,          // Below marks are shifted down
+	ThaiConsonant_None,
+
+	ThaiConsonant_Count,
+};
+
+enum thai_mark_type
+{
+	ThaiMark_AboveVowel,
+	ThaiMark_BelowVowel,
+	ThaiMark_Tone,
+	ThaiMark_None,
+
+	ThaiMark_Count = ThaiMark_None,
+};
+
+enum thai_action
+{
+	ThaiAction_None,
+	ThaiAction_ShiftDown,
+	ThaiAction_ShiftLeft,
+	ThaiAction_ShiftDownLeft,
+	ThaiAction_RemoveDescender,
+};
+
+static thai_consonant_type GetThaiConsonantType(u32 Codepoint)
+{
+	if (Codepoint == 0x0E1B || Codepoint == 0x0E1D || Codepoint == 0x0E1F)
+	{
+		return ThaiConsonant_Ascender;
+	}
+
+	if (Codepoint == 0x0E0D || Codepoint == 0x0E10)
+	{
+		return ThaiConsonant_RemovableDescender;
+	}
+
+	if (Codepoint == 0x0E0E || Codepoint == 0x0E0F)
+	{
+		return ThaiConsonant_Descender;
+	}
+
+	if (Codepoint >= 0x0E01 && Codepoint <= 0x0E2E)
+	{
+		return ThaiConsonant_Normal;
+	}
+
+	return ThaiConsonant_None;
+}
+
+static thai_mark_type GetThaiMarkType(u32 Codepoint)
+{
+	if (Codepoint == 0x0E31 || (Codepoint >= 0x0E34 && Codepoint <= 0x0E37) || Codepoint == 0x0E47 || Codepoint == 0x0E4D ||
+	    Codepoint == 0x0E4E)
+	{
+		return ThaiMark_AboveVowel;
+	}
+
+	if (Codepoint >= 0x0E38 && Codepoint <= 0x0E3A)
+	{
+		return ThaiMark_BelowVowel;
+	}
+
+	if (Codepoint >= 0x0E48 && Codepoint <= 0x0E4C)
+	{
+		return ThaiMark_Tone;
+	}
+
+	return ThaiMark_None;
+}
+
+struct thai_edge
+{
+	thai_action Action;
+	u32         NextState;
+};
+
+// Above marks: 0 on a normal consonant, 1 on an ascender one, 2 after a shifted mark, 3 once nothing moves anymore
+static constexpr u32 k_ThaiAboveStartStates[ThaiConsonant_Count] = {0, 1, 0, 0, 3};
+
+static constexpr thai_edge k_ThaiAboveStates[4][ThaiMark_Count] = {
+    //   Above vowel                      Below vowel                Tone
+    {{ThaiAction_None, 3}, {ThaiAction_None, 0}, {ThaiAction_ShiftDown, 3}},
+    {{ThaiAction_ShiftLeft, 2}, {ThaiAction_None, 1}, {ThaiAction_ShiftDownLeft, 2}},
+    {{ThaiAction_None, 3}, {ThaiAction_None, 2}, {ThaiAction_ShiftLeft, 3}},
+    {{ThaiAction_None, 3}, {ThaiAction_None, 3}, {ThaiAction_None, 3}},
+};
+
+// Below marks: 0 on a normal consonant, 1 on a removable descender, 2 on a descender
+static constexpr u32 k_ThaiBelowStartStates[ThaiConsonant_Count] = {0, 0, 1, 2, 2};
+
+static constexpr thai_edge k_ThaiBelowStates[3][ThaiMark_Count] = {
+    //   Above vowel                      Below vowel                Tone
+    {{ThaiAction_None, 0}, {ThaiAction_None, 2}, {ThaiAction_None, 0}},
+    {{ThaiAction_None, 1}, {ThaiAction_RemoveDescender, 2}, {ThaiAction_None, 1}},
+    {{ThaiAction_None, 2}, {ThaiAction_ShiftDown, 2}, {ThaiAction_None, 2}},
+};
+
+struct thai_variant
+{
+	u32 Codepoint;
+	u32 Variant;
+};
+
+static constexpr thai_variant k_ThaiShiftDown[] = {
+    {0x0E48, 0xF70A}, // MAI EK
+    {0x0E49, 0xF70B}, // MAI THO
+    {0x0E4A, 0xF70C}, // MAI TRI
+    {0x0E4B, 0xF70D}, // MAI CHATTAWA
+    {0x0E4C, 0xF70E}, // THANTHAKHAT
+    {0x0E38, 0xF718}, // SARA U
+    {0x0E39, 0xF719}, // SARA UU
+    {0x0E3A, 0xF71A}, // PHINTHU
+};
+
+static constexpr thai_variant k_ThaiShiftDownLeft[] = {
+    {0x0E48, 0xF705}, // MAI EK
+    {0x0E49, 0xF706}, // MAI THO
+    {0x0E4A, 0xF707}, // MAI TRI
+    {0x0E4B, 0xF708}, // MAI CHATTAWA
+    {0x0E4C, 0xF709}, // THANTHAKHAT
+};
+
+static constexpr thai_variant k_ThaiShiftLeft[] = {
+    {0x0E48, 0xF713}, // MAI EK
+    {0x0E49, 0xF714}, // MAI THO
+    {0x0E4A, 0xF715}, // MAI TRI
+    {0x0E4B, 0xF716}, // MAI CHATTAWA
+    {0x0E4C, 0xF717}, // THANTHAKHAT
+    {0x0E31, 0xF710}, // MAI HAN-AKAT
+    {0x0E34, 0xF701}, // SARA I
+    {0x0E35, 0xF702}, // SARA II
+    {0x0E36, 0xF703}, // SARA UE
+    {0x0E37, 0xF704}, // SARA UEE
+    {0x0E47, 0xF712}, // MAITAIKHU
+    {0x0E4D, 0xF711}, // NIKHAHIT
+};
+
+static constexpr thai_variant k_ThaiRemoveDescender[] = {
+    {0x0E0D, 0xF70F}, // YO YING
+    {0x0E10, 0xF700}, // THO THAN
+};
+
+template <u32 N>
+static u32 FindThaiVariant(const thai_variant (&Variants)[N], u32 Codepoint)
+{
+	for (const thai_variant& Variant : Variants)
+	{
+		if (Variant.Codepoint == Codepoint)
+		{
+			return Variant.Variant;
+		}
+	}
+
+	return Codepoint;
+}
+
+static u32 GetThaiVariant(u32 Codepoint, thai_action Action, const glyph_query& HasGlyph)
+{
+	u32 Variant = Codepoint;
+
+	switch (Action)
+	{
+		case ThaiAction_ShiftDown:
+			Variant = FindThaiVariant(k_ThaiShiftDown, Codepoint);
+			break;
+
+		case ThaiAction_ShiftLeft:
+			Variant = FindThaiVariant(k_ThaiShiftLeft, Codepoint);
+			break;
+
+		case ThaiAction_ShiftDownLeft:
+			Variant = FindThaiVariant(k_ThaiShiftDownLeft, Codepoint);
+			break;
+
+		case ThaiAction_RemoveDescender:
+			Variant = FindThaiVariant(k_ThaiRemoveDescender, Codepoint);
+			break;
+
+		case ThaiAction_None:
+			break;
+	}
+
+	// Fonts without the variant still draw the mark, only less precisely
+	return (Variant != Codepoint && HasGlyph(Variant)) ? Variant : Codepoint;
+}
+
+static void SubstituteThaiMarks(const glyph_query& HasGlyph, eastl::vector<shaped_glyph>* Glyphs)
+{
+	u32 AboveState = k_ThaiAboveStartStates[ThaiConsonant_None];
+	u32 BelowState = k_ThaiBelowStartStates[ThaiConsonant_None];
+	u32 Base       = 0;
+
+	for (u32 GlyphIndex = 0; GlyphIndex < (u32)Glyphs->size(); ++GlyphIndex)
+	{
+		shaped_glyph&        Glyph    = (*Glyphs)[GlyphIndex];
+		const thai_mark_type MarkType = GetThaiMarkType(Glyph.Codepoint);
+
+		if (MarkType == ThaiMark_None)
+		{
+			const thai_consonant_type ConsonantType = GetThaiConsonantType(Glyph.Codepoint);
+
+			AboveState = k_ThaiAboveStartStates[ConsonantType];
+			BelowState = k_ThaiBelowStartStates[ConsonantType];
+			Base       = GlyphIndex;
+			continue;
+		}
+
+		const thai_edge& AboveEdge = k_ThaiAboveStates[AboveState][MarkType];
+		const thai_edge& BelowEdge = k_ThaiBelowStates[BelowState][MarkType];
+
+		AboveState = AboveEdge.NextState;
+		BelowState = BelowEdge.NextState;
+
+		// At most one of them does something
+		const thai_action Action = AboveEdge.Action != ThaiAction_None ? AboveEdge.Action : BelowEdge.Action;
+
+		if (Action == ThaiAction_RemoveDescender)
+		{
+			(*Glyphs)[Base].Codepoint = GetThaiVariant((*Glyphs)[Base].Codepoint, Action, HasGlyph);
+		}
+		else
+		{
+			Glyph.Codepoint = GetThaiVariant(Glyph.Codepoint, Action, HasGlyph);
+		}
+	}
+}
+
+namespace priv
+{
+	bool NeedsShaping(u32 Codepoint) { return IsThaiOrLao(Codepoint) || IsCombiningMark(Codepoint); }
+
+	bool ShapeRun(const u32* Codepoints, u32 Count, const glyph_query& HasGlyph, eastl::vector<shaped_glyph>* Glyphs)
+	{
+		bool HasThai    = false;
+		bool HasComplex = false;
+
+		for (u32 Index = 0; Index < Count; ++Index)
+		{
+			HasThai    = HasThai || (Codepoints[Index] >= 0x0E00 && Codepoints[Index] <= 0x0E7F);
+			HasComplex = HasComplex || NeedsShaping(Codepoints[Index]);
+		}
+
+		if (!HasComplex)
+		{
+			return false;
+		}
+
+		Glyphs->clear();
+		Glyphs->reserve(Count + 1);
+
+		for (u32 Index = 0; Index < Count; ++Index)
+		{
+			const u32 Codepoint = Codepoints[Index];
+
+			if (!IsSaraAm(Codepoint))
+			{
+				Glyphs->push_back({Codepoint, Index, IsThaiLaoMark(Codepoint) || IsCombiningMark(Codepoint)});
+				continue;
+			}
+
+			// The NIKHAHIT moves before the above marks of the cluster, which join the cluster of the first of them
+			u32 Insert = (u32)Glyphs->size();
+
+			while (Insert > 0 && IsAboveMark((*Glyphs)[Insert - 1].Codepoint))
+			{
+				--Insert;
+			}
+
+			const u32          Cluster  = Insert < (u32)Glyphs->size() ? (*Glyphs)[Insert].Cluster : Index;
+			const shaped_glyph Nikhahit = {NikhahitFromSaraAm(Codepoint), Cluster, true};
+
+			Glyphs->insert(Glyphs->begin() + Insert, Nikhahit);
+			Glyphs->push_back({SaraAaFromSaraAm(Codepoint), Index, false});
+		}
+
+		if (HasThai)
+		{
+			SubstituteThaiMarks(HasGlyph, Glyphs);
+		}
+
+		return true;
+	}
+}
+}
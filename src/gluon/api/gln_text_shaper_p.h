@@ -0,0 +1,33 @@
+#pragma once
+
+#include <gluon/core/gln_defines.h>
+
+#include <EASTL/vector.h>
+#include <EASTL/functional.h>
+
+/// This is a private header, it should not be included outside of the gluon api files.
+namespace gluon
+{
+//! Glyph produced by the shaper. Atlases are indexed by codepoint, so glyphs are named by the codepoint of the form drawn, which
+//! differs from the text one for presentation forms.
+struct shaped_glyph
+{
+	u32  Codepoint;
+	u32  Cluster; // Index of the text codepoint the glyph is drawn for, never decreases along the run
+	bool IsMark;  // Drawn over the previous base glyph, does not advance
+};
+
+//! Tells whether the font has a glyph for a codepoint, presentation forms are only used when it does
+using glyph_query = eastl::function<bool(u32 Codepoint)>;
+
+namespace priv
+{
+	//! Codepoints ShapeRun() may reorder or substitute, texts without any are laid out one glyph per codepoint
+	bool NeedsShaping(u32 Codepoint);
+
+	//! In-tree shaper for combining marks and the Thai and Lao scripts, which only need cluster local reordering and mark
+	//! substitutions. Returns false without touching Glyphs when every codepoint maps to its own glyph, which is the case of
+	//! most texts, the caller then lays the codepoints out as they are.
+	bool ShapeRun(const u32* Codepoints, u32 Count, const glyph_query& HasGlyph, eastl::vector<shaped_glyph>* Glyphs);
+}
+}
@@ -0,0 +1,214 @@
+#include <gluon/api/gln_text_view.h>
+#include <gluon/api/gln_renderer_p.h>
+#include <gluon/api/gln_row_index_p.h>
+
+#include <gluon/core/gln_math.h>
+
+#include <EASTL/vector.h>
+#include <EASTL/algorithm.h>
+
+#include <string.h>
+
+namespace gluon
+{
+struct text_view_impl
+{
+	const char* Text = nullptr;
+	u64         Size = 0;
+
+	// Byte offset of the start of each line
+	eastl::vector<u64> LineStarts;
+	row_index          Rows;
+
+	font_handle Font      = GLUON_INVALID_HANDLE;
+	f32         PixelSize = 16.0f;
+
+	bool Wrapping = false;
+
+	// Top of the view, as a row of a line and an offset in pixels within that row
+	u32 ScrollLine   = 0;
+	u32 ScrollRow    = 0;
+	f32 ScrollOffset = 0.0f;
+
+	//! Indexes the lines starting in [From, Size)
+	void IndexLines(u64 From)
+	{
+		while (From < Size)
+		{
+			const char* LineFeed = (const char*)memchr(Text + From, '\n', Size - From);
+
+			if (LineFeed == nullptr)
+			{
+				break;
+			}
+
+			From = (u64)(LineFeed - Text) + 1;
+			LineStarts.push_back(From);
+		}
+	}
+
+	void GetLine(u32 Line, const char** Begin, u64* Size) const
+	{
+		const u64 Start = LineStarts[Line];
+		u64       End   = Line + 1 < (u32)LineStarts.size() ? LineStarts[Line + 1] - 1 : this->Size;
+
+		if (End > Start && Text[End - 1] == '\r')
+		{
+			--End;
+		}
+
+		*Begin = Text + Start;
+		*Size  = End - Start;
+	}
+};
+
+text_view::text_view() { m_View = new text_view_impl(); }
+
+text_view::~text_view() { delete m_View; }
+
+void text_view::SetText(const char* Text, u64 Size)
+{
+	m_View->Text = Text;
+	m_View->Size = Size;
+
+	m_View->LineStarts.clear();
+	m_View->LineStarts.push_back(0);
+	m_View->IndexLines(0);
+
+	m_View->Rows.Reset((u32)m_View->LineStarts.size());
+}
+
+void text_view::ExtendText(const char* Text, u64 Size)
+{
+	if (m_View->LineStarts.empty() || Size < m_View->Size)
+	{
+		SetText(Text, Size);
+		return;
+	}
+
+	const u64 PreviousSize      = m_View->Size;
+	const u32 PreviousLineCount = (u32)m_View->LineStarts.size();
+
+	m_View->Text = Text;
+	m_View->Size = Size;
+	m_View->IndexLines(PreviousSize);
+
+	for (u32 Line = PreviousLineCount; Line < (u32)m_View->LineStarts.size(); ++Line)
+	{
+		m_View->Rows.Append(1);
+	}
+}
+
+void text_view::SetFont(font_handle Font, f32 PixelSize)
+{
+	m_View->Font      = Font;
+	m_View->PixelSize = PixelSize;
+
+	// Wrapped heights depend on the font
+	if (m_View->Wrapping)
+	{
+		m_View->Rows.Reset((u32)m_View->LineStarts.size());
+	}
+}
+
+void text_view::SetWrapping(bool Enabled)
+{
+	if (m_View->Wrapping != Enabled)
+	{
+		m_View->Wrapping = Enabled;
+		m_View->Rows.Reset((u32)m_View->LineStarts.size());
+	}
+}
+
+void text_view::SetScroll(f64 Scroll)
+{
+	text_view_impl* View = m_View;
+
+	if (View->LineStarts.empty())
+	{
+		return;
+	}
+
+	Scroll = eastl::max(Scroll, 0.0);
+
+	const u64 Row  = (u64)(Scroll / View->PixelSize);
+	const u32 Line = View->Rows.FindLine(Row);
+
+	// Past the end of the text, the bottom of the last line
+	const u64 LineRow = eastl::min(Row - eastl::min(Row, View->Rows.GetRowOffset(Line)), (u64)View->Rows.GetRowCount(Line) - 1);
+
+	View->ScrollLine   = Line;
+	View->ScrollRow    = (u32)LineRow;
+	View->ScrollOffset = Clamp((f32)(Scroll - (f64)(View->Rows.GetRowOffset(Line) + LineRow) * View->PixelSize), 0.0f, View->PixelSize);
+}
+
+void text_view::ScrollToLine(u32 Line)
+{
+	m_View->ScrollLine   = eastl::min(Line, GetLineCount() > 0 ? GetLineCount() - 1 : 0);
+	m_View->ScrollRow    = 0;
+	m_View->ScrollOffset = 0.0f;
+}
+
+f64 text_view::GetScroll() const
+{
+	const text_view_impl* View = m_View;
+
+	return (f64)(View->Rows.GetRowOffset(View->ScrollLine) + View->ScrollRow) * View->PixelSize + View->ScrollOffset;
+}
+
+u32 text_view::GetLineCount() const { return (u32)m_View->LineStarts.size(); }
+
+f64 text_view::GetContentHeight() const { return (f64)m_View->Rows.GetTotalRows() * m_View->PixelSize; }
+
+void text_view::Draw(f32 X, f32 Y, f32 Width, f32 Height, color FillColor)
+{
+	text_view_impl* View = m_View;
+
+	if (View->LineStarts.empty())
+	{
+		return;
+	}
+
+	// Lines are exactly PixelSize high, @see ShapeText()
+	const f32 RowHeight = View->PixelSize;
+	const f64 MaxScroll = eastl::max(GetContentHeight() - Height, 0.0);
+
+	// Resizing keeps the previous heights, lines are wrapped again at the new width as they become visible
+	if (View->ScrollLine >= (u32)View->LineStarts.size() || GetScroll() > MaxScroll)
+	{
+		SetScroll(MaxScroll);
+	}
+
+	View->ScrollRow = eastl::min(View->ScrollRow, View->Rows.GetRowCount(View->ScrollLine) - 1);
+
+	// Relative to the top of the view, so that pixel positions stay small whatever the size of the text
+	f32 Top = -(View->ScrollRow * RowHeight + View->ScrollOffset);
+
+	const f32 MaxWidth = View->Wrapping ? Width : 0.0f;
+
+	for (u32 Line = View->ScrollLine; Line < (u32)View->LineStarts.size(); ++Line)
+	{
+		if (Top >= Height)
+		{
+			break;
+		}
+
+		const char* Text;
+		u64         Size;
+		View->GetLine(Line, &Text, &Size);
+
+		const u32 DrawnRows = priv::DrawTextLine(Text, Size, View->Font, View->PixelSize, MaxWidth, X, Y - Top, FillColor);
+
+		// Nothing is drawn while the font is loading, the estimated heights are kept meanwhile
+		u32 Rows = View->Rows.GetRowCount(Line);
+
+		if (DrawnRows > 0 && DrawnRows != Rows)
+		{
+			View->Rows.Add(Line, (i32)DrawnRows - (i32)Rows);
+			Rows = DrawnRows;
+		}
+
+		Top += Rows * RowHeight;
+	}
+}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <gluon/api/gln_api_defs.h>
+#include <gluon/api/gln_renderer.h>
+
+#include <gluon/core/gln_defines.h>
+#include <gluon/core/gln_color.h>
+
+namespace gluon
+{
+struct text_view_impl;
+
+/**
+ * Read only view over a large UTF-8 text, such as a log file. Line starts are indexed once, then each frame only lays out and
+ * draws the lines inside the view, whatever the size of the text. The text is not copied, it must outlive the view (a mapped
+ * file works well).
+ */
+class GLUON_API_EXPORT text_view
+{
+public:
+	text_view();
+	~text_view();
+
+	text_view(const text_view&)            = delete;
+	text_view& operator=(const text_view&) = delete;
+
+	void SetText(const char* Text, u64 Size);
+
+	//! For texts that grow, such as logs. Only what follows the previous size is indexed, Text may have moved meanwhile.
+	void ExtendText(const char* Text, u64 Size);
+
+	void SetFont(font_handle Font, f32 PixelSize);
+
+	//! Long lines are wrapped to the width of the view, disabled by default
+	void SetWrapping(bool Enabled);
+
+	//! Offset in pixels from the top of the text. The view is anchored on a row of a line, so it stays on the same text when
+	//! lines above it are wrapped again, and a f32 would not address the rows of the largest texts anyway.
+	void SetScroll(f64 Scroll);
+	void ScrollToLine(u32 Line);
+	f64  GetScroll() const;
+
+	u32 GetLineCount() const;
+
+	//! Wrapped lines count as a single row until they have been drawn once. Resizing the view does not reset them, each line keeps
+	//! the height it had when it was last drawn until it is drawn again.
+	f64 GetContentHeight() const;
+
+	//! X, Y is the top left corner of the view, in DrawText() coordinates
+	void Draw(f32 X, f32 Y, f32 Width, f32 Height, color FillColor);
+
+private:
+	text_view_impl* m_View;
+};
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <gluon/core/gln_defines.h>
+
+#include <string.h>
+
+namespace gluon
+{
+//! File compiled into the binary, @see cmake/GluonEmbedFiles.cmake. Data is always null terminated, Size does not include the terminator.
+struct embedded_file
+{
+	const char* Name;
+	const u8*   Data;
+	u64         Size;
+};
+
+//! Generated tables end with a null entry
+inline const embedded_file* FindEmbeddedFile(const embedded_file* Files, const char* Name)
+{
+	for (; Files->Name != nullptr; ++Files)
+	{
+		if (strcmp(Files->Name, Name) == 0)
+		{
+			return Files;
+		}
+	}
+
+	return nullptr;
+}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <gluon/core/gln_defines.h>
+
+namespace gluon
+{
+static constexpr u64 k_HashSeed = 0xcbf29ce484222325ull;
+
+//! 64 bits FNV-1a, used for cache keys and lookup tables. Not suited for hash flooding resistant tables.
+inline u64 Hash(const void* Data, u64 Size, u64 Seed = k_HashSeed)
+{
+	const u8* Bytes = (const u8*)Data;
+	u64       Hash  = Seed;
+
+	for (u64 Index = 0; Index < Size; ++Index)
+	{
+		Hash ^= Bytes[Index];
+		Hash *= 0x100000001b3ull;
+	}
+
+	return Hash;
+}
+
+inline u64 HashString(const char* String, u64 Seed = k_HashSeed)
+{
+	u64 Hash = Seed;
+
+	for (; String != nullptr && *String != '\0'; ++String)
+	{
+		Hash ^= (u8)*String;
+		Hash *= 0x100000001b3ull;
+	}
+
+	return Hash;
+}
+
+inline u64 HashCombine(u64 Seed, u64 Value) { return Hash(&Value, sizeof(Value), Seed); }
+}
@@ -42,6 +42,13 @@
 #	error "Platform which is neither 32 or 64 bits is not supported"
 #endif
 
+#define GLN_SIMD_SSE2 0
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	undef GLN_SIMD_SSE2
+#	define GLN_SIMD_SSE2 1
+#endif
+
 #define GLN_DEBUG 0
 #define GLN_RELWTIHDEBINFO 0
 #define GLN_RELEASE 0
@@ -71,7 +78,7 @@
 #elif GLN_COMPILER_MSVC
 #	define GLN_ALIGN(Expr, Align) __declspec(align(Align)) Expr
 #	define GLN_NO_VTABLE __declspec(novtable)
-#	define GLN_LIKEYLY(Expr) (Expr)
+#	define GLN_LIKELY(Expr) (Expr)
 #	define GLN_UNLIKELY(Expr) (Expr)
 #	define GLN_FORCE_INLINE __forceinline
 #	define GLN_NO_INLINE __declspec(noinline)
@@ -83,7 +90,7 @@
 #	define GLN_ASSERT(Expr)                                                                                                               \
 		do                                                                                                                                 \
 		{                                                                                                                                  \
-			if (!GLN_LIKEYLY(Expr))                                                                                                        \
+			if (!GLN_LIKELY(Expr))                                                                                                         \
 			{                                                                                                                              \
 				GLN_BREAKPOINT;                                                                                                            \
 			}                                                                                                                              \
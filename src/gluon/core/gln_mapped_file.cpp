@@ -0,0 +1,115 @@
+#include "gln_mapped_file.h"
+
+#if GLN_PLATFORM_WINDOWS
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+namespace gluon
+{
+#if GLN_PLATFORM_WINDOWS
+bool MapFile(const char* FileName, mapped_file* File)
+{
+	HANDLE FileHandle = CreateFileA(FileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (FileHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER FileSize;
+	if (!GetFileSizeEx(FileHandle, &FileSize) || FileSize.QuadPart == 0)
+	{
+		CloseHandle(FileHandle);
+		return false;
+	}
+
+	HANDLE MappingHandle = CreateFileMappingA(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (MappingHandle == nullptr)
+	{
+		CloseHandle(FileHandle);
+		return false;
+	}
+
+	void* Data = MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+	if (Data == nullptr)
+	{
+		CloseHandle(MappingHandle);
+		CloseHandle(FileHandle);
+		return false;
+	}
+
+	File->Data          = (const u8*)Data;
+	File->Size          = (u64)FileSize.QuadPart;
+	File->FileHandle    = FileHandle;
+	File->MappingHandle = MappingHandle;
+
+	return true;
+}
+
+void UnmapFile(mapped_file* File)
+{
+	if (File->Data == nullptr)
+	{
+		return;
+	}
+
+	UnmapViewOfFile(File->Data);
+	CloseHandle(File->MappingHandle);
+	CloseHandle(File->FileHandle);
+
+	*File = mapped_file();
+}
+#else
+bool MapFile(const char* FileName, mapped_file* File)
+{
+	i32 Descriptor = open(FileName, O_RDONLY);
+
+	if (Descriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat Stat;
+	if (fstat(Descriptor, &Stat) != 0 || Stat.st_size == 0)
+	{
+		close(Descriptor);
+		return false;
+	}
+
+	void* Data = mmap(nullptr, (size_t)Stat.st_size, PROT_READ, MAP_PRIVATE, Descriptor, 0);
+
+	// The mapping stays valid once the descriptor is closed
+	close(Descriptor);
+
+	if (Data == MAP_FAILED)
+	{
+		return false;
+	}
+
+	File->Data = (const u8*)Data;
+	File->Size = (u64)Stat.st_size;
+
+	return true;
+}
+
+void UnmapFile(mapped_file* File)
+{
+	if (File->Data == nullptr)
+	{
+		return;
+	}
+
+	munmap((void*)File->Data, File->Size);
+
+	*File = mapped_file();
+}
+#endif
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <gluon/core/gln_defines.h>
+
+namespace gluon
+{
+//! Read only view of a whole file, backed by the OS page cache
+struct mapped_file
+{
+	const u8* Data = nullptr;
+	u64       Size = 0;
+
+	// Platform handles, the file handle is only used on Windows
+	void* FileHandle    = nullptr;
+	void* MappingHandle = nullptr;
+
+	bool IsValid() const { return Data != nullptr; }
+};
+
+bool MapFile(const char* FileName, mapped_file* File);
+void UnmapFile(mapped_file* File);
+}
@@ -1,3 +1,5 @@
+#pragma once
+
 #include <EASTL/chrono.h>
 
 namespace gluon
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <gluon/core/gln_defines.h>
+
+#include <string.h>
+
+#if GLN_SIMD_SSE2
+#	include <emmintrin.h>
+#endif
+
+#if GLN_COMPILER_MSVC
+#	include <intrin.h>
+#endif
+
+namespace gluon
+{
+static constexpr u32 k_ReplacementCodepoint = 0xFFFD;
+
+//! Index of the lowest set bit, Mask must not be 0
+GLN_FORCE_INLINE u32 CountTrailingZeros(u64 Mask)
+{
+#if GLN_COMPILER_MSVC
+	unsigned long Index;
+	_BitScanForward64(&Index, Mask);
+	return (u32)Index;
+#else
+	return (u32)__builtin_ctzll(Mask);
+#endif
+}
+
+//! Decodes UTF-8 in place, without any intermediate buffer. Runs of ASCII are detected 16 bytes at a time and then read as is,
+//! other sequences are validated: overlong forms, surrogates, codepoints above U+10FFFF, stray continuation bytes and truncated
+//! sequences all decode to U+FFFD.
+class utf8_decoder
+{
+public:
+	//! Smallest number of bytes a codepoint takes, bounds the codepoint count of a text from its size
+	static constexpr u32 k_MinCodepointSize = 1;
+
+	utf8_decoder(const char* Text, u64 Size)
+	    : m_Data((const u8*)Text)
+	    , m_End((const u8*)Text + Size)
+	{
+	}
+
+	explicit utf8_decoder(const char* Text)
+	    : utf8_decoder(Text, strlen(Text))
+	{
+	}
+
+	//! Returns false once the whole text has been read
+	GLN_FORCE_INLINE bool Next(u32* Codepoint)
+	{
+		if (GLN_LIKELY(m_Data < m_AsciiEnd))
+		{
+			*Codepoint = *m_Data++;
+			return true;
+		}
+
+		if (m_Data >= m_End)
+		{
+			return false;
+		}
+
+		// Scanning only pays off for ASCII, texts in other scripts go straight to the sequence decoder
+		if (*m_Data >= 0x80)
+		{
+			*Codepoint = DecodeSequence();
+			return true;
+		}
+
+		m_AsciiEnd = m_Data + ScanAscii();
+		*Codepoint = *m_Data++;
+
+		return true;
+	}
+
+	const char* GetPosition() const { return (const char*)m_Data; }
+
+private:
+	//! Number of ASCII bytes starting at m_Data, up to 16
+	GLN_FORCE_INLINE u32 ScanAscii() const
+	{
+#if GLN_SIMD_SSE2
+		if (m_End - m_Data >= 16)
+		{
+			const __m128i Bytes = _mm_loadu_si128((const __m128i*)m_Data);
+			const u32     Mask  = (u32)_mm_movemask_epi8(Bytes);
+
+			return Mask == 0 ? 16 : CountTrailingZeros(Mask);
+		}
+#else
+		if (m_End - m_Data >= 8)
+		{
+			u64 Word;
+			memcpy(&Word, m_Data, sizeof(Word));
+
+			// Assumes a little endian target, like the rest of the code base
+			const u64 Mask = Word & 0x8080808080808080ull;
+
+			return Mask == 0 ? 8 : CountTrailingZeros(Mask) / 8;
+		}
+#endif
+
+		u32 Count = 0;
+		while (m_Data + Count < m_End && m_Data[Count] < 0x80)
+		{
+			++Count;
+		}
+
+		return Count;
+	}
+
+	//! Well formed 2 and 3 byte sequences, which cover the scripts of the BMP, are decoded without any loop
+	GLN_FORCE_INLINE u32 DecodeSequence()
+	{
+		const u32 Lead = m_Data[0];
+
+		if (m_End - m_Data >= 3)
+		{
+			const u32 Second = m_Data[1];
+			const u32 Third  = m_Data[2];
+
+			if (Lead >= 0xC2 && Lead <= 0xDF && (Second & 0xC0) == 0x80)
+			{
+				m_Data += 2;
+				return ((Lead & 0x1F) << 6) | (Second & 0x3F);
+			}
+
+			if ((Lead & 0xF0) == 0xE0 && (Second & 0xC0) == 0x80 && (Third & 0xC0) == 0x80)
+			{
+				const u32 Codepoint = ((Lead & 0x0F) << 12) | ((Second & 0x3F) << 6) | (Third & 0x3F);
+
+				// Overlong forms and surrogates
+				if (Codepoint >= 0x800 && (Codepoint & 0xF800) != 0xD800)
+				{
+					m_Data += 3;
+					return Codepoint;
+				}
+			}
+		}
+
+		return DecodeAnySequence();
+	}
+
+	u32 DecodeAnySequence()
+	{
+		const u8 Lead = *m_Data++;
+
+		u32 Length, Codepoint, MinCodepoint;
+
+		if (Lead >= 0xC2 && Lead <= 0xDF)
+		{
+			Length       = 2;
+			Codepoint    = Lead & 0x1F;
+			MinCodepoint = 0x80;
+		}
+		else if ((Lead & 0xF0) == 0xE0)
+		{
+			Length       = 3;
+			Codepoint    = Lead & 0x0F;
+			MinCodepoint = 0x800;
+		}
+		else if (Lead >= 0xF0 && Lead <= 0xF4)
+		{
+			Length       = 4;
+			Codepoint    = Lead & 0x07;
+			MinCodepoint = 0x10000;
+		}
+		else
+		{
+			// Continuation byte without a lead, or a lead byte which can only start an overlong or out of range sequence
+			return k_ReplacementCodepoint;
+		}
+
+		for (u32 Index = 1; Index < Length; ++Index)
+		{
+			// Truncated sequence, the byte that broke it is decoded on its own
+			if (m_Data >= m_End || (*m_Data & 0xC0) != 0x80)
+			{
+				return k_ReplacementCodepoint;
+			}
+
+			Codepoint = (Codepoint << 6) | (*m_Data++ & 0x3F);
+		}
+
+		if (Codepoint < MinCodepoint || Codepoint > 0x10FFFF || (Codepoint >= 0xD800 && Codepoint <= 0xDFFF))
+		{
+			return k_ReplacementCodepoint;
+		}
+
+		return Codepoint;
+	}
+
+	const u8* m_Data;
+	const u8* m_End;
+
+	// End of the bytes known to be ASCII from the last scan
+	const u8* m_AsciiEnd = nullptr;
+};
+}
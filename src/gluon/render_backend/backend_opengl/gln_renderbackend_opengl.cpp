@@ -1,12 +1,22 @@
 #include <gluon/render_backend/backend_opengl/gln_renderbackend_opengl.h>
 
 #include <gluon/core/gln_math.h>
+#include <gluon/core/gln_hash.h>
+#include <gluon/core/gln_timer.h>
+
+#include <gluon/render_backend/gln_program_cache_p.h>
 
 #include <glad/glad.h>
 #include <EASTL/array.h>
 #include <loguru.hpp>
 
 #include <stdio.h>
+#include <string.h>
+
+// Not part of the generated loader, only the enum is needed to poll the completion status
+#ifndef GL_COMPLETION_STATUS_KHR
+#	define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
 
 namespace gluon
 {
@@ -112,14 +122,48 @@ namespace gl
 	render_backend::~render_backend() { }
 
 	// Misc section
-	void render_backend::Initialize()
+	bool render_backend::Initialize()
 	{
 		if (!gladLoadGL())
 		{
-			LOG_F(FATAL, "Cannot load OpenGL functions");
+			LOG_F(ERROR, "Cannot load OpenGL functions");
+			return false;
 		}
 
 		LOG_F(INFO, "OpenGL:\n\tVersion %s\n\tVendor %s", glGetString(GL_VERSION), glGetString(GL_VENDOR));
+
+		m_DriverHash = HashString((const char*)glGetString(GL_VENDOR));
+		m_DriverHash = HashString((const char*)glGetString(GL_RENDERER), m_DriverHash);
+		m_DriverHash = HashString((const char*)glGetString(GL_VERSION), m_DriverHash);
+
+		GLint BinaryFormatCount = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &BinaryFormatCount);
+		m_ProgramBinarySupported = BinaryFormatCount > 0;
+
+		m_BinaryFormats.resize(eastl::max(BinaryFormatCount, 0));
+
+		if (m_ProgramBinarySupported)
+		{
+			glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, (GLint*)m_BinaryFormats.data());
+		}
+
+		// Texel data is tightly packed, single channel rows are not 4 bytes aligned
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+		GLint ExtensionCount = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &ExtensionCount);
+
+		for (GLint Index = 0; Index < ExtensionCount; ++Index)
+		{
+			const char* Extension = (const char*)glGetStringi(GL_EXTENSIONS, Index);
+
+			if (strcmp(Extension, "GL_KHR_parallel_shader_compile") == 0 || strcmp(Extension, "GL_ARB_parallel_shader_compile") == 0)
+			{
+				m_ParallelShaderCompile = true;
+			}
+		}
+
+		return true;
 	}
 
 	void render_backend::EnableDebugging()
@@ -205,6 +249,14 @@ namespace gl
 	}
 
 	program_handle render_backend::CreateProgram(shader_handle VertexShader, shader_handle FragmentShader, bool DeleteShaders)
+	{
+		return LinkProgram(VertexShader, FragmentShader, DeleteShaders, false);
+	}
+
+	program_handle render_backend::LinkProgram(shader_handle VertexShader,
+	                                           shader_handle FragmentShader,
+	                                           bool          DeleteShaders,
+	                                           bool          Retrievable)
 	{
 		program_handle Handle = GLUON_INVALID_HANDLE;
 
@@ -220,6 +272,11 @@ namespace gl
 			glAttachShader(Program, FragmentShader.Idx);
 		}
 
+		if (Retrievable)
+		{
+			glProgramParameteri(Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
+
 		glLinkProgram(Program);
 
 		if (DeleteShaders)
@@ -301,6 +358,217 @@ namespace gl
 		return Handle;
 	}
 
+	program_handle render_backend::CreateProgramFromSources(const char* VertexSource, const char* FragmentSource, const char* ProgramName)
+	{
+		const u64 SourceHash = HashString(FragmentSource, HashString(VertexSource));
+
+		const program_handle CachedProgram = LoadCachedProgram(SourceHash);
+
+		if (CachedProgram.IsValid())
+		{
+			return CachedProgram;
+		}
+
+		pending_program Pending;
+		Pending.SourceHash       = SourceHash;
+		Pending.Name             = ProgramName != nullptr ? ProgramName : "";
+		Pending.VertexShader.Idx = CompileShader(VertexSource, ShaderType_Vertex);
+		Pending.FragmentShader   = GLUON_INVALID_HANDLE;
+
+		if (FragmentSource != nullptr)
+		{
+			Pending.FragmentShader.Idx = CompileShader(FragmentSource, ShaderType_Fragment);
+		}
+
+		return SubmitProgram(eastl::move(Pending));
+	}
+
+	program_handle render_backend::CreateComputeProgramFromSource(const char* ComputeSource, const char* ProgramName)
+	{
+		// Seeded apart from the other programs, a compute source could otherwise match a vertex only program
+		const u64 SourceHash = HashString(ComputeSource, HashString("compute"));
+
+		const program_handle CachedProgram = LoadCachedProgram(SourceHash);
+
+		if (CachedProgram.IsValid())
+		{
+			return CachedProgram;
+		}
+
+		pending_program Pending;
+		Pending.SourceHash       = SourceHash;
+		Pending.Name             = ProgramName != nullptr ? ProgramName : "";
+		Pending.VertexShader.Idx = CompileShader(ComputeSource, ShaderType_Compute);
+		Pending.FragmentShader   = GLUON_INVALID_HANDLE;
+
+		return SubmitProgram(eastl::move(Pending));
+	}
+
+	program_handle render_backend::LoadCachedProgram(u64 SourceHash)
+	{
+		timer Timer;
+		Timer.Start();
+
+		if (m_ProgramBinarySupported)
+		{
+			program_binary Binary;
+
+			if (LoadProgramBinary(SourceHash, m_DriverHash, m_BinaryFormats, &Binary))
+			{
+				u32 Program = glCreateProgram();
+				glProgramBinary(Program, Binary.Format, Binary.Data.data(), (GLsizei)Binary.Data.size());
+
+				GLint Linked;
+				glGetProgramiv(Program, GL_LINK_STATUS, &Linked);
+
+				if (Linked == GL_TRUE)
+				{
+					RecordProgramCacheHit(Timer.GetElapsedSeconds());
+					return {Program};
+				}
+
+				// The driver may reject binaries even if it did not change, e.g. after a system update
+				glDeleteProgram(Program);
+			}
+		}
+
+		RecordProgramCacheMiss();
+
+		return GLUON_INVALID_HANDLE;
+	}
+
+	program_handle render_backend::SubmitProgram(pending_program&& Pending)
+	{
+		// Compile and link are only submitted here, errors are checked once the program is polled so that the driver can compile
+		// every program in parallel
+		u32 Program = glCreateProgram();
+
+		glAttachShader(Program, Pending.VertexShader.Idx);
+
+		if (Pending.FragmentShader.IsValid())
+		{
+			glAttachShader(Program, Pending.FragmentShader.Idx);
+		}
+
+		if (m_ProgramBinarySupported)
+		{
+			glProgramParameteri(Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
+
+		glLinkProgram(Program);
+
+		m_PendingPrograms[{Program}] = eastl::move(Pending);
+
+		return {Program};
+	}
+
+	u32 render_backend::CompileShader(const char* ShaderSource, shader_type ShaderType)
+	{
+		u32 Shader = glCreateShader(k_ShaderTypes[ShaderType]);
+
+		glShaderSource(Shader, 1, &ShaderSource, nullptr);
+		glCompileShader(Shader);
+
+		return Shader;
+	}
+
+	bool render_backend::IsProgramReady(program_handle Program)
+	{
+		auto Iterator = m_PendingPrograms.find(Program);
+
+		if (Iterator == m_PendingPrograms.end())
+		{
+			return Program.IsValid();
+		}
+
+		if (Iterator->second.Failed)
+		{
+			return false;
+		}
+
+		if (m_ParallelShaderCompile)
+		{
+			GLint Completed = GL_FALSE;
+			glGetProgramiv(Program.Idx, GL_COMPLETION_STATUS_KHR, &Completed);
+
+			if (Completed != GL_TRUE)
+			{
+				return false;
+			}
+		}
+
+		if (!FinalizeProgram(Program, &Iterator->second))
+		{
+			Iterator->second.Failed = true;
+			return false;
+		}
+
+		m_PendingPrograms.erase(Iterator);
+		return true;
+	}
+
+	bool render_backend::FinalizeProgram(program_handle Program, pending_program* Pending)
+	{
+		GLint Linked;
+		glGetProgramiv(Program.Idx, GL_LINK_STATUS, &Linked);
+
+		if (Linked != GL_TRUE)
+		{
+			for (shader_handle Shader : {Pending->VertexShader, Pending->FragmentShader})
+			{
+				GLint Compiled = GL_TRUE;
+
+				if (Shader.IsValid())
+				{
+					glGetShaderiv(Shader.Idx, GL_COMPILE_STATUS, &Compiled);
+				}
+
+				if (Compiled != GL_TRUE)
+				{
+					GLchar InfoLog[512];
+					glGetShaderInfoLog(Shader.Idx, 512, nullptr, InfoLog);
+					LOG_F(ERROR, "Could not compile Shader %s:\n%s", Pending->Name.c_str(), InfoLog);
+				}
+			}
+
+			GLchar InfoLog[512];
+			glGetProgramInfoLog(Program.Idx, 512, nullptr, InfoLog);
+			LOG_F(ERROR, "Error linking program %s:\n%s", Pending->Name.c_str(), InfoLog);
+		}
+
+		for (shader_handle Shader : {Pending->VertexShader, Pending->FragmentShader})
+		{
+			if (Shader.IsValid())
+			{
+				glDetachShader(Program.Idx, Shader.Idx);
+				glDeleteShader(Shader.Idx);
+			}
+		}
+
+		Pending->VertexShader   = GLUON_INVALID_HANDLE;
+		Pending->FragmentShader = GLUON_INVALID_HANDLE;
+
+		if (Linked == GL_TRUE && m_ProgramBinarySupported)
+		{
+			GLint BinaryLength = 0;
+			glGetProgramiv(Program.Idx, GL_PROGRAM_BINARY_LENGTH, &BinaryLength);
+
+			program_binary Binary;
+			Binary.Data.resize(BinaryLength);
+
+			GLenum Format = 0;
+			glGetProgramBinary(Program.Idx, BinaryLength, nullptr, &Format, Binary.Data.data());
+			Binary.Format = Format;
+
+			if (BinaryLength > 0)
+			{
+				StoreProgramBinary(Pending->SourceHash, m_DriverHash, Binary);
+			}
+		}
+
+		return Linked == GL_TRUE;
+	}
+
 	void render_backend::SetProgram(program_handle Program)
 	{
 		glUseProgram(Program.Idx);
@@ -310,6 +578,21 @@ namespace gl
 	void render_backend::DestroyProgram(program_handle Program)
 	{
 		GLN_ASSERT(glIsProgram(Program.Idx) && Program.IsValid());
+
+		auto Iterator = m_PendingPrograms.find(Program);
+		if (Iterator != m_PendingPrograms.end())
+		{
+			for (shader_handle Shader : {Iterator->second.VertexShader, Iterator->second.FragmentShader})
+			{
+				if (Shader.IsValid())
+				{
+					glDeleteShader(Shader.Idx);
+				}
+			}
+
+			m_PendingPrograms.erase(Iterator);
+		}
+
 		glDeleteProgram(Program.Idx);
 	}
 
@@ -367,6 +650,12 @@ namespace gl
 		glUniformMatrix4fv(Location, 1, GL_FALSE, &Value[0][0]);
 	}
 
+	void render_backend::SetUniform(const char* UniformName, const i32* Values, u32 Count)
+	{
+		const i32 Location = glGetUniformLocation(m_CurrentProgram.Idx, UniformName);
+		glUniform1iv(Location, Count, Values);
+	}
+
 	// VAO section
 	vertex_array_handle render_backend::CreateVertexArray(buffer_handle IndexBuffer)
 	{
@@ -577,6 +866,21 @@ namespace gl
 		return Texture;
 	}
 
+	texture_handle render_backend::CreateTextureArray(u32 Width, u32 Height, u32 LayerCount, u32 ComponentCount, data_type DataType)
+	{
+		texture_handle Texture;
+
+		glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &Texture.Idx);
+		glTextureStorage3D(Texture.Idx, 1, k_InternalFormats[ComponentCount][DataType], Width, Height, LayerCount);
+
+		SetTextureFiltering(Texture, MinFilter_Linear, MagFilter_Linear);
+		SetTextureWrapping(Texture, WrapMode_Repeat, WrapMode_Repeat);
+
+		m_TextureInfos[Texture] = {Width, Height, ComponentCount, DataType, false};
+
+		return Texture;
+	}
+
 	void render_backend::SetTextureData(texture_handle Texture, void* Data)
 	{
 		const auto& Info = m_TextureInfos[Texture];
@@ -596,6 +900,28 @@ namespace gl
 		}
 	}
 
+	void render_backend::SetTextureSubData(texture_handle Texture, u32 X, u32 Y, u32 Width, u32 Height, const void* Data)
+	{
+		const auto& Info = m_TextureInfos[Texture];
+		glTextureSubImage2D(Texture.Idx, 0, X, Y, Width, Height, k_Formats[Info.ComponentCount], k_DataTypes[Info.DataType], Data);
+	}
+
+	void render_backend::SetTextureLayerSubData(texture_handle Texture, u32 Layer, u32 X, u32 Y, u32 Width, u32 Height, const void* Data)
+	{
+		const auto& Info = m_TextureInfos[Texture];
+		glTextureSubImage3D(Texture.Idx,
+		                    0,
+		                    X,
+		                    Y,
+		                    Layer,
+		                    Width,
+		                    Height,
+		                    1,
+		                    k_Formats[Info.ComponentCount],
+		                    k_DataTypes[Info.DataType],
+		                    Data);
+	}
+
 	void render_backend::SetTextureWrapping(texture_handle Texture, wrap_mode WrapS, wrap_mode WrapT)
 	{
 		glTextureParameteri(Texture.Idx, GL_TEXTURE_WRAP_S, k_WrapModes[WrapS]);
@@ -613,5 +939,82 @@ namespace gl
 		GLN_ASSERT(Texture.IsValid() && glIsTexture(Texture.Idx));
 		glDeleteTextures(1, &Texture.Idx);
 	}
+
+	framebuffer_handle render_backend::CreateFramebuffer(texture_handle TextureArray, u32 Layer)
+	{
+		framebuffer_handle Framebuffer;
+
+		glCreateFramebuffers(1, &Framebuffer.Idx);
+		glNamedFramebufferTextureLayer(Framebuffer.Idx, GL_COLOR_ATTACHMENT0, TextureArray.Idx, 0, Layer);
+
+		const GLenum Status = glCheckNamedFramebufferStatus(Framebuffer.Idx, GL_FRAMEBUFFER);
+
+		if (Status != GL_FRAMEBUFFER_COMPLETE)
+		{
+			LOG_F(ERROR, "Incomplete framebuffer (0x%x)", Status);
+			glDeleteFramebuffers(1, &Framebuffer.Idx);
+			return GLUON_INVALID_HANDLE;
+		}
+
+		return Framebuffer;
+	}
+
+	void render_backend::DestroyFramebuffer(framebuffer_handle Framebuffer)
+	{
+		GLN_ASSERT(Framebuffer.IsValid() && glIsFramebuffer(Framebuffer.Idx));
+		glDeleteFramebuffers(1, &Framebuffer.Idx);
+	}
+
+	// Draw section
+	void render_backend::BeginFrame() { }
+	void render_backend::EndFrame() { }
+
+	void render_backend::SetViewport(i32 X, i32 Y, i32 Width, i32 Height) { glViewport(X, Y, Width, Height); }
+
+	void render_backend::Clear(const vec4& Color)
+	{
+		glClearColor(Color.x, Color.y, Color.z, Color.w);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	}
+
+	void render_backend::SetBlending(bool Enabled)
+	{
+		if (Enabled)
+		{
+			glEnable(GL_BLEND);
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		}
+		else
+		{
+			glDisable(GL_BLEND);
+		}
+	}
+
+	void render_backend::BindFramebuffer(framebuffer_handle Framebuffer)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, Framebuffer.IsValid() ? Framebuffer.Idx : 0);
+	}
+
+	void render_backend::BindVertexArray(vertex_array_handle VertexArray) { glBindVertexArray(VertexArray.Idx); }
+
+	void render_backend::BindStorageBuffer(u32 Binding, buffer_handle Buffer)
+	{
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, Binding, Buffer.Idx);
+	}
+
+	void render_backend::BindTexture(u32 Unit, texture_handle Texture) { glBindTextureUnit(Unit, Texture.Idx); }
+
+	void render_backend::DrawElementsInstanced(u32 IndexCount, u32 InstanceCount, data_type IndexType)
+	{
+		glDrawElementsInstanced(GL_TRIANGLES, IndexCount, k_DataTypes[IndexType], nullptr, InstanceCount);
+	}
+
+	void render_backend::DispatchCompute(u32 GroupCountX, u32 GroupCountY, u32 GroupCountZ)
+	{
+		glDispatchCompute(GroupCountX, GroupCountY, GroupCountZ);
+
+		// Storage buffers written by the dispatch are read by the next draws
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+	}
 }
 }
@@ -5,6 +5,7 @@
 #include <EASTL/unordered_map.h>
 #include <EASTL/vector.h>
 #include <EASTL/string_hash_map.h>
+#include <EASTL/string.h>
 
 namespace gluon
 {
@@ -30,13 +31,24 @@ namespace gl
 		bool      WithMipmap;
 	};
 
-	struct render_backend : public render_backend_interface
+	//! Programs whose link has been submitted but not checked yet, @see IsProgramReady()
+	struct pending_program
+	{
+		// Holds the compute shader of compute programs
+		shader_handle VertexShader;
+		shader_handle FragmentShader;
+		u64           SourceHash;
+		eastl::string Name;
+		bool          Failed = false;
+	};
+
+	struct render_backend final : public render_backend_interface
 	{
 		render_backend();
 		virtual ~render_backend();
 
 		// Misc section
-		void Initialize() override final;
+		bool Initialize() override final;
 
 		void EnableDebugging() override final;
 		void DisableDebugging() override final;
@@ -48,6 +60,11 @@ namespace gl
 
 		program_handle CreateProgram(shader_handle VertexShader, shader_handle FragmentShader, bool DeleteShaders) override final;
 		program_handle CreateComputeProgram(shader_handle ComputeShader, bool DeleteShaders) override final;
+		program_handle CreateProgramFromSources(const char* VertexSource,
+		                                        const char* FragmentSource,
+		                                        const char* ProgramName) override final;
+		program_handle CreateComputeProgramFromSource(const char* ComputeSource, const char* ProgramName) override final;
+		bool           IsProgramReady(program_handle Program) override final;
 		void           SetProgram(program_handle Program) override final;
 		void           DestroyProgram(program_handle Program) override final;
 
@@ -61,6 +78,8 @@ namespace gl
 		void SetUniform(const char* UniformName, const mat3& Value) override final;
 		void SetUniform(const char* UniformName, const mat4& Value) override final;
 
+		void SetUniform(const char* UniformName, const i32* Values, u32 Count) override final;
+
 		// VAO section
 		vertex_array_handle CreateVertexArray(buffer_handle IndexBuffer) override final;
 		void                AttachVertexBuffer(vertex_array_handle  VertexArray,
@@ -82,13 +101,52 @@ namespace gl
 		// Texture section
 		texture_handle CreateTexture(u32 Width, u32 Height, u32 ComponentCount, data_type DataType, bool WithMipmaps, void* Data)
 		    override final;
+		texture_handle CreateTextureArray(u32 Width, u32 Height, u32 LayerCount, u32 ComponentCount, data_type DataType) override final;
 		void SetTextureData(texture_handle Texture, void* Data) override final;
+		void SetTextureSubData(texture_handle Texture, u32 X, u32 Y, u32 Width, u32 Height, const void* Data) override final;
+		void SetTextureLayerSubData(texture_handle Texture, u32 Layer, u32 X, u32 Y, u32 Width, u32 Height, const void* Data)
+		    override final;
 		void SetTextureWrapping(texture_handle Texture, wrap_mode WrapS, wrap_mode WrapT) override final;
 		void SetTextureFiltering(texture_handle Texture, min_filter MinFilter, mag_filter MagFilter) override final;
 		void DestroyTexture(texture_handle Texture) override final;
 
+		framebuffer_handle CreateFramebuffer(texture_handle TextureArray, u32 Layer) override final;
+		void               DestroyFramebuffer(framebuffer_handle Framebuffer) override final;
+
+		// Draw section
+		void BeginFrame() override final;
+		void EndFrame() override final;
+
+		void SetViewport(i32 X, i32 Y, i32 Width, i32 Height) override final;
+		void Clear(const vec4& Color) override final;
+		void SetBlending(bool Enabled) override final;
+		void BindFramebuffer(framebuffer_handle Framebuffer) override final;
+
+		void BindVertexArray(vertex_array_handle VertexArray) override final;
+		void BindStorageBuffer(u32 Binding, buffer_handle Buffer) override final;
+		void BindTexture(u32 Unit, texture_handle Texture) override final;
+		void DrawElementsInstanced(u32 IndexCount, u32 InstanceCount, data_type IndexType) override final;
+		void DispatchCompute(u32 GroupCountX, u32 GroupCountY, u32 GroupCountZ) override final;
+
+		u32            CompileShader(const char* ShaderSource, shader_type ShaderType);
+		bool           FinalizeProgram(program_handle Program, pending_program* Pending);
+		program_handle LoadCachedProgram(u64 SourceHash);
+		program_handle SubmitProgram(pending_program&& Pending);
+		program_handle LinkProgram(shader_handle VertexShader, shader_handle FragmentShader, bool DeleteShaders, bool Retrievable);
+
 		program_handle m_CurrentProgram;
 
+		// Identifies the driver for the program cache, binaries are only valid for the driver that produced them
+		u64  m_DriverHash             = 0;
+		bool m_ProgramBinarySupported = false;
+
+		eastl::vector<u32> m_BinaryFormats; // GL_PROGRAM_BINARY_FORMATS, entries of the program cache in another format are misses
+
+		// GL_KHR_parallel_shader_compile, completion can be polled without blocking
+		bool m_ParallelShaderCompile = false;
+
+		eastl::unordered_map<program_handle, pending_program> m_PendingPrograms;
+
 		eastl::unordered_map<shader_handle, eastl::string>                      m_ShaderNames;
 		eastl::unordered_map<program_handle, program_info>                      m_ProgramInfos;
 		eastl::unordered_map<buffer_handle, buffer_info>                        m_BufferInfos;
@@ -0,0 +1,2557 @@
+#include <gluon/render_backend/backend_vulkan/gln_renderbackend_vulkan.h>
+
+#include <gluon/core/gln_math.h>
+
+#include <glad/glad.h>
+
+#include <EASTL/algorithm.h>
+#include <EASTL/string.h>
+#include <loguru.hpp>
+
+#include <shaderc/shaderc.h>
+
+#include <stdio.h>
+#include <string.h>
+
+namespace gluon
+{
+namespace vk
+{
+	static VKAPI_ATTR VkBool32 VKAPI_CALL DebugMessageCallback(VkDebugUtilsMessageSeverityFlagBitsEXT      Severity,
+	                                                           VkDebugUtilsMessageTypeFlagsEXT             Type,
+	                                                           const VkDebugUtilsMessengerCallbackDataEXT* CallbackData,
+	                                                           void*                                       UserData)
+	{
+		GLN_UNUSED(Type);
+		GLN_UNUSED(UserData);
+
+		if (Severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT)
+		{
+			LOG_F(ERROR, "Vulkan: %s", CallbackData->pMessage);
+		}
+		else if (Severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT)
+		{
+			LOG_F(WARNING, "Vulkan: %s", CallbackData->pMessage);
+		}
+		else
+		{
+			LOG_F(INFO, "Vulkan: %s", CallbackData->pMessage);
+		}
+
+		return VK_FALSE;
+	}
+
+	static const shaderc_shader_kind k_ShaderKinds[] = {
+	    shaderc_vertex_shader,
+	    shaderc_fragment_shader,
+	    shaderc_compute_shader,
+	};
+
+	// 3 components textures are expanded to 4 components, RGB formats are seldom supported for sampling
+	static const VkFormat k_TextureFormats[5][DataType_Count] = {
+	    {VK_FORMAT_UNDEFINED,
+	     VK_FORMAT_UNDEFINED,
+	     VK_FORMAT_UNDEFINED,
+	     VK_FORMAT_UNDEFINED,
+	     VK_FORMAT_UNDEFINED,
+	     VK_FORMAT_UNDEFINED,
+	     VK_FORMAT_UNDEFINED},
+	    {VK_FORMAT_R8_UNORM,
+	     VK_FORMAT_R8_UNORM,
+	     VK_FORMAT_R16_UNORM,
+	     VK_FORMAT_R16_UNORM,
+	     VK_FORMAT_R32_SINT,
+	     VK_FORMAT_R32_UINT,
+	     VK_FORMAT_R32_SFLOAT},
+	    {VK_FORMAT_R8G8_UNORM,
+	     VK_FORMAT_R8G8_UNORM,
+	     VK_FORMAT_R16G16_UNORM,
+	     VK_FORMAT_R16G16_UNORM,
+	     VK_FORMAT_R32G32_SINT,
+	     VK_FORMAT_R32G32_UINT,
+	     VK_FORMAT_R32G32_SFLOAT},
+	    {VK_FORMAT_R8G8B8A8_UNORM,
+	     VK_FORMAT_R8G8B8A8_UNORM,
+	     VK_FORMAT_R16G16B16A16_UNORM,
+	     VK_FORMAT_R16G16B16A16_UNORM,
+	     VK_FORMAT_R32G32B32A32_SINT,
+	     VK_FORMAT_R32G32B32A32_UINT,
+	     VK_FORMAT_R32G32B32A32_SFLOAT},
+	    {VK_FORMAT_R8G8B8A8_UNORM,
+	     VK_FORMAT_R8G8B8A8_UNORM,
+	     VK_FORMAT_R16G16B16A16_UNORM,
+	     VK_FORMAT_R16G16B16A16_UNORM,
+	     VK_FORMAT_R32G32B32A32_SINT,
+	     VK_FORMAT_R32G32B32A32_UINT,
+	     VK_FORMAT_R32G32B32A32_SFLOAT},
+	};
+
+	static const VkFormat k_VertexFormats[DataType_Count][4] = {
+	    {VK_FORMAT_R8_SINT, VK_FORMAT_R8G8_SINT, VK_FORMAT_R8G8B8_SINT, VK_FORMAT_R8G8B8A8_SINT},
+	    {VK_FORMAT_R8_UINT, VK_FORMAT_R8G8_UINT, VK_FORMAT_R8G8B8_UINT, VK_FORMAT_R8G8B8A8_UINT},
+	    {VK_FORMAT_R16_SINT, VK_FORMAT_R16G16_SINT, VK_FORMAT_R16G16B16_SINT, VK_FORMAT_R16G16B16A16_SINT},
+	    {VK_FORMAT_R16_UINT, VK_FORMAT_R16G16_UINT, VK_FORMAT_R16G16B16_UINT, VK_FORMAT_R16G16B16A16_UINT},
+	    {VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT},
+	    {VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT},
+	    {VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT},
+	};
+
+	static const VkSamplerAddressMode k_WrapModes[] = {
+	    VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+	    VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER,
+	    VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT,
+	    VK_SAMPLER_ADDRESS_MODE_REPEAT,
+	    VK_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE,
+	};
+
+	static const VkFilter k_MinFilters[] = {
+	    VK_FILTER_NEAREST,
+	    VK_FILTER_LINEAR,
+	    VK_FILTER_NEAREST,
+	    VK_FILTER_LINEAR,
+	    VK_FILTER_NEAREST,
+	    VK_FILTER_LINEAR,
+	};
+
+	static const VkSamplerMipmapMode k_MipmapModes[] = {
+	    VK_SAMPLER_MIPMAP_MODE_NEAREST,
+	    VK_SAMPLER_MIPMAP_MODE_NEAREST,
+	    VK_SAMPLER_MIPMAP_MODE_NEAREST,
+	    VK_SAMPLER_MIPMAP_MODE_NEAREST,
+	    VK_SAMPLER_MIPMAP_MODE_LINEAR,
+	    VK_SAMPLER_MIPMAP_MODE_LINEAR,
+	};
+
+	static const VkFilter k_MagFilters[] = {
+	    VK_FILTER_NEAREST,
+	    VK_FILTER_LINEAR,
+	};
+
+	static constexpr u32 k_UniformRingSize = 1024 * 1024;
+	static constexpr u32 k_MaxDrawsPerFrame = 4096;
+
+	static constexpr VkBufferUsageFlags k_BufferUsage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+	                                                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+	                                                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+//! Logs a failed call, evaluates to false so that creation failures are returned to the caller
+#define VK_CHECK(Expr) CheckResult((Expr), #Expr)
+
+	static bool CheckResult(VkResult Result, const char* Expression)
+	{
+		if (Result != VK_SUCCESS)
+		{
+			LOG_F(ERROR, "%s failed (%d)", Expression, Result);
+			return false;
+		}
+
+		return true;
+	}
+
+	static bool HasLayer(const eastl::vector<VkLayerProperties>& Layers, const char* Name)
+	{
+		for (const auto& Layer : Layers)
+		{
+			if (strcmp(Layer.layerName, Name) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static bool HasExtension(const eastl::vector<VkExtensionProperties>& Extensions, const char* Name)
+	{
+		for (const auto& Extension : Extensions)
+		{
+			if (strcmp(Extension.extensionName, Name) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/// Minimal SPIR-V reflection, only retrieves the members of uniform blocks so that uniforms can still be set by name.
+	static void ReflectUniforms(const eastl::vector<u32>& Code, program_info* Program)
+	{
+		enum
+		{
+			Op_MemberName     = 6,
+			Op_TypeInt        = 21,
+			Op_TypeFloat      = 22,
+			Op_TypeVector     = 23,
+			Op_TypeMatrix     = 24,
+			Op_TypeStruct     = 30,
+			Op_TypePointer    = 32,
+			Op_Variable       = 59,
+			Op_MemberDecorate = 72,
+
+			Decoration_MatrixStride = 7,
+			Decoration_Offset       = 35,
+
+			StorageClass_Uniform = 2,
+		};
+
+		struct member_info
+		{
+			eastl::string Name;
+			u32           Offset       = 0;
+			u32           MatrixStride = 0;
+		};
+
+		eastl::unordered_map<u32, eastl::vector<member_info>> Members;
+		eastl::unordered_map<u32, eastl::vector<u32>>         StructTypes;
+		eastl::unordered_map<u32, u32>                        TypeSizes;
+		eastl::unordered_map<u32, u32>                        UniformPointers;
+		eastl::vector<u32>                                    UniformVariables;
+
+		auto GetMember = [&Members](u32 Type, u32 Index) -> member_info& {
+			auto& StructMembers = Members[Type];
+			if (StructMembers.size() <= Index)
+			{
+				StructMembers.resize(Index + 1);
+			}
+			return StructMembers[Index];
+		};
+
+		// Skip the header
+		u32 Word = 5;
+		while (Word < Code.size())
+		{
+			const u32  WordCount = Code[Word] >> 16;
+			const u32  Opcode    = Code[Word] & 0xFFFF;
+			const u32* Operands  = &Code[Word + 1];
+
+			if (WordCount == 0)
+			{
+				break;
+			}
+
+			switch (Opcode)
+			{
+				case Op_MemberName:
+					GetMember(Operands[0], Operands[1]).Name = (const char*)&Operands[2];
+					break;
+
+				case Op_MemberDecorate:
+					if (Operands[2] == Decoration_Offset)
+					{
+						GetMember(Operands[0], Operands[1]).Offset = Operands[3];
+					}
+					else if (Operands[2] == Decoration_MatrixStride)
+					{
+						GetMember(Operands[0], Operands[1]).MatrixStride = Operands[3];
+					}
+					break;
+
+				case Op_TypeInt:
+				case Op_TypeFloat:
+					TypeSizes[Operands[0]] = Operands[1] / 8;
+					break;
+
+				case Op_TypeVector:
+					TypeSizes[Operands[0]] = TypeSizes[Operands[1]] * Operands[2];
+					break;
+
+				case Op_TypeMatrix:
+					// Real size depends on the matrix stride, which is a decoration of the member
+					TypeSizes[Operands[0]] = TypeSizes[Operands[1]] * Operands[2];
+					break;
+
+				case Op_TypeStruct:
+					StructTypes[Operands[0]].assign(Operands + 1, Operands + WordCount - 1);
+					break;
+
+				case Op_TypePointer:
+					if (Operands[1] == StorageClass_Uniform)
+					{
+						UniformPointers[Operands[0]] = Operands[2];
+					}
+					break;
+
+				case Op_Variable:
+					if (Operands[2] == StorageClass_Uniform)
+					{
+						UniformVariables.push_back(Operands[0]);
+					}
+					break;
+			}
+
+			Word += WordCount;
+		}
+
+		for (u32 PointerType : UniformVariables)
+		{
+			const u32   BlockType     = UniformPointers[PointerType];
+			const auto& MemberTypes   = StructTypes[BlockType];
+			const auto& StructMembers = Members[BlockType];
+
+			for (u32 Index = 0; Index < (u32)MemberTypes.size() && Index < (u32)StructMembers.size(); ++Index)
+			{
+				const member_info& Member = StructMembers[Index];
+
+				uniform_info Uniform;
+				Uniform.Offset       = Member.Offset;
+				Uniform.Size         = TypeSizes[MemberTypes[Index]];
+				Uniform.MatrixStride = Member.MatrixStride;
+
+				Program->Uniforms[Member.Name.c_str()] = Uniform;
+
+				const u32 End = Uniform.Offset + eastl::max(Uniform.Size, Uniform.MatrixStride * 4);
+				if (Program->UniformData.size() < End)
+				{
+					Program->UniformData.resize(End, 0);
+				}
+			}
+		}
+	}
+
+	static VkShaderModule CreateShaderModule(VkDevice Device, const eastl::vector<u32>& Code)
+	{
+		VkShaderModuleCreateInfo CreateInfo = {VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
+		CreateInfo.codeSize                 = Code.size() * sizeof(u32);
+		CreateInfo.pCode                    = Code.data();
+
+		VkShaderModule Module = VK_NULL_HANDLE;
+		if (!VK_CHECK(vkCreateShaderModule(Device, &CreateInfo, nullptr, &Module)))
+		{
+			return VK_NULL_HANDLE;
+		}
+
+		return Module;
+	}
+
+	static void ImageBarrier(VkCommandBuffer      CommandBuffer,
+	                         VkImage              Image,
+	                         u32                  BaseLevel,
+	                         u32                  LevelCount,
+	                         VkImageLayout        OldLayout,
+	                         VkImageLayout        NewLayout,
+	                         VkAccessFlags        SrcAccess,
+	                         VkAccessFlags        DstAccess,
+	                         VkPipelineStageFlags SrcStage,
+	                         VkPipelineStageFlags DstStage)
+	{
+		VkImageMemoryBarrier Barrier            = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+		Barrier.oldLayout                       = OldLayout;
+		Barrier.newLayout                       = NewLayout;
+		Barrier.srcAccessMask                   = SrcAccess;
+		Barrier.dstAccessMask                   = DstAccess;
+		Barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+		Barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+		Barrier.image                           = Image;
+		Barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+		Barrier.subresourceRange.baseMipLevel   = BaseLevel;
+		Barrier.subresourceRange.levelCount     = LevelCount;
+		Barrier.subresourceRange.baseArrayLayer = 0;
+		Barrier.subresourceRange.layerCount     = VK_REMAINING_ARRAY_LAYERS;
+
+		vkCmdPipelineBarrier(CommandBuffer, SrcStage, DstStage, 0, 0, nullptr, 0, nullptr, 1, &Barrier);
+	}
+
+	render_backend::render_backend()
+	{
+		for (auto& Buffer : m_CurrentStorageBuffers)
+		{
+			Buffer = GLUON_INVALID_HANDLE;
+		}
+
+		for (auto& Texture : m_CurrentTextures)
+		{
+			Texture = GLUON_INVALID_HANDLE;
+		}
+
+		m_ClearColor = {{0.0f, 0.0f, 0.0f, 1.0f}};
+		m_Viewport   = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+	}
+
+	render_backend::~render_backend()
+	{
+		// Initialize() may have failed half way, handles it did not create are null
+		if (m_Device == VK_NULL_HANDLE)
+		{
+			DisableDebugging();
+			vkDestroyInstance(m_Instance, nullptr);
+			return;
+		}
+
+		vkDeviceWaitIdle(m_Device);
+
+		StopRecordingThreads();
+
+		for (auto& Pipeline : m_GraphicsPipelines)
+		{
+			vkDestroyPipeline(m_Device, Pipeline.second, nullptr);
+		}
+
+		for (auto& Program : m_Programs)
+		{
+			vkDestroyShaderModule(m_Device, Program.second.VertexModule, nullptr);
+			vkDestroyShaderModule(m_Device, Program.second.FragmentModule, nullptr);
+			vkDestroyShaderModule(m_Device, Program.second.ComputeModule, nullptr);
+			vkDestroyPipeline(m_Device, Program.second.ComputePipeline, nullptr);
+		}
+
+		for (auto& Shader : m_Shaders)
+		{
+			vkDestroyShaderModule(m_Device, Shader.second.Module, nullptr);
+		}
+
+		for (auto& Buffer : m_Buffers)
+		{
+			ReleaseBuffer(Buffer.second);
+		}
+
+		for (auto& Buffer : m_PendingBufferReleases)
+		{
+			ReleaseBuffer(Buffer);
+		}
+
+		for (auto& Texture : m_Textures)
+		{
+			vkDestroySampler(m_Device, Texture.second.Sampler, nullptr);
+			vkDestroyImageView(m_Device, Texture.second.View, nullptr);
+			vkDestroyImage(m_Device, Texture.second.Image, nullptr);
+			vkFreeMemory(m_Device, Texture.second.Memory, nullptr);
+		}
+
+		ReleaseBuffer(m_UniformRing);
+		DestroyRenderTarget();
+
+		if (m_PresentFramebuffer != 0)
+		{
+			glDeleteFramebuffers(1, &m_PresentFramebuffer);
+		}
+
+		vkDestroyFence(m_Device, m_FrameFence, nullptr);
+		vkDestroyCommandPool(m_Device, m_CommandPool, nullptr);
+		vkDestroyRenderPass(m_Device, m_RenderPass, nullptr);
+		vkDestroyDescriptorPool(m_Device, m_DescriptorPool, nullptr);
+		vkDestroyPipelineLayout(m_Device, m_PipelineLayout, nullptr);
+		vkDestroyDescriptorSetLayout(m_Device, m_DescriptorSetLayout, nullptr);
+
+		if (m_ShaderCompiler != nullptr)
+		{
+			shaderc_compiler_release(m_ShaderCompiler);
+		}
+
+		vkDestroyDevice(m_Device, nullptr);
+
+		DisableDebugging();
+		vkDestroyInstance(m_Instance, nullptr);
+	}
+
+	// Misc section
+	bool render_backend::Initialize()
+	{
+		u32 LayerCount = 0;
+		vkEnumerateInstanceLayerProperties(&LayerCount, nullptr);
+		eastl::vector<VkLayerProperties> AvailableLayers(LayerCount);
+		vkEnumerateInstanceLayerProperties(&LayerCount, AvailableLayers.data());
+
+		u32 ExtensionCount = 0;
+		vkEnumerateInstanceExtensionProperties(nullptr, &ExtensionCount, nullptr);
+		eastl::vector<VkExtensionProperties> AvailableExtensions(ExtensionCount);
+		vkEnumerateInstanceExtensionProperties(nullptr, &ExtensionCount, AvailableExtensions.data());
+
+		eastl::vector<const char*> Layers;
+		eastl::vector<const char*> Extensions;
+
+#if GLN_DEBUG
+		if (HasLayer(AvailableLayers, "VK_LAYER_KHRONOS_validation"))
+		{
+			Layers.push_back("VK_LAYER_KHRONOS_validation");
+		}
+#endif
+
+		m_HasDebugUtils = HasExtension(AvailableExtensions, VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+		if (m_HasDebugUtils)
+		{
+			Extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+		}
+
+		VkApplicationInfo AppInfo  = {VK_STRUCTURE_TYPE_APPLICATION_INFO};
+		AppInfo.pApplicationName   = "gluon";
+		AppInfo.pEngineName        = "gluon";
+		AppInfo.apiVersion         = VK_API_VERSION_1_2;
+
+		VkInstanceCreateInfo InstanceInfo    = {VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+		InstanceInfo.pApplicationInfo        = &AppInfo;
+		InstanceInfo.enabledLayerCount       = (u32)Layers.size();
+		InstanceInfo.ppEnabledLayerNames     = Layers.data();
+		InstanceInfo.enabledExtensionCount   = (u32)Extensions.size();
+		InstanceInfo.ppEnabledExtensionNames = Extensions.data();
+
+		if (vkCreateInstance(&InstanceInfo, nullptr, &m_Instance) != VK_SUCCESS)
+		{
+			LOG_F(ERROR, "Cannot create Vulkan instance");
+			m_Instance = VK_NULL_HANDLE;
+			return false;
+		}
+
+		// Pick a device, discrete GPUs first, CPU implementations (lavapipe, swiftshader) last
+		u32 DeviceCount = 0;
+		vkEnumeratePhysicalDevices(m_Instance, &DeviceCount, nullptr);
+		eastl::vector<VkPhysicalDevice> Devices(DeviceCount);
+		vkEnumeratePhysicalDevices(m_Instance, &DeviceCount, Devices.data());
+
+		auto GetDeviceScore = [](const VkPhysicalDeviceProperties& Properties) {
+			switch (Properties.deviceType)
+			{
+				case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+					return 4;
+				case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+					return 3;
+				case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+					return 2;
+				case VK_PHYSICAL_DEVICE_TYPE_CPU:
+					return 1;
+				default:
+					return 0;
+			}
+		};
+
+		i32 BestScore = -1;
+		for (VkPhysicalDevice Device : Devices)
+		{
+			VkPhysicalDeviceProperties Properties;
+			vkGetPhysicalDeviceProperties(Device, &Properties);
+
+			if (Properties.apiVersion < VK_API_VERSION_1_2)
+			{
+				continue;
+			}
+
+			u32 FamilyCount = 0;
+			vkGetPhysicalDeviceQueueFamilyProperties(Device, &FamilyCount, nullptr);
+			eastl::vector<VkQueueFamilyProperties> Families(FamilyCount);
+			vkGetPhysicalDeviceQueueFamilyProperties(Device, &FamilyCount, Families.data());
+
+			for (u32 Family = 0; Family < FamilyCount; ++Family)
+			{
+				const VkQueueFlags Required = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT;
+				if ((Families[Family].queueFlags & Required) == Required && GetDeviceScore(Properties) > BestScore)
+				{
+					BestScore        = GetDeviceScore(Properties);
+					m_PhysicalDevice = Device;
+					m_QueueFamily    = Family;
+					break;
+				}
+			}
+		}
+
+		if (m_PhysicalDevice == VK_NULL_HANDLE)
+		{
+			LOG_F(ERROR, "Cannot find a Vulkan 1.2 device");
+			return false;
+		}
+
+		vkGetPhysicalDeviceProperties(m_PhysicalDevice, &m_DeviceProperties);
+		vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &m_MemoryProperties);
+
+		VkPhysicalDeviceVulkan12Features Features12 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+		VkPhysicalDeviceFeatures2        Features   = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+		Features.pNext                              = &Features12;
+		vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &Features);
+
+		if (!Features12.descriptorBindingPartiallyBound || !Features12.shaderSampledImageArrayNonUniformIndexing)
+		{
+			LOG_F(ERROR, "%s does not support the required descriptor indexing features", m_DeviceProperties.deviceName);
+			return false;
+		}
+
+		// Only enable what we use
+		VkPhysicalDeviceVulkan12Features EnabledFeatures12          = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+		EnabledFeatures12.descriptorIndexing                        = Features12.descriptorIndexing;
+		EnabledFeatures12.descriptorBindingPartiallyBound           = VK_TRUE;
+		EnabledFeatures12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+		EnabledFeatures12.samplerMirrorClampToEdge                  = Features12.samplerMirrorClampToEdge;
+
+		m_HasMirrorClampToEdge = Features12.samplerMirrorClampToEdge == VK_TRUE;
+
+		const f32               QueuePriority = 1.0f;
+		VkDeviceQueueCreateInfo QueueInfo     = {VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO};
+		QueueInfo.queueFamilyIndex            = m_QueueFamily;
+		QueueInfo.queueCount                  = 1;
+		QueueInfo.pQueuePriorities            = &QueuePriority;
+
+		VkDeviceCreateInfo DeviceInfo   = {VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+		DeviceInfo.pNext                = &EnabledFeatures12;
+		DeviceInfo.queueCreateInfoCount = 1;
+		DeviceInfo.pQueueCreateInfos    = &QueueInfo;
+
+		if (vkCreateDevice(m_PhysicalDevice, &DeviceInfo, nullptr, &m_Device) != VK_SUCCESS)
+		{
+			LOG_F(ERROR, "Cannot create Vulkan device");
+			m_Device = VK_NULL_HANDLE;
+			return false;
+		}
+
+		vkGetDeviceQueue(m_Device, m_QueueFamily, 0, &m_Queue);
+
+		LOG_F(INFO,
+		      "Vulkan:\n\tVersion %d.%d.%d\n\tDevice %s",
+		      VK_VERSION_MAJOR(m_DeviceProperties.apiVersion),
+		      VK_VERSION_MINOR(m_DeviceProperties.apiVersion),
+		      VK_VERSION_PATCH(m_DeviceProperties.apiVersion),
+		      m_DeviceProperties.deviceName);
+
+		// Descriptor set layout, shared by every program
+		{
+			VkDescriptorSetLayoutBinding Bindings[2 + k_MaxStorageBindings] = {};
+			VkDescriptorBindingFlags     BindingFlags[2 + k_MaxStorageBindings];
+
+			Bindings[0].binding         = k_UniformBinding;
+			Bindings[0].descriptorType  = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+			Bindings[0].descriptorCount = 1;
+			Bindings[0].stageFlags      = VK_SHADER_STAGE_ALL;
+			BindingFlags[0]             = 0;
+
+			for (u32 Index = 0; Index < k_MaxStorageBindings; ++Index)
+			{
+				Bindings[1 + Index].binding         = k_FirstStorageBinding + Index;
+				Bindings[1 + Index].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+				Bindings[1 + Index].descriptorCount = 1;
+				Bindings[1 + Index].stageFlags      = VK_SHADER_STAGE_ALL;
+				BindingFlags[1 + Index]             = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+			}
+
+			Bindings[1 + k_MaxStorageBindings].binding         = k_TextureBinding;
+			Bindings[1 + k_MaxStorageBindings].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			Bindings[1 + k_MaxStorageBindings].descriptorCount = k_MaxTextureUnits;
+			Bindings[1 + k_MaxStorageBindings].stageFlags      = VK_SHADER_STAGE_ALL;
+			BindingFlags[1 + k_MaxStorageBindings]             = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+
+			VkDescriptorSetLayoutBindingFlagsCreateInfo FlagsInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO};
+			FlagsInfo.bindingCount                                = (u32)GLN_ARRAY_SIZE(BindingFlags);
+			FlagsInfo.pBindingFlags                               = BindingFlags;
+
+			VkDescriptorSetLayoutCreateInfo LayoutInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+			LayoutInfo.pNext                           = &FlagsInfo;
+			LayoutInfo.bindingCount                    = (u32)GLN_ARRAY_SIZE(Bindings);
+			LayoutInfo.pBindings                       = Bindings;
+			if (!VK_CHECK(vkCreateDescriptorSetLayout(m_Device, &LayoutInfo, nullptr, &m_DescriptorSetLayout)))
+			{
+				return false;
+			}
+
+			VkPipelineLayoutCreateInfo PipelineLayoutInfo = {VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
+			PipelineLayoutInfo.setLayoutCount             = 1;
+			PipelineLayoutInfo.pSetLayouts                = &m_DescriptorSetLayout;
+			if (!VK_CHECK(vkCreatePipelineLayout(m_Device, &PipelineLayoutInfo, nullptr, &m_PipelineLayout)))
+			{
+				return false;
+			}
+
+			VkDescriptorPoolSize PoolSizes[] = {
+			    {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, k_MaxDrawsPerFrame},
+			    {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, k_MaxDrawsPerFrame * k_MaxStorageBindings},
+			    {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, k_MaxDrawsPerFrame * k_MaxTextureUnits},
+			};
+
+			VkDescriptorPoolCreateInfo PoolInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+			PoolInfo.maxSets                    = k_MaxDrawsPerFrame;
+			PoolInfo.poolSizeCount              = (u32)GLN_ARRAY_SIZE(PoolSizes);
+			PoolInfo.pPoolSizes                 = PoolSizes;
+			if (!VK_CHECK(vkCreateDescriptorPool(m_Device, &PoolInfo, nullptr, &m_DescriptorPool)))
+			{
+				return false;
+			}
+		}
+
+		// Render pass, the offscreen target is left ready to be copied back
+		{
+			VkAttachmentDescription Attachment = {};
+			Attachment.format                  = VK_FORMAT_R8G8B8A8_UNORM;
+			Attachment.samples                 = VK_SAMPLE_COUNT_1_BIT;
+			Attachment.loadOp                  = VK_ATTACHMENT_LOAD_OP_CLEAR;
+			Attachment.storeOp                 = VK_ATTACHMENT_STORE_OP_STORE;
+			Attachment.stencilLoadOp           = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			Attachment.stencilStoreOp          = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			Attachment.initialLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
+			Attachment.finalLayout             = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+			VkAttachmentReference ColorReference = {0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+
+			VkSubpassDescription Subpass = {};
+			Subpass.pipelineBindPoint    = VK_PIPELINE_BIND_POINT_GRAPHICS;
+			Subpass.colorAttachmentCount = 1;
+			Subpass.pColorAttachments    = &ColorReference;
+
+			VkSubpassDependency Dependency = {};
+			Dependency.srcSubpass          = VK_SUBPASS_EXTERNAL;
+			Dependency.dstSubpass          = 0;
+			Dependency.srcStageMask        = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+			Dependency.dstStageMask        = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			Dependency.srcAccessMask       = VK_ACCESS_TRANSFER_READ_BIT;
+			Dependency.dstAccessMask       = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+			VkRenderPassCreateInfo RenderPassInfo = {VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO};
+			RenderPassInfo.attachmentCount        = 1;
+			RenderPassInfo.pAttachments           = &Attachment;
+			RenderPassInfo.subpassCount           = 1;
+			RenderPassInfo.pSubpasses             = &Subpass;
+			RenderPassInfo.dependencyCount        = 1;
+			RenderPassInfo.pDependencies          = &Dependency;
+			if (!VK_CHECK(vkCreateRenderPass(m_Device, &RenderPassInfo, nullptr, &m_RenderPass)))
+			{
+				return false;
+			}
+		}
+
+		// Frame resources
+		{
+			VkCommandPoolCreateInfo PoolInfo = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+			PoolInfo.flags                   = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+			PoolInfo.queueFamilyIndex        = m_QueueFamily;
+			if (!VK_CHECK(vkCreateCommandPool(m_Device, &PoolInfo, nullptr, &m_CommandPool)))
+			{
+				return false;
+			}
+
+			VkCommandBufferAllocateInfo AllocateInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+			AllocateInfo.commandPool                 = m_CommandPool;
+			AllocateInfo.level                       = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			AllocateInfo.commandBufferCount          = 1;
+			if (!VK_CHECK(vkAllocateCommandBuffers(m_Device, &AllocateInfo, &m_FrameCommandBuffer)))
+			{
+				return false;
+			}
+
+			VkFenceCreateInfo FenceInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+			if (!VK_CHECK(vkCreateFence(m_Device, &FenceInfo, nullptr, &m_FrameFence)))
+			{
+				return false;
+			}
+
+			if (!AllocateBuffer(&m_UniformRing, k_UniformRingSize, nullptr))
+			{
+				return false;
+			}
+		}
+
+		m_ShaderCompiler = shaderc_compiler_initialize();
+
+		if (m_ShaderCompiler == nullptr)
+		{
+			LOG_F(ERROR, "Cannot initialize the shader compiler");
+			return false;
+		}
+
+		// Frames are presented by the GL context of the window, which is current when the rendering context is created
+		if (gladLoadGL())
+		{
+			glCreateFramebuffers(1, &m_PresentFramebuffer);
+		}
+		else
+		{
+			LOG_F(ERROR, "Vulkan: cannot load OpenGL, frames will not be presented");
+		}
+
+		return StartRecordingThreads();
+	}
+
+	void render_backend::EnableDebugging()
+	{
+		if (!m_HasDebugUtils || m_DebugMessenger != VK_NULL_HANDLE)
+		{
+			return;
+		}
+
+		auto CreateMessenger = (PFN_vkCreateDebugUtilsMessengerEXT)vkGetInstanceProcAddr(m_Instance, "vkCreateDebugUtilsMessengerEXT");
+
+		VkDebugUtilsMessengerCreateInfoEXT MessengerInfo = {VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT};
+		MessengerInfo.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+		MessengerInfo.messageType     = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
+		                            VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
+		MessengerInfo.pfnUserCallback = DebugMessageCallback;
+
+		if (CreateMessenger != nullptr)
+		{
+			VK_CHECK(CreateMessenger(m_Instance, &MessengerInfo, nullptr, &m_DebugMessenger));
+		}
+	}
+
+	void render_backend::DisableDebugging()
+	{
+		if (m_DebugMessenger == VK_NULL_HANDLE)
+		{
+			return;
+		}
+
+		auto DestroyMessenger = (PFN_vkDestroyDebugUtilsMessengerEXT)vkGetInstanceProcAddr(m_Instance, "vkDestroyDebugUtilsMessengerEXT");
+
+		if (DestroyMessenger != nullptr)
+		{
+			DestroyMessenger(m_Instance, m_DebugMessenger, nullptr);
+		}
+
+		m_DebugMessenger = VK_NULL_HANDLE;
+	}
+
+	// Shader section
+	shader_handle render_backend::CreateShaderFromSource(const char* ShaderSource, shader_type ShaderType, const char* ShaderName)
+	{
+		shader_handle Handle = GLUON_INVALID_HANDLE;
+
+		shaderc_compile_options_t Options = shaderc_compile_options_initialize();
+		shaderc_compile_options_set_target_env(Options, shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
+
+		shaderc_compilation_result_t Result = shaderc_compile_into_spv(m_ShaderCompiler,
+		                                                               ShaderSource,
+		                                                               strlen(ShaderSource),
+		                                                               k_ShaderKinds[ShaderType],
+		                                                               ShaderName != nullptr ? ShaderName : "shader",
+		                                                               "main",
+		                                                               Options);
+
+		if (shaderc_result_get_compilation_status(Result) != shaderc_compilation_status_success)
+		{
+			LOG_F(ERROR, "Could not compile Shader %s:\n%s", ShaderName, shaderc_result_get_error_message(Result));
+		}
+		else
+		{
+			shader_info Info;
+			Info.Type = ShaderType;
+			Info.Code.resize(shaderc_result_get_length(Result) / sizeof(u32));
+			memcpy(Info.Code.data(), shaderc_result_get_bytes(Result), Info.Code.size() * sizeof(u32));
+			Info.Module = CreateShaderModule(m_Device, Info.Code);
+
+			if (Info.Module != VK_NULL_HANDLE)
+			{
+				Handle.Idx            = m_NextHandle++;
+				m_Shaders[Handle.Idx] = eastl::move(Info);
+			}
+		}
+
+		shaderc_result_release(Result);
+		shaderc_compile_options_release(Options);
+
+		return Handle;
+	}
+
+	shader_handle render_backend::CreateShaderFromFile(const char* ShaderName, shader_type ShaderType)
+	{
+		FILE* File = fopen(ShaderName, "r");
+		if (!File)
+		{
+			LOG_F(ERROR, "Cannot open file %s", ShaderName);
+			return GLUON_INVALID_HANDLE;
+		}
+
+		fseek(File, 0, SEEK_END);
+		size_t Size = ftell(File);
+		fseek(File, 0, SEEK_SET);
+
+		char* Data = (char*)malloc(Size + 1);
+		if (!Data)
+		{
+			LOG_F(ERROR, "No more memory available");
+			fclose(File);
+			return GLUON_INVALID_HANDLE;
+		}
+
+		Size       = fread(Data, sizeof(char), Size, File);
+		Data[Size] = '\0';
+
+		shader_handle Handle = CreateShaderFromSource(Data, ShaderType, ShaderName);
+
+		free(Data);
+		fclose(File);
+
+		return Handle;
+	}
+
+	void render_backend::DestroyShader(shader_handle Shader)
+	{
+		auto It = m_Shaders.find(Shader.Idx);
+		GLN_ASSERT(It != m_Shaders.end());
+
+		if (It != m_Shaders.end())
+		{
+			vkDestroyShaderModule(m_Device, It->second.Module, nullptr);
+			m_Shaders.erase(It);
+		}
+	}
+
+	program_handle render_backend::CreateProgram(shader_handle VertexShader, shader_handle FragmentShader, bool DeleteShaders)
+	{
+		program_handle Handle = GLUON_INVALID_HANDLE;
+
+		auto VertexIt   = m_Shaders.find(VertexShader.Idx);
+		auto FragmentIt = m_Shaders.find(FragmentShader.Idx);
+
+		if (VertexIt == m_Shaders.end())
+		{
+			LOG_F(ERROR, "Error linking program: invalid vertex shader");
+			return Handle;
+		}
+
+		// Programs own their modules, so that shaders can be destroyed independently
+		program_info Program;
+		Program.VertexModule = CreateShaderModule(m_Device, VertexIt->second.Code);
+		ReflectUniforms(VertexIt->second.Code, &Program);
+
+		if (FragmentIt != m_Shaders.end())
+		{
+			Program.FragmentModule = CreateShaderModule(m_Device, FragmentIt->second.Code);
+			ReflectUniforms(FragmentIt->second.Code, &Program);
+		}
+
+		if (Program.VertexModule == VK_NULL_HANDLE || (FragmentIt != m_Shaders.end() && Program.FragmentModule == VK_NULL_HANDLE))
+		{
+			LOG_F(ERROR, "Error linking program: cannot create its shader modules");
+			vkDestroyShaderModule(m_Device, Program.VertexModule, nullptr);
+			vkDestroyShaderModule(m_Device, Program.FragmentModule, nullptr);
+			return Handle;
+		}
+
+		if (DeleteShaders)
+		{
+			DestroyShader(VertexShader);
+
+			if (FragmentShader.IsValid())
+			{
+				DestroyShader(FragmentShader);
+			}
+		}
+
+		Handle.Idx             = m_NextHandle++;
+		m_Programs[Handle.Idx] = eastl::move(Program);
+
+		return Handle;
+	}
+
+	program_handle render_backend::CreateComputeProgram(shader_handle ComputeShader, bool DeleteShaders)
+	{
+		program_handle Handle = GLUON_INVALID_HANDLE;
+
+		auto ComputeIt = m_Shaders.find(ComputeShader.Idx);
+
+		if (ComputeIt == m_Shaders.end())
+		{
+			LOG_F(ERROR, "Error linking program: invalid compute shader");
+			return Handle;
+		}
+
+		program_info Program;
+		Program.ComputeModule = CreateShaderModule(m_Device, ComputeIt->second.Code);
+		ReflectUniforms(ComputeIt->second.Code, &Program);
+
+		if (Program.ComputeModule == VK_NULL_HANDLE)
+		{
+			LOG_F(ERROR, "Error linking compute program: cannot create its shader module");
+			return Handle;
+		}
+
+		VkComputePipelineCreateInfo PipelineInfo = {VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO};
+		PipelineInfo.stage.sType                 = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		PipelineInfo.stage.stage                 = VK_SHADER_STAGE_COMPUTE_BIT;
+		PipelineInfo.stage.module                = Program.ComputeModule;
+		PipelineInfo.stage.pName                 = "main";
+		PipelineInfo.layout                      = m_PipelineLayout;
+
+		if (vkCreateComputePipelines(m_Device, VK_NULL_HANDLE, 1, &PipelineInfo, nullptr, &Program.ComputePipeline) != VK_SUCCESS)
+		{
+			LOG_F(ERROR, "Error linking compute program");
+			vkDestroyShaderModule(m_Device, Program.ComputeModule, nullptr);
+			return Handle;
+		}
+
+		if (DeleteShaders)
+		{
+			DestroyShader(ComputeShader);
+		}
+
+		Handle.Idx             = m_NextHandle++;
+		m_Programs[Handle.Idx] = eastl::move(Program);
+
+		return Handle;
+	}
+
+	program_handle render_backend::CreateProgramFromSources(const char* VertexSource, const char* FragmentSource, const char* ProgramName)
+	{
+		// Pipelines are created lazily from SPIR-V, there is no driver binary to cache at this point
+		shader_handle VertexShader   = CreateShaderFromSource(VertexSource, ShaderType_Vertex, ProgramName);
+		shader_handle FragmentShader = GLUON_INVALID_HANDLE;
+
+		if (FragmentSource != nullptr)
+		{
+			FragmentShader = CreateShaderFromSource(FragmentSource, ShaderType_Fragment, ProgramName);
+		}
+
+		return CreateProgram(VertexShader, FragmentShader, true);
+	}
+
+	program_handle render_backend::CreateComputeProgramFromSource(const char* ComputeSource, const char* ProgramName)
+	{
+		return CreateComputeProgram(CreateShaderFromSource(ComputeSource, ShaderType_Compute, ProgramName), true);
+	}
+
+	bool render_backend::IsProgramReady(program_handle Program)
+	{
+		// Shaders are compiled to SPIR-V synchronously
+		return m_Programs.find(Program.Idx) != m_Programs.end();
+	}
+
+	void render_backend::SetProgram(program_handle Program) { m_CurrentProgram = Program; }
+
+	void render_backend::DestroyProgram(program_handle Program)
+	{
+		auto It = m_Programs.find(Program.Idx);
+		GLN_ASSERT(It != m_Programs.end());
+
+		if (It == m_Programs.end())
+		{
+			return;
+		}
+
+		vkDeviceWaitIdle(m_Device);
+
+		for (auto PipelineIt = m_GraphicsPipelines.begin(); PipelineIt != m_GraphicsPipelines.end();)
+		{
+			if ((u32)(PipelineIt->first >> 32) == Program.Idx)
+			{
+				vkDestroyPipeline(m_Device, PipelineIt->second, nullptr);
+				PipelineIt = m_GraphicsPipelines.erase(PipelineIt);
+			}
+			else
+			{
+				++PipelineIt;
+			}
+		}
+
+		vkDestroyShaderModule(m_Device, It->second.VertexModule, nullptr);
+		vkDestroyShaderModule(m_Device, It->second.FragmentModule, nullptr);
+		vkDestroyShaderModule(m_Device, It->second.ComputeModule, nullptr);
+		vkDestroyPipeline(m_Device, It->second.ComputePipeline, nullptr);
+
+		m_Programs.erase(It);
+	}
+
+	void render_backend::WriteUniform(const char* UniformName, const void* Value, u32 Size, u32 ColumnCount)
+	{
+		auto ProgramIt = m_Programs.find(m_CurrentProgram.Idx);
+		if (ProgramIt == m_Programs.end())
+		{
+			return;
+		}
+
+		program_info& Program = ProgramIt->second;
+
+		auto UniformIt = Program.Uniforms.find(UniformName);
+		if (UniformIt == Program.Uniforms.end())
+		{
+			return;
+		}
+
+		const uniform_info& Uniform = UniformIt->second;
+
+		// Matrix columns are padded in std140 layouts
+		const u32 Stride = ColumnCount > 1 ? Uniform.MatrixStride : Size;
+
+		for (u32 Column = 0; Column < ColumnCount; ++Column)
+		{
+			const u32 Offset = Uniform.Offset + Column * Stride;
+
+			if (Offset + Size <= (u32)Program.UniformData.size())
+			{
+				memcpy(Program.UniformData.data() + Offset, (const u8*)Value + Column * Size, Size);
+			}
+		}
+	}
+
+	void render_backend::SetUniform(const char* UniformName, i32 Value) { WriteUniform(UniformName, &Value, sizeof(Value)); }
+	void render_backend::SetUniform(const char* UniformName, u32 Value) { WriteUniform(UniformName, &Value, sizeof(Value)); }
+	void render_backend::SetUniform(const char* UniformName, f32 Value) { WriteUniform(UniformName, &Value, sizeof(Value)); }
+	void render_backend::SetUniform(const char* UniformName, const vec2& Value) { WriteUniform(UniformName, &Value, sizeof(Value)); }
+	void render_backend::SetUniform(const char* UniformName, const vec3& Value) { WriteUniform(UniformName, &Value, sizeof(Value)); }
+	void render_backend::SetUniform(const char* UniformName, const vec4& Value) { WriteUniform(UniformName, &Value, sizeof(Value)); }
+	void render_backend::SetUniform(const char* UniformName, const mat2& Value) { WriteUniform(UniformName, &Value, sizeof(vec2), 2); }
+	void render_backend::SetUniform(const char* UniformName, const mat3& Value) { WriteUniform(UniformName, &Value, sizeof(vec3), 3); }
+	void render_backend::SetUniform(const char* UniformName, const mat4& Value) { WriteUniform(UniformName, &Value, sizeof(vec4), 4); }
+
+	void render_backend::SetUniform(const char* UniformName, const i32* Values, u32 Count)
+	{
+		// Sampler arrays are not part of uniform blocks, texture units directly map to the texture binding elements
+		WriteUniform(UniformName, Values, Count * sizeof(i32));
+	}
+
+	// VAO section
+	vertex_array_handle render_backend::CreateVertexArray(buffer_handle IndexBuffer)
+	{
+		vertex_array_handle Handle;
+		Handle.Idx = m_NextHandle++;
+
+		m_VertexArrays[Handle.Idx].IndexBuffer = IndexBuffer;
+
+		return Handle;
+	}
+
+	void render_backend::AttachVertexBuffer(vertex_array_handle VertexArray, buffer_handle VertexBuffer, const vertex_layout& VertexLayout)
+	{
+		vertex_array_info& Info = m_VertexArrays[VertexArray.Idx];
+
+		const u32 Binding = (u32)Info.Bindings.size();
+		Info.Bindings.push_back({VertexBuffer, VertexLayout.GetTotalSize()});
+
+		for (u32 Index = 0; Index < VertexLayout.GetEntryCount(); ++Index)
+		{
+			const auto Entry = VertexLayout.GetEntry(Index);
+
+			VkVertexInputAttributeDescription Attribute;
+			Attribute.location = Index;
+			Attribute.binding  = Binding;
+			Attribute.format   = k_VertexFormats[Entry.DataType][Entry.ElementCount - 1];
+			Attribute.offset   = VertexLayout.GetOffset(Index);
+
+			Info.Attributes.push_back(Attribute);
+		}
+	}
+
+	void render_backend::DestroyVertexArray(vertex_array_handle VertexArray)
+	{
+		GLN_ASSERT(VertexArray.IsValid() && m_VertexArrays.find(VertexArray.Idx) != m_VertexArrays.end());
+		m_VertexArrays.erase(VertexArray.Idx);
+	}
+
+	// Buffers section
+	u32 render_backend::FindMemoryType(u32 TypeBits, VkMemoryPropertyFlags Properties) const
+	{
+		for (u32 Index = 0; Index < m_MemoryProperties.memoryTypeCount; ++Index)
+		{
+			if ((TypeBits & (1u << Index)) && (m_MemoryProperties.memoryTypes[Index].propertyFlags & Properties) == Properties)
+			{
+				return Index;
+			}
+		}
+
+		return k_InvalidHandle;
+	}
+
+	bool render_backend::AllocateBuffer(buffer_info* Info, i64 Size, const void* Data)
+	{
+		Info->Size = Size;
+
+		if (Size <= 0)
+		{
+			return true;
+		}
+
+		VkBufferCreateInfo BufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+		BufferInfo.size               = (VkDeviceSize)Size;
+		BufferInfo.usage              = k_BufferUsage;
+		BufferInfo.sharingMode        = VK_SHARING_MODE_EXCLUSIVE;
+
+		if (vkCreateBuffer(m_Device, &BufferInfo, nullptr, &Info->Buffer) != VK_SUCCESS)
+		{
+			LOG_F(ERROR, "Cannot create buffer of size %lld", (long long)Size);
+			return false;
+		}
+
+		VkMemoryRequirements Requirements;
+		vkGetBufferMemoryRequirements(m_Device, Info->Buffer, &Requirements);
+
+		// Buffers are host visible and persistently mapped, the CPU writes instance data straight into them
+		VkMemoryAllocateInfo AllocateInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+		AllocateInfo.allocationSize       = Requirements.size;
+		AllocateInfo.memoryTypeIndex =
+		    FindMemoryType(Requirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+		if (AllocateInfo.memoryTypeIndex == k_InvalidHandle ||
+		    vkAllocateMemory(m_Device, &AllocateInfo, nullptr, &Info->Memory) != VK_SUCCESS)
+		{
+			LOG_F(ERROR, "Cannot allocate %lld bytes of host visible memory", (long long)Size);
+			vkDestroyBuffer(m_Device, Info->Buffer, nullptr);
+			Info->Buffer = VK_NULL_HANDLE;
+			return false;
+		}
+
+		if (!VK_CHECK(vkBindBufferMemory(m_Device, Info->Buffer, Info->Memory, 0)) ||
+		    !VK_CHECK(vkMapMemory(m_Device, Info->Memory, 0, VK_WHOLE_SIZE, 0, (void**)&Info->Data)))
+		{
+			ReleaseBuffer(*Info);
+			*Info = buffer_info();
+			return false;
+		}
+
+		if (Data != nullptr)
+		{
+			memcpy(Info->Data, Data, Size);
+		}
+
+		return true;
+	}
+
+	void render_backend::ReleaseBuffer(const buffer_info& Info)
+	{
+		if (Info.Buffer != VK_NULL_HANDLE)
+		{
+			vkDestroyBuffer(m_Device, Info.Buffer, nullptr);
+			vkFreeMemory(m_Device, Info.Memory, nullptr);
+		}
+	}
+
+	buffer_handle render_backend::CreateBuffer(i64 Size, const void* Data)
+	{
+		buffer_info Info;
+		if (!AllocateBuffer(&Info, Size, Data))
+		{
+			return GLUON_INVALID_HANDLE;
+		}
+
+		buffer_handle Result;
+		Result.Idx            = m_NextHandle++;
+		m_Buffers[Result.Idx] = Info;
+
+		return Result;
+	}
+
+	buffer_handle render_backend::CreateImmutableBuffer(i64 Size, const void* Data)
+	{
+		buffer_handle Result = CreateBuffer(Size, Data);
+
+		if (Result.IsValid())
+		{
+			m_Buffers[Result.Idx].Immutable = true;
+		}
+
+		return Result;
+	}
+
+	void render_backend::ResizeBuffer(buffer_handle Handle, i64 NewSize, const void* Data)
+	{
+		buffer_info& Info = m_Buffers[Handle.Idx];
+
+		m_PendingBufferReleases.push_back(Info);
+		Info = buffer_info();
+
+		AllocateBuffer(&Info, NewSize, Data);
+	}
+
+	void render_backend::ResizeImmutableBuffer(buffer_handle* Handle, i64 NewSize, const void* Data)
+	{
+		DestroyBuffer(*Handle);
+		*Handle = CreateImmutableBuffer(NewSize, Data);
+	}
+
+	void render_backend::UpdateBufferData(buffer_handle Handle, const void* Data, i64 Offset, i64 Length)
+	{
+		buffer_info& Info = m_Buffers[Handle.Idx];
+
+		if (Length <= 0)
+		{
+			Length = Info.Size - Offset;
+		}
+
+		if (Info.Data != nullptr)
+		{
+			// Buffers are not duplicated per frame, the one in flight may still read them
+			WaitForFrame();
+			memcpy(Info.Data + Offset, Data, Length);
+		}
+	}
+
+	void render_backend::DestroyBuffer(buffer_handle Buffer)
+	{
+		auto It = m_Buffers.find(Buffer.Idx);
+
+		if (It == m_Buffers.end())
+		{
+			LOG_F(ERROR, "Buffer %d is not a buffer", Buffer.Idx);
+			return;
+		}
+
+		m_PendingBufferReleases.push_back(It->second);
+		m_Buffers.erase(It);
+	}
+
+	void* render_backend::MapBuffer(buffer_handle Handle, i64 Offset, i64 Length)
+	{
+		GLN_UNUSED(Length);
+
+		WaitForFrame();
+
+		buffer_info& Info = m_Buffers[Handle.Idx];
+		return Info.Data != nullptr ? Info.Data + Offset : nullptr;
+	}
+
+	void render_backend::UnmapBuffer(buffer_handle Handle)
+	{
+		// Buffers stay mapped for their whole lifetime
+		GLN_UNUSED(Handle);
+	}
+
+	// Texture section
+	texture_handle render_backend::CreateTexture(u32       Width,
+	                                             u32       Height,
+	                                             u32       ComponentCount,
+	                                             data_type DataType,
+	                                             bool      WithMipmaps,
+	                                             void*     Data)
+	{
+		texture_handle Texture;
+		Texture.Idx = m_NextHandle++;
+
+		texture_info& Info  = m_Textures[Texture.Idx];
+		Info.Width          = Width;
+		Info.Height         = Height;
+		Info.ComponentCount = ComponentCount;
+		Info.DataType       = DataType;
+		Info.Format         = k_TextureFormats[ComponentCount][DataType];
+		Info.Levels         = WithMipmaps ? eastl::max(1u, (u32)(log2f(Min((f32)Width, (f32)Height)))) : 1;
+		Info.WrapS          = WrapMode_Repeat;
+		Info.WrapT          = WrapMode_Repeat;
+		Info.MinFilter      = MinFilter_Linear;
+		Info.MagFilter      = MagFilter_Linear;
+
+		if (!CreateImage(&Info))
+		{
+			DestroyTexture(Texture);
+			return GLUON_INVALID_HANDLE;
+		}
+
+		if (Data != nullptr)
+		{
+			SetTextureData(Texture, Data);
+		}
+
+		return Texture;
+	}
+
+	texture_handle render_backend::CreateTextureArray(u32 Width, u32 Height, u32 LayerCount, u32 ComponentCount, data_type DataType)
+	{
+		texture_handle Texture;
+		Texture.Idx = m_NextHandle++;
+
+		texture_info& Info  = m_Textures[Texture.Idx];
+		Info.Width          = Width;
+		Info.Height         = Height;
+		Info.LayerCount     = LayerCount;
+		Info.IsArray        = true;
+		Info.ComponentCount = ComponentCount;
+		Info.DataType       = DataType;
+		Info.Format         = k_TextureFormats[ComponentCount][DataType];
+		Info.Levels         = 1;
+		Info.WrapS          = WrapMode_Repeat;
+		Info.WrapT          = WrapMode_Repeat;
+		Info.MinFilter      = MinFilter_Linear;
+		Info.MagFilter      = MagFilter_Linear;
+
+		if (!CreateImage(&Info))
+		{
+			DestroyTexture(Texture);
+			return GLUON_INVALID_HANDLE;
+		}
+
+		return Texture;
+	}
+
+	bool render_backend::CreateImage(texture_info* Info)
+	{
+		VkImageCreateInfo ImageInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+		ImageInfo.imageType         = VK_IMAGE_TYPE_2D;
+		ImageInfo.format            = Info->Format;
+		ImageInfo.extent            = {Info->Width, Info->Height, 1};
+		ImageInfo.mipLevels         = Info->Levels;
+		ImageInfo.arrayLayers       = Info->LayerCount;
+		ImageInfo.samples           = VK_SAMPLE_COUNT_1_BIT;
+		ImageInfo.tiling            = VK_IMAGE_TILING_OPTIMAL;
+		ImageInfo.usage         = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		ImageInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+		ImageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		if (!VK_CHECK(vkCreateImage(m_Device, &ImageInfo, nullptr, &Info->Image)))
+		{
+			return false;
+		}
+
+		VkMemoryRequirements Requirements;
+		vkGetImageMemoryRequirements(m_Device, Info->Image, &Requirements);
+
+		VkMemoryAllocateInfo AllocateInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+		AllocateInfo.allocationSize       = Requirements.size;
+		AllocateInfo.memoryTypeIndex      = FindMemoryType(Requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		if (AllocateInfo.memoryTypeIndex == k_InvalidHandle)
+		{
+			AllocateInfo.memoryTypeIndex = FindMemoryType(Requirements.memoryTypeBits, 0);
+		}
+
+		if (!VK_CHECK(vkAllocateMemory(m_Device, &AllocateInfo, nullptr, &Info->Memory)) ||
+		    !VK_CHECK(vkBindImageMemory(m_Device, Info->Image, Info->Memory, 0)))
+		{
+			return false;
+		}
+
+		// Arrays keep an array view even with a single layer, it has to match the sampler2DArray of the shaders
+		VkImageViewCreateInfo ViewInfo           = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+		ViewInfo.image                           = Info->Image;
+		ViewInfo.viewType                        = Info->IsArray ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+		ViewInfo.format                          = Info->Format;
+		ViewInfo.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+		ViewInfo.subresourceRange.baseMipLevel   = 0;
+		ViewInfo.subresourceRange.levelCount     = Info->Levels;
+		ViewInfo.subresourceRange.baseArrayLayer = 0;
+		ViewInfo.subresourceRange.layerCount     = Info->LayerCount;
+		if (!VK_CHECK(vkCreateImageView(m_Device, &ViewInfo, nullptr, &Info->View)))
+		{
+			return false;
+		}
+
+		return RecreateSampler(Info);
+	}
+
+	static u32 GetStagingTexelSize(const texture_info& Info)
+	{
+		// RGB images are stored as RGBA, see CreateTexture
+		return (Info.ComponentCount == 3 ? 4 : Info.ComponentCount) * GetDataTypeSize(Info.DataType);
+	}
+
+	static void CopyTexelsToStaging(const texture_info& Info, const void* Data, u64 TexelCount, u8* Destination)
+	{
+		const u32 ElementSize = GetDataTypeSize(Info.DataType);
+
+		if (Info.ComponentCount != 3)
+		{
+			memcpy(Destination, Data, TexelCount * Info.ComponentCount * ElementSize);
+			return;
+		}
+
+		// Expand RGB to RGBA, the alpha channel is set to its maximum value
+		const u8* Source = (const u8*)Data;
+
+		u8 Alpha[4];
+		switch (Info.DataType)
+		{
+			case DataType_Float:
+			{
+				const f32 One = 1.0f;
+				memcpy(Alpha, &One, sizeof(One));
+				break;
+			}
+
+			case DataType_Int:
+			case DataType_UnsignedInt:
+				memset(Alpha, 0, sizeof(Alpha));
+				break;
+
+			default:
+				memset(Alpha, 0xFF, sizeof(Alpha));
+				break;
+		}
+
+		for (u64 Texel = 0; Texel < TexelCount; ++Texel)
+		{
+			memcpy(Destination, Source, 3 * ElementSize);
+			memcpy(Destination + 3 * ElementSize, Alpha, ElementSize);
+
+			Source += 3 * ElementSize;
+			Destination += 4 * ElementSize;
+		}
+	}
+
+	void render_backend::SetTextureData(texture_handle Texture, void* Data)
+	{
+		texture_info& Info = m_Textures[Texture.Idx];
+
+		// The texture may still be sampled by the frame in flight
+		WaitForFrame();
+
+		const u64 TexelCount = (u64)Info.Width * Info.Height;
+
+		buffer_info Staging;
+		if (!AllocateBuffer(&Staging, TexelCount * GetStagingTexelSize(Info), nullptr))
+		{
+			return;
+		}
+
+		CopyTexelsToStaging(Info, Data, TexelCount, Staging.Data);
+
+		VkCommandBuffer CommandBuffer = BeginImmediateCommands();
+
+		if (CommandBuffer == VK_NULL_HANDLE)
+		{
+			ReleaseBuffer(Staging);
+			return;
+		}
+
+		ImageBarrier(CommandBuffer,
+		             Info.Image,
+		             0,
+		             Info.Levels,
+		             VK_IMAGE_LAYOUT_UNDEFINED,
+		             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		             0,
+		             VK_ACCESS_TRANSFER_WRITE_BIT,
+		             VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+		             VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+		VkBufferImageCopy Region               = {};
+		Region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+		Region.imageSubresource.mipLevel       = 0;
+		Region.imageSubresource.baseArrayLayer = 0;
+		Region.imageSubresource.layerCount     = 1;
+		Region.imageExtent                     = {Info.Width, Info.Height, 1};
+
+		vkCmdCopyBufferToImage(CommandBuffer, Staging.Buffer, Info.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &Region);
+
+		// Mipmaps are generated by successive blits from the previous level
+		i32 LevelWidth = (i32)Info.Width, LevelHeight = (i32)Info.Height;
+		for (u32 Level = 1; Level < Info.Levels; ++Level)
+		{
+			ImageBarrier(CommandBuffer,
+			             Info.Image,
+			             Level - 1,
+			             1,
+			             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			             VK_ACCESS_TRANSFER_WRITE_BIT,
+			             VK_ACCESS_TRANSFER_READ_BIT,
+			             VK_PIPELINE_STAGE_TRANSFER_BIT,
+			             VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+			const i32 NextWidth = LevelWidth > 1 ? LevelWidth / 2 : 1, NextHeight = LevelHeight > 1 ? LevelHeight / 2 : 1;
+
+			VkImageBlit Blit                   = {};
+			Blit.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+			Blit.srcSubresource.mipLevel       = Level - 1;
+			Blit.srcSubresource.layerCount     = 1;
+			Blit.srcOffsets[1]                 = {LevelWidth, LevelHeight, 1};
+			Blit.dstSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+			Blit.dstSubresource.mipLevel       = Level;
+			Blit.dstSubresource.layerCount     = 1;
+			Blit.dstOffsets[1]                 = {NextWidth, NextHeight, 1};
+
+			vkCmdBlitImage(CommandBuffer,
+			               Info.Image,
+			               VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			               Info.Image,
+			               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			               1,
+			               &Blit,
+			               VK_FILTER_LINEAR);
+
+			ImageBarrier(CommandBuffer,
+			             Info.Image,
+			             Level - 1,
+			             1,
+			             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			             VK_ACCESS_TRANSFER_READ_BIT,
+			             VK_ACCESS_SHADER_READ_BIT,
+			             VK_PIPELINE_STAGE_TRANSFER_BIT,
+			             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+			LevelWidth  = NextWidth;
+			LevelHeight = NextHeight;
+		}
+
+		ImageBarrier(CommandBuffer,
+		             Info.Image,
+		             Info.Levels - 1,
+		             1,
+		             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		             VK_ACCESS_TRANSFER_WRITE_BIT,
+		             VK_ACCESS_SHADER_READ_BIT,
+		             VK_PIPELINE_STAGE_TRANSFER_BIT,
+		             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+		EndImmediateCommands(CommandBuffer);
+
+		ReleaseBuffer(Staging);
+
+		Info.Uploaded = true;
+	}
+
+	void render_backend::SetTextureSubData(texture_handle Texture, u32 X, u32 Y, u32 Width, u32 Height, const void* Data)
+	{
+		SetTextureLayerSubData(Texture, 0, X, Y, Width, Height, Data);
+	}
+
+	void render_backend::SetTextureLayerSubData(texture_handle Texture, u32 Layer, u32 X, u32 Y, u32 Width, u32 Height, const void* Data)
+	{
+		texture_info& Info = m_Textures[Texture.Idx];
+
+		WaitForFrame();
+
+		const u64 TexelCount = (u64)Width * Height;
+
+		buffer_info Staging;
+		if (!AllocateBuffer(&Staging, TexelCount * GetStagingTexelSize(Info), nullptr))
+		{
+			return;
+		}
+
+		CopyTexelsToStaging(Info, Data, TexelCount, Staging.Data);
+
+		VkCommandBuffer CommandBuffer = BeginImmediateCommands();
+
+		if (CommandBuffer == VK_NULL_HANDLE)
+		{
+			ReleaseBuffer(Staging);
+			return;
+		}
+
+		// The rest of the image, and the other layers, have to be preserved once it holds data
+		const VkImageLayout OldLayout = Info.Uploaded ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+
+		ImageBarrier(CommandBuffer,
+		             Info.Image,
+		             0,
+		             Info.Levels,
+		             OldLayout,
+		             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		             VK_ACCESS_SHADER_READ_BIT,
+		             VK_ACCESS_TRANSFER_WRITE_BIT,
+		             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+		             VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+		VkBufferImageCopy Region               = {};
+		Region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+		Region.imageSubresource.mipLevel       = 0;
+		Region.imageSubresource.baseArrayLayer = Layer;
+		Region.imageSubresource.layerCount     = 1;
+		Region.imageOffset                     = {(i32)X, (i32)Y, 0};
+		Region.imageExtent                     = {Width, Height, 1};
+
+		vkCmdCopyBufferToImage(CommandBuffer, Staging.Buffer, Info.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &Region);
+
+		// Mipmaps are left untouched, regions are meant for textures without mipmaps
+		ImageBarrier(CommandBuffer,
+		             Info.Image,
+		             0,
+		             Info.Levels,
+		             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		             VK_ACCESS_TRANSFER_WRITE_BIT,
+		             VK_ACCESS_SHADER_READ_BIT,
+		             VK_PIPELINE_STAGE_TRANSFER_BIT,
+		             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+		EndImmediateCommands(CommandBuffer);
+
+		ReleaseBuffer(Staging);
+
+		Info.Uploaded = true;
+	}
+
+	bool render_backend::RecreateSampler(texture_info* Info)
+	{
+		if (Info->Sampler != VK_NULL_HANDLE)
+		{
+			WaitForFrame();
+
+			vkDestroySampler(m_Device, Info->Sampler, nullptr);
+		}
+
+		auto GetWrapMode = [this](wrap_mode WrapMode) {
+			if (WrapMode == WrapMode_MirrorClampToEdge && !m_HasMirrorClampToEdge)
+			{
+				return VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			}
+			return k_WrapModes[WrapMode];
+		};
+
+		VkSamplerCreateInfo SamplerInfo = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+		SamplerInfo.magFilter           = k_MagFilters[Info->MagFilter];
+		SamplerInfo.minFilter           = k_MinFilters[Info->MinFilter];
+		SamplerInfo.mipmapMode          = k_MipmapModes[Info->MinFilter];
+		SamplerInfo.addressModeU        = GetWrapMode(Info->WrapS);
+		SamplerInfo.addressModeV        = GetWrapMode(Info->WrapT);
+		SamplerInfo.addressModeW        = GetWrapMode(Info->WrapT);
+		SamplerInfo.minLod              = 0.0f;
+		SamplerInfo.maxLod              = Info->MinFilter <= MinFilter_Linear ? 0.25f : (f32)Info->Levels;
+		SamplerInfo.borderColor         = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+
+		if (!VK_CHECK(vkCreateSampler(m_Device, &SamplerInfo, nullptr, &Info->Sampler)))
+		{
+			Info->Sampler = VK_NULL_HANDLE;
+			return false;
+		}
+
+		return true;
+	}
+
+	void render_backend::SetTextureWrapping(texture_handle Texture, wrap_mode WrapS, wrap_mode WrapT)
+	{
+		texture_info& Info = m_Textures[Texture.Idx];
+		Info.WrapS         = WrapS;
+		Info.WrapT         = WrapT;
+		RecreateSampler(&Info);
+	}
+
+	void render_backend::SetTextureFiltering(texture_handle Texture, min_filter MinFilter, mag_filter MagFilter)
+	{
+		texture_info& Info = m_Textures[Texture.Idx];
+		Info.MinFilter     = MinFilter;
+		Info.MagFilter     = MagFilter;
+		RecreateSampler(&Info);
+	}
+
+	void render_backend::DestroyTexture(texture_handle Texture)
+	{
+		auto It = m_Textures.find(Texture.Idx);
+		GLN_ASSERT(Texture.IsValid() && It != m_Textures.end());
+
+		if (It == m_Textures.end())
+		{
+			return;
+		}
+
+		WaitForFrame();
+
+		vkDestroySampler(m_Device, It->second.Sampler, nullptr);
+		vkDestroyImageView(m_Device, It->second.View, nullptr);
+		vkDestroyImage(m_Device, It->second.Image, nullptr);
+		vkFreeMemory(m_Device, It->second.Memory, nullptr);
+
+		m_Textures.erase(It);
+	}
+
+	// Every draw is recorded in the single render pass targeting the color image presented through GL, there is no render pass for
+	// texture layers yet. Callers check for the invalid handle, the renderer disables its bitmap cache up front.
+	framebuffer_handle render_backend::CreateFramebuffer(texture_handle TextureArray, u32 Layer)
+	{
+		GLN_UNUSED(TextureArray);
+		GLN_UNUSED(Layer);
+
+		return GLUON_INVALID_HANDLE;
+	}
+
+	void render_backend::DestroyFramebuffer(framebuffer_handle Framebuffer) { GLN_UNUSED(Framebuffer); }
+
+	VkCommandBuffer render_backend::BeginImmediateCommands()
+	{
+		VkCommandBufferAllocateInfo AllocateInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+		AllocateInfo.commandPool                 = m_CommandPool;
+		AllocateInfo.level                       = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		AllocateInfo.commandBufferCount          = 1;
+
+		VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+		if (!VK_CHECK(vkAllocateCommandBuffers(m_Device, &AllocateInfo, &CommandBuffer)))
+		{
+			return VK_NULL_HANDLE;
+		}
+
+		VkCommandBufferBeginInfo BeginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+		BeginInfo.flags                    = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		if (!VK_CHECK(vkBeginCommandBuffer(CommandBuffer, &BeginInfo)))
+		{
+			vkFreeCommandBuffers(m_Device, m_CommandPool, 1, &CommandBuffer);
+			return VK_NULL_HANDLE;
+		}
+
+		return CommandBuffer;
+	}
+
+	void render_backend::EndImmediateCommands(VkCommandBuffer CommandBuffer)
+	{
+		if (VK_CHECK(vkEndCommandBuffer(CommandBuffer)))
+		{
+			VkSubmitInfo SubmitInfo       = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+			SubmitInfo.commandBufferCount = 1;
+			SubmitInfo.pCommandBuffers    = &CommandBuffer;
+
+			if (VK_CHECK(vkQueueSubmit(m_Queue, 1, &SubmitInfo, VK_NULL_HANDLE)))
+			{
+				VK_CHECK(vkQueueWaitIdle(m_Queue));
+			}
+		}
+
+		vkFreeCommandBuffers(m_Device, m_CommandPool, 1, &CommandBuffer);
+	}
+
+	// Render target section
+	bool render_backend::RecreateRenderTarget(u32 Width, u32 Height)
+	{
+		vkDeviceWaitIdle(m_Device);
+		DestroyRenderTarget();
+
+		m_TargetWidth  = Width;
+		m_TargetHeight = Height;
+
+		VkImageCreateInfo ImageInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+		ImageInfo.imageType         = VK_IMAGE_TYPE_2D;
+		ImageInfo.format            = VK_FORMAT_R8G8B8A8_UNORM;
+		ImageInfo.extent            = {Width, Height, 1};
+		ImageInfo.mipLevels         = 1;
+		ImageInfo.arrayLayers       = 1;
+		ImageInfo.samples           = VK_SAMPLE_COUNT_1_BIT;
+		ImageInfo.tiling            = VK_IMAGE_TILING_OPTIMAL;
+		ImageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		ImageInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+		ImageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		if (!VK_CHECK(vkCreateImage(m_Device, &ImageInfo, nullptr, &m_ColorImage)))
+		{
+			return false;
+		}
+
+		VkMemoryRequirements Requirements;
+		vkGetImageMemoryRequirements(m_Device, m_ColorImage, &Requirements);
+
+		VkMemoryAllocateInfo AllocateInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+		AllocateInfo.allocationSize       = Requirements.size;
+		AllocateInfo.memoryTypeIndex      = FindMemoryType(Requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		if (AllocateInfo.memoryTypeIndex == k_InvalidHandle)
+		{
+			AllocateInfo.memoryTypeIndex = FindMemoryType(Requirements.memoryTypeBits, 0);
+		}
+
+		if (!VK_CHECK(vkAllocateMemory(m_Device, &AllocateInfo, nullptr, &m_ColorMemory)) ||
+		    !VK_CHECK(vkBindImageMemory(m_Device, m_ColorImage, m_ColorMemory, 0)))
+		{
+			return false;
+		}
+
+		VkImageViewCreateInfo ViewInfo       = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+		ViewInfo.image                       = m_ColorImage;
+		ViewInfo.viewType                    = VK_IMAGE_VIEW_TYPE_2D;
+		ViewInfo.format                      = VK_FORMAT_R8G8B8A8_UNORM;
+		ViewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		ViewInfo.subresourceRange.levelCount = 1;
+		ViewInfo.subresourceRange.layerCount = 1;
+		if (!VK_CHECK(vkCreateImageView(m_Device, &ViewInfo, nullptr, &m_ColorView)))
+		{
+			return false;
+		}
+
+		VkFramebufferCreateInfo FramebufferInfo = {VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO};
+		FramebufferInfo.renderPass              = m_RenderPass;
+		FramebufferInfo.attachmentCount         = 1;
+		FramebufferInfo.pAttachments            = &m_ColorView;
+		FramebufferInfo.width                   = Width;
+		FramebufferInfo.height                  = Height;
+		FramebufferInfo.layers                  = 1;
+		if (!VK_CHECK(vkCreateFramebuffer(m_Device, &FramebufferInfo, nullptr, &m_Framebuffer)))
+		{
+			return false;
+		}
+
+		// Tightly packed RGBA8 rows, copied from the target after the render pass. Frames are presented without readback when
+		// the buffers cannot be allocated.
+		for (buffer_info& Readback : m_Readbacks)
+		{
+			if (!AllocateBuffer(&Readback, (i64)Width * Height * 4, nullptr))
+			{
+				Readback = {};
+			}
+		}
+
+		if (m_PresentFramebuffer != 0)
+		{
+			glCreateTextures(GL_TEXTURE_2D, 1, &m_PresentTexture);
+			glTextureStorage2D(m_PresentTexture, 1, GL_RGBA8, Width, Height);
+			glNamedFramebufferTexture(m_PresentFramebuffer, GL_COLOR_ATTACHMENT0, m_PresentTexture, 0);
+		}
+
+		return true;
+	}
+
+	void render_backend::DestroyRenderTarget()
+	{
+		// Also releases what a failed RecreateRenderTarget() managed to create
+		vkDestroyFramebuffer(m_Device, m_Framebuffer, nullptr);
+		vkDestroyImageView(m_Device, m_ColorView, nullptr);
+		vkDestroyImage(m_Device, m_ColorImage, nullptr);
+		vkFreeMemory(m_Device, m_ColorMemory, nullptr);
+
+		m_Framebuffer = VK_NULL_HANDLE;
+		m_ColorView   = VK_NULL_HANDLE;
+		m_ColorImage  = VK_NULL_HANDLE;
+		m_ColorMemory = VK_NULL_HANDLE;
+
+		for (u32 Index = 0; Index < k_ReadbackCount; ++Index)
+		{
+			ReleaseBuffer(m_Readbacks[Index]);
+			m_Readbacks[Index]     = {};
+			m_ReadbackReady[Index] = false;
+		}
+
+		if (m_PresentTexture != 0)
+		{
+			glDeleteTextures(1, &m_PresentTexture);
+			m_PresentTexture = 0;
+		}
+	}
+
+	void render_backend::PresentRenderTarget()
+	{
+		if (m_PresentTexture == 0)
+		{
+			return;
+		}
+
+		// The previous frame was waited for before this one was recorded, its readback is presented without waiting. Right after
+		// the target has been recreated there is none yet, the frame just submitted is waited for instead.
+		u32 Index = (m_ReadbackIndex + k_ReadbackCount - 1) % k_ReadbackCount;
+
+		if (!m_ReadbackReady[Index])
+		{
+			Index = m_ReadbackIndex;
+
+			if (!m_ReadbackReady[Index])
+			{
+				return;
+			}
+
+			WaitForFrame();
+		}
+
+		const i32 Width  = (i32)m_TargetWidth;
+		const i32 Height = (i32)m_TargetHeight;
+
+		glTextureSubImage2D(m_PresentTexture, 0, 0, 0, Width, Height, GL_RGBA, GL_UNSIGNED_BYTE, m_Readbacks[Index].Data);
+
+		// Row 0 of the target is the top of the window, and the bottom of the GL default framebuffer
+		glBlitNamedFramebuffer(m_PresentFramebuffer, 0, 0, 0, Width, Height, 0, Height, Width, 0, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	}
+
+	// Draw section
+	VkPipeline render_backend::GetGraphicsPipeline(program_handle Program, vertex_array_handle VertexArray, bool Blending)
+	{
+		const u64 Key = ((u64)Program.Idx << 32) | ((u64)VertexArray.Idx << 1) | (Blending ? 1 : 0);
+
+		auto It = m_GraphicsPipelines.find(Key);
+		if (It != m_GraphicsPipelines.end())
+		{
+			return It->second;
+		}
+
+		const program_info&      ProgramInfo     = m_Programs[Program.Idx];
+		const vertex_array_info& VertexArrayInfo = m_VertexArrays[VertexArray.Idx];
+
+		VkPipelineShaderStageCreateInfo Stages[2] = {};
+		Stages[0].sType                           = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		Stages[0].stage                           = VK_SHADER_STAGE_VERTEX_BIT;
+		Stages[0].module                          = ProgramInfo.VertexModule;
+		Stages[0].pName                           = "main";
+		Stages[1].sType                           = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		Stages[1].stage                           = VK_SHADER_STAGE_FRAGMENT_BIT;
+		Stages[1].module                          = ProgramInfo.FragmentModule;
+		Stages[1].pName                           = "main";
+
+		eastl::vector<VkVertexInputBindingDescription> Bindings;
+		for (u32 Index = 0; Index < (u32)VertexArrayInfo.Bindings.size(); ++Index)
+		{
+			Bindings.push_back({Index, VertexArrayInfo.Bindings[Index].Stride, VK_VERTEX_INPUT_RATE_VERTEX});
+		}
+
+		VkPipelineVertexInputStateCreateInfo VertexInput = {VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
+		VertexInput.vertexBindingDescriptionCount        = (u32)Bindings.size();
+		VertexInput.pVertexBindingDescriptions           = Bindings.data();
+		VertexInput.vertexAttributeDescriptionCount      = (u32)VertexArrayInfo.Attributes.size();
+		VertexInput.pVertexAttributeDescriptions         = VertexArrayInfo.Attributes.data();
+
+		VkPipelineInputAssemblyStateCreateInfo InputAssembly = {VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO};
+		InputAssembly.topology                               = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+		VkPipelineViewportStateCreateInfo ViewportState = {VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO};
+		ViewportState.viewportCount                     = 1;
+		ViewportState.scissorCount                      = 1;
+
+		VkPipelineRasterizationStateCreateInfo Rasterization = {VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO};
+		Rasterization.polygonMode                            = VK_POLYGON_MODE_FILL;
+		Rasterization.cullMode                               = VK_CULL_MODE_NONE;
+		Rasterization.frontFace                              = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+		Rasterization.lineWidth                              = 1.0f;
+
+		VkPipelineMultisampleStateCreateInfo Multisample = {VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO};
+		Multisample.rasterizationSamples                 = VK_SAMPLE_COUNT_1_BIT;
+
+		VkPipelineColorBlendAttachmentState BlendAttachment = {};
+		BlendAttachment.blendEnable                         = Blending ? VK_TRUE : VK_FALSE;
+		BlendAttachment.srcColorBlendFactor                 = VK_BLEND_FACTOR_SRC_ALPHA;
+		BlendAttachment.dstColorBlendFactor                 = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		BlendAttachment.colorBlendOp                        = VK_BLEND_OP_ADD;
+		BlendAttachment.srcAlphaBlendFactor                 = VK_BLEND_FACTOR_SRC_ALPHA;
+		BlendAttachment.dstAlphaBlendFactor                 = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		BlendAttachment.alphaBlendOp                        = VK_BLEND_OP_ADD;
+		BlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT |
+		                                 VK_COLOR_COMPONENT_A_BIT;
+
+		VkPipelineColorBlendStateCreateInfo ColorBlend = {VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO};
+		ColorBlend.attachmentCount                     = 1;
+		ColorBlend.pAttachments                        = &BlendAttachment;
+
+		const VkDynamicState DynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+
+		VkPipelineDynamicStateCreateInfo DynamicState = {VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO};
+		DynamicState.dynamicStateCount                = (u32)GLN_ARRAY_SIZE(DynamicStates);
+		DynamicState.pDynamicStates                   = DynamicStates;
+
+		VkGraphicsPipelineCreateInfo PipelineInfo = {VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+		PipelineInfo.stageCount                   = ProgramInfo.FragmentModule != VK_NULL_HANDLE ? 2 : 1;
+		PipelineInfo.pStages                      = Stages;
+		PipelineInfo.pVertexInputState            = &VertexInput;
+		PipelineInfo.pInputAssemblyState          = &InputAssembly;
+		PipelineInfo.pViewportState               = &ViewportState;
+		PipelineInfo.pRasterizationState          = &Rasterization;
+		PipelineInfo.pMultisampleState            = &Multisample;
+		PipelineInfo.pColorBlendState             = &ColorBlend;
+		PipelineInfo.pDynamicState                = &DynamicState;
+		PipelineInfo.layout                       = m_PipelineLayout;
+		PipelineInfo.renderPass                   = m_RenderPass;
+		PipelineInfo.subpass                      = 0;
+
+		VkPipeline Pipeline = VK_NULL_HANDLE;
+		if (vkCreateGraphicsPipelines(m_Device, VK_NULL_HANDLE, 1, &PipelineInfo, nullptr, &Pipeline) != VK_SUCCESS)
+		{
+			LOG_F(ERROR, "Cannot create graphics pipeline for program %d", Program.Idx);
+		}
+
+		m_GraphicsPipelines[Key] = Pipeline;
+
+		return Pipeline;
+	}
+
+	void render_backend::WaitForFrame()
+	{
+		if (m_FrameSubmitted)
+		{
+			vkWaitForFences(m_Device, 1, &m_FrameFence, VK_TRUE, UINT64_MAX);
+			vkResetFences(m_Device, 1, &m_FrameFence);
+			m_FrameSubmitted = false;
+		}
+	}
+
+	void render_backend::BeginFrame()
+	{
+		WaitForFrame();
+
+		for (const auto& Buffer : m_PendingBufferReleases)
+		{
+			ReleaseBuffer(Buffer);
+		}
+		m_PendingBufferReleases.clear();
+
+		vkResetDescriptorPool(m_Device, m_DescriptorPool, 0);
+
+		m_UniformRingOffset = 0;
+		m_Packets.clear();
+		m_Dispatches.clear();
+	}
+
+	bool render_backend::WriteDescriptorSet(draw_packet* Packet)
+	{
+		VkDescriptorSetAllocateInfo AllocateInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+		AllocateInfo.descriptorPool              = m_DescriptorPool;
+		AllocateInfo.descriptorSetCount          = 1;
+		AllocateInfo.pSetLayouts                 = &m_DescriptorSetLayout;
+
+		if (vkAllocateDescriptorSets(m_Device, &AllocateInfo, &Packet->DescriptorSet) != VK_SUCCESS)
+		{
+			LOG_F(ERROR, "Too many draw calls in a single frame");
+			return false;
+		}
+
+		VkDescriptorBufferInfo UniformInfo = {m_UniformRing.Buffer, 0, eastl::max(16u, Packet->UniformSize)};
+		VkDescriptorBufferInfo StorageInfos[k_MaxStorageBindings];
+		VkDescriptorImageInfo  ImageInfos[k_MaxTextureUnits];
+		VkWriteDescriptorSet   Writes[1 + k_MaxStorageBindings + k_MaxTextureUnits];
+		u32                    WriteCount = 0;
+
+		auto AddWrite = [&](u32 Binding, u32 Element, VkDescriptorType Type) -> VkWriteDescriptorSet& {
+			VkWriteDescriptorSet& Write = Writes[WriteCount++];
+			Write                       = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+			Write.dstSet                = Packet->DescriptorSet;
+			Write.dstBinding            = Binding;
+			Write.dstArrayElement       = Element;
+			Write.descriptorCount       = 1;
+			Write.descriptorType        = Type;
+			return Write;
+		};
+
+		AddWrite(k_UniformBinding, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC).pBufferInfo = &UniformInfo;
+
+		for (u32 Index = 0; Index < k_MaxStorageBindings; ++Index)
+		{
+			auto It = m_Buffers.find(Packet->StorageBuffers[Index].Idx);
+			if (It != m_Buffers.end() && It->second.Buffer != VK_NULL_HANDLE)
+			{
+				StorageInfos[Index] = {It->second.Buffer, 0, VK_WHOLE_SIZE};
+				AddWrite(k_FirstStorageBinding + Index, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER).pBufferInfo = &StorageInfos[Index];
+			}
+		}
+
+		for (u32 Unit = 0; Unit < k_MaxTextureUnits; ++Unit)
+		{
+			auto It = m_Textures.find(Packet->Textures[Unit].Idx);
+			if (It != m_Textures.end() && It->second.Sampler != VK_NULL_HANDLE)
+			{
+				ImageInfos[Unit] = {It->second.Sampler, It->second.View, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+				AddWrite(k_TextureBinding, Unit, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER).pImageInfo = &ImageInfos[Unit];
+			}
+		}
+
+		vkUpdateDescriptorSets(m_Device, WriteCount, Writes, 0, nullptr);
+
+		return true;
+	}
+
+	void render_backend::EndFrame()
+	{
+		if (m_Framebuffer == VK_NULL_HANDLE)
+		{
+			return;
+		}
+
+		// Pipelines and descriptor sets are resolved on this thread, recording threads only read them
+		for (draw_packet& Packet : m_Packets)
+		{
+			Packet.Pipeline = GetGraphicsPipeline(Packet.Program, Packet.VertexArray, Packet.Blending);
+
+			if (!WriteDescriptorSet(&Packet))
+			{
+				Packet.Pipeline = VK_NULL_HANDLE;
+			}
+		}
+
+		for (draw_packet& Dispatch : m_Dispatches)
+		{
+			auto ProgramIt = m_Programs.find(Dispatch.Program.Idx);
+
+			Dispatch.Pipeline = ProgramIt != m_Programs.end() ? ProgramIt->second.ComputePipeline : VK_NULL_HANDLE;
+
+			if (!WriteDescriptorSet(&Dispatch))
+			{
+				Dispatch.Pipeline = VK_NULL_HANDLE;
+			}
+		}
+
+		// Split the packets in contiguous ranges, one per recording thread, so that the draw order is preserved
+		const u32 PacketCount = (u32)m_Packets.size();
+		const u32 ThreadCount = (u32)m_Recorders.size();
+		const u32 ChunkSize   = (PacketCount + ThreadCount - 1) / ThreadCount;
+
+		for (u32 Index = 0; Index < ThreadCount; ++Index)
+		{
+			const u32 First = eastl::min(Index * ChunkSize, PacketCount);
+
+			m_Recorders[Index].FirstPacket = First;
+			m_Recorders[Index].PacketCount = eastl::min(First + ChunkSize, PacketCount) - First;
+		}
+
+		{
+			std::lock_guard<std::mutex> Lock(m_RecordingMutex);
+			m_PendingRecorders = ThreadCount;
+			++m_RecordingGeneration;
+		}
+		m_RecordingStart.notify_all();
+
+		{
+			std::unique_lock<std::mutex> Lock(m_RecordingMutex);
+			m_RecordingDone.wait(Lock, [this]() { return m_PendingRecorders == 0; });
+		}
+
+		VkCommandBufferBeginInfo BeginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+		BeginInfo.flags                    = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		if (!VK_CHECK(vkBeginCommandBuffer(m_FrameCommandBuffer, &BeginInfo)))
+		{
+			return;
+		}
+
+		// Dispatches cannot be recorded inside a render pass, they all run before the draws of the frame
+		if (!m_Dispatches.empty())
+		{
+			for (const draw_packet& Dispatch : m_Dispatches)
+			{
+				if (Dispatch.Pipeline == VK_NULL_HANDLE)
+				{
+					continue;
+				}
+
+				vkCmdBindPipeline(m_FrameCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, Dispatch.Pipeline);
+				vkCmdBindDescriptorSets(m_FrameCommandBuffer,
+				                        VK_PIPELINE_BIND_POINT_COMPUTE,
+				                        m_PipelineLayout,
+				                        0,
+				                        1,
+				                        &Dispatch.DescriptorSet,
+				                        1,
+				                        &Dispatch.UniformOffset);
+				vkCmdDispatch(m_FrameCommandBuffer, Dispatch.GroupCounts[0], Dispatch.GroupCounts[1], Dispatch.GroupCounts[2]);
+			}
+
+			VkMemoryBarrier Barrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+			Barrier.srcAccessMask   = VK_ACCESS_SHADER_WRITE_BIT;
+			Barrier.dstAccessMask   = VK_ACCESS_SHADER_READ_BIT;
+
+			vkCmdPipelineBarrier(m_FrameCommandBuffer,
+			                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			                     VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			                     0,
+			                     1,
+			                     &Barrier,
+			                     0,
+			                     nullptr,
+			                     0,
+			                     nullptr);
+		}
+
+		VkClearValue ClearValue;
+		ClearValue.color = m_ClearColor;
+
+		VkRenderPassBeginInfo RenderPassInfo = {VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
+		RenderPassInfo.renderPass            = m_RenderPass;
+		RenderPassInfo.framebuffer           = m_Framebuffer;
+		RenderPassInfo.renderArea.extent     = {m_TargetWidth, m_TargetHeight};
+		RenderPassInfo.clearValueCount       = 1;
+		RenderPassInfo.pClearValues          = &ClearValue;
+
+		vkCmdBeginRenderPass(m_FrameCommandBuffer, &RenderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+		eastl::vector<VkCommandBuffer> Secondaries;
+		for (const auto& Recorder : m_Recorders)
+		{
+			if (Recorder.PacketCount > 0)
+			{
+				Secondaries.push_back(Recorder.CommandBuffer);
+			}
+		}
+
+		if (!Secondaries.empty())
+		{
+			vkCmdExecuteCommands(m_FrameCommandBuffer, (u32)Secondaries.size(), Secondaries.data());
+		}
+
+		vkCmdEndRenderPass(m_FrameCommandBuffer);
+
+		// The render pass leaves the target in TRANSFER_SRC_OPTIMAL
+		const buffer_info& Readback      = m_Readbacks[m_ReadbackIndex];
+		m_ReadbackReady[m_ReadbackIndex] = false;
+
+		if (Readback.Buffer != VK_NULL_HANDLE)
+		{
+			VkBufferImageCopy Region           = {};
+			Region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			Region.imageSubresource.layerCount = 1;
+			Region.imageExtent                 = {m_TargetWidth, m_TargetHeight, 1};
+
+			vkCmdCopyImageToBuffer(m_FrameCommandBuffer, m_ColorImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, Readback.Buffer, 1, &Region);
+
+			VkMemoryBarrier Barrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+			Barrier.srcAccessMask   = VK_ACCESS_TRANSFER_WRITE_BIT;
+			Barrier.dstAccessMask   = VK_ACCESS_HOST_READ_BIT;
+
+			vkCmdPipelineBarrier(m_FrameCommandBuffer,
+			                     VK_PIPELINE_STAGE_TRANSFER_BIT,
+			                     VK_PIPELINE_STAGE_HOST_BIT,
+			                     0,
+			                     1,
+			                     &Barrier,
+			                     0,
+			                     nullptr,
+			                     0,
+			                     nullptr);
+		}
+
+		if (!VK_CHECK(vkEndCommandBuffer(m_FrameCommandBuffer)))
+		{
+			return;
+		}
+
+		VkSubmitInfo SubmitInfo       = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+		SubmitInfo.commandBufferCount = 1;
+		SubmitInfo.pCommandBuffers    = &m_FrameCommandBuffer;
+
+		if (!VK_CHECK(vkQueueSubmit(m_Queue, 1, &SubmitInfo, m_FrameFence)))
+		{
+			return;
+		}
+
+		m_FrameSubmitted                 = true;
+		m_ReadbackReady[m_ReadbackIndex] = Readback.Buffer != VK_NULL_HANDLE;
+
+		PresentRenderTarget();
+
+		m_ReadbackIndex = (m_ReadbackIndex + 1) % k_ReadbackCount;
+	}
+
+	void render_backend::SetViewport(i32 X, i32 Y, i32 Width, i32 Height)
+	{
+		if (Width <= 0 || Height <= 0)
+		{
+			return;
+		}
+
+		if ((u32)(X + Width) != m_TargetWidth || (u32)(Y + Height) != m_TargetHeight)
+		{
+			if (!RecreateRenderTarget((u32)(X + Width), (u32)(Y + Height)))
+			{
+				DestroyRenderTarget();
+			}
+		}
+
+		// Negative height flips the Y axis, so that both backends share the same projection
+		m_Viewport = {(f32)X, (f32)(Y + Height), (f32)Width, -(f32)Height, 0.0f, 1.0f};
+	}
+
+	void render_backend::Clear(const vec4& Color)
+	{
+		// The clear is done when the render pass begins
+		m_ClearColor = {{Color.x, Color.y, Color.z, Color.w}};
+	}
+
+	void render_backend::SetBlending(bool Enabled) { m_Blending = Enabled; }
+	void render_backend::BindFramebuffer(framebuffer_handle Framebuffer)
+	{
+		// Only the default target exists, @see CreateFramebuffer()
+		GLN_ASSERT(!Framebuffer.IsValid());
+		GLN_UNUSED(Framebuffer);
+	}
+
+	void render_backend::BindVertexArray(vertex_array_handle VertexArray) { m_CurrentVertexArray = VertexArray; }
+
+	void render_backend::BindStorageBuffer(u32 Binding, buffer_handle Buffer)
+	{
+		GLN_ASSERT(Binding >= k_FirstStorageBinding && Binding < k_FirstStorageBinding + k_MaxStorageBindings);
+		m_CurrentStorageBuffers[Binding - k_FirstStorageBinding] = Buffer;
+	}
+
+	void render_backend::BindTexture(u32 Unit, texture_handle Texture)
+	{
+		GLN_ASSERT(Unit < k_MaxTextureUnits);
+		m_CurrentTextures[Unit] = Texture;
+	}
+
+	bool render_backend::RecordPacket(draw_packet* Packet)
+	{
+		auto ProgramIt = m_Programs.find(m_CurrentProgram.Idx);
+		if (ProgramIt == m_Programs.end())
+		{
+			return false;
+		}
+
+		// Uniforms are snapshotted in the ring buffer, the program can be modified by the next draw
+		const auto& UniformData = ProgramIt->second.UniformData;
+		const u32   Alignment   = (u32)m_DeviceProperties.limits.minUniformBufferOffsetAlignment;
+		const u32   Offset      = (m_UniformRingOffset + Alignment - 1) & ~(Alignment - 1);
+		const u32   Size        = eastl::max(16u, (u32)UniformData.size());
+
+		// Dispatches take descriptor sets from the same pool
+		if (Offset + Size > k_UniformRingSize || m_Packets.size() + m_Dispatches.size() >= k_MaxDrawsPerFrame)
+		{
+			LOG_F(ERROR, "Too many draw calls in a single frame");
+			return false;
+		}
+
+		memcpy(m_UniformRing.Data + Offset, UniformData.data(), UniformData.size());
+		m_UniformRingOffset = Offset + Size;
+
+		*Packet               = {};
+		Packet->Program       = m_CurrentProgram;
+		Packet->Pipeline      = VK_NULL_HANDLE;
+		Packet->DescriptorSet = VK_NULL_HANDLE;
+		Packet->UniformOffset = Offset;
+		Packet->UniformSize   = Size;
+
+		memcpy(Packet->StorageBuffers, m_CurrentStorageBuffers, sizeof(m_CurrentStorageBuffers));
+		memcpy(Packet->Textures, m_CurrentTextures, sizeof(m_CurrentTextures));
+
+		return true;
+	}
+
+	void render_backend::DrawElementsInstanced(u32 IndexCount, u32 InstanceCount, data_type IndexType)
+	{
+		draw_packet Packet;
+
+		if (InstanceCount == 0 || !RecordPacket(&Packet))
+		{
+			return;
+		}
+
+		Packet.VertexArray   = m_CurrentVertexArray;
+		Packet.IndexCount    = IndexCount;
+		Packet.InstanceCount = InstanceCount;
+		Packet.IndexType     = IndexType == DataType_UnsignedInt ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16;
+		Packet.Blending      = m_Blending;
+
+		m_Packets.push_back(Packet);
+	}
+
+	void render_backend::DispatchCompute(u32 GroupCountX, u32 GroupCountY, u32 GroupCountZ)
+	{
+		draw_packet Dispatch;
+
+		if (GroupCountX * GroupCountY * GroupCountZ == 0 || !RecordPacket(&Dispatch))
+		{
+			return;
+		}
+
+		Dispatch.GroupCounts[0] = GroupCountX;
+		Dispatch.GroupCounts[1] = GroupCountY;
+		Dispatch.GroupCounts[2] = GroupCountZ;
+
+		m_Dispatches.push_back(Dispatch);
+	}
+
+	// Parallel recording section
+	bool render_backend::StartRecordingThreads()
+	{
+		const u32 ThreadCount = (u32)Clamp((f32)std::thread::hardware_concurrency(), 1.0f, 4.0f);
+
+		// Resized once, threads keep pointers to their recorder
+		m_Recorders.resize(ThreadCount);
+
+		for (u32 Index = 0; Index < ThreadCount; ++Index)
+		{
+			recording_thread& Recorder = m_Recorders[Index];
+
+			VkCommandPoolCreateInfo PoolInfo = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+			PoolInfo.flags                   = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+			PoolInfo.queueFamilyIndex        = m_QueueFamily;
+			if (!VK_CHECK(vkCreateCommandPool(m_Device, &PoolInfo, nullptr, &Recorder.CommandPool)))
+			{
+				return false;
+			}
+
+			VkCommandBufferAllocateInfo AllocateInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+			AllocateInfo.commandPool                 = Recorder.CommandPool;
+			AllocateInfo.level                       = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+			AllocateInfo.commandBufferCount          = 1;
+
+			if (!VK_CHECK(vkAllocateCommandBuffers(m_Device, &AllocateInfo, &Recorder.CommandBuffer)))
+			{
+				return false;
+			}
+		}
+
+		for (u32 Index = 0; Index < ThreadCount; ++Index)
+		{
+			recording_thread* Recorder = &m_Recorders[Index];
+
+			Recorder->Thread = std::thread([this, Recorder]() {
+				u64 Generation = 0;
+
+				for (;;)
+				{
+					{
+						std::unique_lock<std::mutex> Lock(m_RecordingMutex);
+						m_RecordingStart.wait(Lock, [this, Generation]() {
+							return m_StopRecording || m_RecordingGeneration != Generation;
+						});
+
+						if (m_StopRecording)
+						{
+							return;
+						}
+
+						Generation = m_RecordingGeneration;
+					}
+
+					RecordPackets(Recorder);
+
+					{
+						std::lock_guard<std::mutex> Lock(m_RecordingMutex);
+						if (--m_PendingRecorders == 0)
+						{
+							m_RecordingDone.notify_one();
+						}
+					}
+				}
+			});
+		}
+
+		return true;
+	}
+
+	void render_backend::StopRecordingThreads()
+	{
+		{
+			std::lock_guard<std::mutex> Lock(m_RecordingMutex);
+			m_StopRecording = true;
+		}
+		m_RecordingStart.notify_all();
+
+		for (auto& Recorder : m_Recorders)
+		{
+			if (Recorder.Thread.joinable())
+			{
+				Recorder.Thread.join();
+			}
+
+			vkDestroyCommandPool(m_Device, Recorder.CommandPool, nullptr);
+		}
+
+		m_Recorders.clear();
+	}
+
+	void render_backend::RecordPackets(recording_thread* Recorder)
+	{
+		if (Recorder->PacketCount == 0)
+		{
+			return;
+		}
+
+		vkResetCommandPool(m_Device, Recorder->CommandPool, 0);
+
+		VkCommandBufferInheritanceInfo InheritanceInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+		InheritanceInfo.renderPass                     = m_RenderPass;
+		InheritanceInfo.subpass                        = 0;
+		InheritanceInfo.framebuffer                    = m_Framebuffer;
+
+		VkCommandBufferBeginInfo BeginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+		BeginInfo.flags                    = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+		BeginInfo.pInheritanceInfo         = &InheritanceInfo;
+
+		VkCommandBuffer CommandBuffer = Recorder->CommandBuffer;
+		VK_CHECK(vkBeginCommandBuffer(CommandBuffer, &BeginInfo));
+
+		const VkRect2D Scissor = {{0, 0}, {m_TargetWidth, m_TargetHeight}};
+		vkCmdSetViewport(CommandBuffer, 0, 1, &m_Viewport);
+		vkCmdSetScissor(CommandBuffer, 0, 1, &Scissor);
+
+		VkPipeline CurrentPipeline = VK_NULL_HANDLE;
+
+		for (u32 Index = Recorder->FirstPacket; Index < Recorder->FirstPacket + Recorder->PacketCount; ++Index)
+		{
+			const draw_packet& Packet = m_Packets[Index];
+
+			if (Packet.Pipeline == VK_NULL_HANDLE)
+			{
+				continue;
+			}
+
+			if (Packet.Pipeline != CurrentPipeline)
+			{
+				vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Packet.Pipeline);
+				CurrentPipeline = Packet.Pipeline;
+			}
+
+			vkCmdBindDescriptorSets(CommandBuffer,
+			                        VK_PIPELINE_BIND_POINT_GRAPHICS,
+			                        m_PipelineLayout,
+			                        0,
+			                        1,
+			                        &Packet.DescriptorSet,
+			                        1,
+			                        &Packet.UniformOffset);
+
+			const auto VertexArrayIt = m_VertexArrays.find(Packet.VertexArray.Idx);
+			if (VertexArrayIt == m_VertexArrays.end())
+			{
+				continue;
+			}
+
+			for (u32 Binding = 0; Binding < (u32)VertexArrayIt->second.Bindings.size(); ++Binding)
+			{
+				const VkBuffer     VertexBuffer = m_Buffers.find(VertexArrayIt->second.Bindings[Binding].Buffer.Idx)->second.Buffer;
+				const VkDeviceSize Offset       = 0;
+				vkCmdBindVertexBuffers(CommandBuffer, Binding, 1, &VertexBuffer, &Offset);
+			}
+
+			const VkBuffer IndexBuffer = m_Buffers.find(VertexArrayIt->second.IndexBuffer.Idx)->second.Buffer;
+			vkCmdBindIndexBuffer(CommandBuffer, IndexBuffer, 0, Packet.IndexType);
+
+			vkCmdDrawIndexed(CommandBuffer, Packet.IndexCount, Packet.InstanceCount, 0, 0, 0);
+		}
+
+		VK_CHECK(vkEndCommandBuffer(CommandBuffer));
+	}
+}
+}
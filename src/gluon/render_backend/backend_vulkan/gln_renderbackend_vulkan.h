@@ -0,0 +1,331 @@
+#pragma once
+
+#include <gluon/render_backend/gln_renderbackend_p.h>
+
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+#include <EASTL/string_hash_map.h>
+
+#include <vulkan/vulkan.h>
+#include <shaderc/shaderc.h>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/// The Vulkan backend renders into an offscreen color target, which is read back at the end of the frame and blitted into
+/// the default framebuffer of the GL context owned by the window, as there is no Vulkan surface yet. Readbacks are double buffered,
+/// a frame is presented once the next one has been submitted.
+/// Draw calls are recorded as packets during the frame, and replayed into secondary command buffers by several threads in EndFrame().
+namespace gluon
+{
+namespace vk
+{
+	static constexpr u32 k_MaxStorageBindings = 3;
+	static constexpr u32 k_MaxTextureUnits    = 16;
+	static constexpr u32 k_ReadbackCount      = 2;
+
+	// Descriptor set layout shared by every program
+	static constexpr u32 k_UniformBinding      = 0;
+	static constexpr u32 k_FirstStorageBinding = 1;
+	static constexpr u32 k_TextureBinding      = k_FirstStorageBinding + k_MaxStorageBindings;
+
+	struct shader_info
+	{
+		VkShaderModule     Module = VK_NULL_HANDLE;
+		shader_type        Type;
+		eastl::vector<u32> Code;
+	};
+
+	struct uniform_info
+	{
+		u32 Offset;
+		u32 Size;
+		u32 MatrixStride;
+	};
+
+	struct program_info
+	{
+		VkShaderModule VertexModule    = VK_NULL_HANDLE;
+		VkShaderModule FragmentModule  = VK_NULL_HANDLE;
+		VkShaderModule ComputeModule   = VK_NULL_HANDLE;
+		VkPipeline     ComputePipeline = VK_NULL_HANDLE;
+
+		eastl::string_hash_map<uniform_info> Uniforms;
+		eastl::vector<u8>                    UniformData;
+	};
+
+	struct buffer_info
+	{
+		VkBuffer       Buffer    = VK_NULL_HANDLE;
+		VkDeviceMemory Memory    = VK_NULL_HANDLE;
+		u8*            Data      = nullptr;
+		i64            Size      = 0;
+		bool           Immutable = false;
+	};
+
+	struct vertex_binding
+	{
+		buffer_handle Buffer;
+		u32           Stride;
+	};
+
+	struct vertex_array_info
+	{
+		buffer_handle                                    IndexBuffer;
+		eastl::vector<vertex_binding>                    Bindings;
+		eastl::vector<VkVertexInputAttributeDescription> Attributes;
+	};
+
+	struct texture_info
+	{
+		VkImage        Image   = VK_NULL_HANDLE;
+		VkDeviceMemory Memory  = VK_NULL_HANDLE;
+		VkImageView    View    = VK_NULL_HANDLE;
+		VkSampler      Sampler = VK_NULL_HANDLE;
+		VkFormat       Format;
+
+		u32       Width, Height;
+		u32       LayerCount = 1;
+		u32       ComponentCount;
+		data_type DataType;
+		u32       Levels;
+		bool      IsArray = false;
+
+		wrap_mode  WrapS, WrapT;
+		min_filter MinFilter;
+		mag_filter MagFilter;
+
+		// Images start undefined, partial updates have to preserve the content once it has been written
+		bool Uploaded = false;
+	};
+
+	struct draw_packet
+	{
+		program_handle      Program;
+		vertex_array_handle VertexArray;
+		VkPipeline          Pipeline;
+		VkDescriptorSet     DescriptorSet;
+		u32                 UniformOffset;
+		u32                 UniformSize;
+
+		buffer_handle  StorageBuffers[k_MaxStorageBindings];
+		texture_handle Textures[k_MaxTextureUnits];
+
+		u32         IndexCount;
+		u32         InstanceCount;
+		VkIndexType IndexType;
+		bool        Blending;
+
+		u32 GroupCounts[3]; // Dispatches only, @see DispatchCompute()
+	};
+
+	//! Each recording thread owns its command pool, as command pools cannot be used concurrently
+	struct recording_thread
+	{
+		std::thread     Thread;
+		VkCommandPool   CommandPool   = VK_NULL_HANDLE;
+		VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+
+		u32 FirstPacket = 0;
+		u32 PacketCount = 0;
+	};
+
+	struct render_backend final : public render_backend_interface
+	{
+		render_backend();
+		virtual ~render_backend();
+
+		// Misc section
+		bool Initialize() override final;
+
+		void EnableDebugging() override final;
+		void DisableDebugging() override final;
+
+		// Shader section
+		shader_handle CreateShaderFromSource(const char* ShaderSource, shader_type ShaderType, const char* ShaderName) override final;
+		shader_handle CreateShaderFromFile(const char* ShaderName, shader_type ShaderType) override final;
+		void          DestroyShader(shader_handle Shader) override final;
+
+		program_handle CreateProgram(shader_handle VertexShader, shader_handle FragmentShader, bool DeleteShaders) override final;
+		program_handle CreateComputeProgram(shader_handle ComputeShader, bool DeleteShaders) override final;
+		program_handle CreateProgramFromSources(const char* VertexSource,
+		                                        const char* FragmentSource,
+		                                        const char* ProgramName) override final;
+		program_handle CreateComputeProgramFromSource(const char* ComputeSource, const char* ProgramName) override final;
+		bool           IsProgramReady(program_handle Program) override final;
+		void           SetProgram(program_handle Program) override final;
+		void           DestroyProgram(program_handle Program) override final;
+
+		void SetUniform(const char* UniformName, i32 Value) override final;
+		void SetUniform(const char* UniformName, u32 Value) override final;
+		void SetUniform(const char* UniformName, f32 Value) override final;
+		void SetUniform(const char* UniformName, const vec2& Value) override final;
+		void SetUniform(const char* UniformName, const vec3& Value) override final;
+		void SetUniform(const char* UniformName, const vec4& Value) override final;
+		void SetUniform(const char* UniformName, const mat2& Value) override final;
+		void SetUniform(const char* UniformName, const mat3& Value) override final;
+		void SetUniform(const char* UniformName, const mat4& Value) override final;
+
+		void SetUniform(const char* UniformName, const i32* Values, u32 Count) override final;
+
+		// VAO section
+		vertex_array_handle CreateVertexArray(buffer_handle IndexBuffer) override final;
+		void                AttachVertexBuffer(vertex_array_handle  VertexArray,
+		                                       buffer_handle        VertexBuffer,
+		                                       const vertex_layout& VertexLayout) override final;
+		void                DestroyVertexArray(vertex_array_handle VertexArray) override final;
+
+		// Buffers section
+		buffer_handle CreateBuffer(i64 Size, const void* Data) override final;
+		buffer_handle CreateImmutableBuffer(i64 Size, const void* Data) override final;
+		void          ResizeBuffer(buffer_handle Handle, i64 NewSize, const void* Data) override final;
+		void          ResizeImmutableBuffer(buffer_handle* Handle, i64 NewSize, const void* Data) override final;
+		void          UpdateBufferData(buffer_handle Handle, const void* Data, i64 Offset, i64 Length) override final;
+		void          DestroyBuffer(buffer_handle Buffer) override final;
+
+		void* MapBuffer(buffer_handle Handle, i64 Offset, i64 Length) override final;
+		void  UnmapBuffer(buffer_handle Handle) override final;
+
+		// Texture section
+		texture_handle CreateTexture(u32 Width, u32 Height, u32 ComponentCount, data_type DataType, bool WithMipmaps, void* Data)
+		    override final;
+		texture_handle CreateTextureArray(u32 Width, u32 Height, u32 LayerCount, u32 ComponentCount, data_type DataType) override final;
+		void SetTextureData(texture_handle Texture, void* Data) override final;
+		void SetTextureSubData(texture_handle Texture, u32 X, u32 Y, u32 Width, u32 Height, const void* Data) override final;
+		void SetTextureLayerSubData(texture_handle Texture, u32 Layer, u32 X, u32 Y, u32 Width, u32 Height, const void* Data)
+		    override final;
+		void SetTextureWrapping(texture_handle Texture, wrap_mode WrapS, wrap_mode WrapT) override final;
+		void SetTextureFiltering(texture_handle Texture, min_filter MinFilter, mag_filter MagFilter) override final;
+		void DestroyTexture(texture_handle Texture) override final;
+
+		framebuffer_handle CreateFramebuffer(texture_handle TextureArray, u32 Layer) override final;
+		void               DestroyFramebuffer(framebuffer_handle Framebuffer) override final;
+
+		// Draw section
+		void BeginFrame() override final;
+		void EndFrame() override final;
+
+		void SetViewport(i32 X, i32 Y, i32 Width, i32 Height) override final;
+		void Clear(const vec4& Color) override final;
+		void SetBlending(bool Enabled) override final;
+		void BindFramebuffer(framebuffer_handle Framebuffer) override final;
+
+		void BindVertexArray(vertex_array_handle VertexArray) override final;
+		void BindStorageBuffer(u32 Binding, buffer_handle Buffer) override final;
+		void BindTexture(u32 Unit, texture_handle Texture) override final;
+		void DrawElementsInstanced(u32 IndexCount, u32 InstanceCount, data_type IndexType) override final;
+		void DispatchCompute(u32 GroupCountX, u32 GroupCountY, u32 GroupCountZ) override final;
+
+	private:
+		u32  FindMemoryType(u32 TypeBits, VkMemoryPropertyFlags Properties) const;
+		bool AllocateBuffer(buffer_info* Info, i64 Size, const void* Data);
+		void ReleaseBuffer(const buffer_info& Info);
+		void WriteUniform(const char* UniformName, const void* Value, u32 Size, u32 ColumnCount = 1);
+		bool CreateImage(texture_info* Info);
+		bool RecreateSampler(texture_info* Info);
+		bool RecreateRenderTarget(u32 Width, u32 Height);
+		void DestroyRenderTarget();
+		void PresentRenderTarget();
+
+		//! Waits for the frame in flight, before the host touches what it reads
+		void WaitForFrame();
+
+		VkCommandBuffer BeginImmediateCommands();
+		void            EndImmediateCommands(VkCommandBuffer CommandBuffer);
+
+		VkPipeline GetGraphicsPipeline(program_handle Program, vertex_array_handle VertexArray, bool Blending);
+
+		//! Snapshots the current program, uniforms and bindings, returns false when the frame is full
+		bool RecordPacket(draw_packet* Packet);
+		bool WriteDescriptorSet(draw_packet* Packet);
+
+		bool StartRecordingThreads();
+		void StopRecordingThreads();
+		void RecordPackets(recording_thread* Recorder);
+
+		template <typename info_t>
+		using handle_map = eastl::unordered_map<u32, info_t>;
+
+		VkInstance               m_Instance       = VK_NULL_HANDLE;
+		VkDebugUtilsMessengerEXT m_DebugMessenger = VK_NULL_HANDLE;
+		VkPhysicalDevice         m_PhysicalDevice = VK_NULL_HANDLE;
+		VkDevice                 m_Device         = VK_NULL_HANDLE;
+		VkQueue                  m_Queue          = VK_NULL_HANDLE;
+		u32                      m_QueueFamily    = 0;
+
+		VkPhysicalDeviceProperties       m_DeviceProperties;
+		VkPhysicalDeviceMemoryProperties m_MemoryProperties;
+
+		VkDescriptorSetLayout m_DescriptorSetLayout = VK_NULL_HANDLE;
+		VkPipelineLayout      m_PipelineLayout      = VK_NULL_HANDLE;
+		VkDescriptorPool      m_DescriptorPool      = VK_NULL_HANDLE;
+		VkRenderPass          m_RenderPass          = VK_NULL_HANDLE;
+		VkCommandPool         m_CommandPool         = VK_NULL_HANDLE;
+		VkCommandBuffer       m_FrameCommandBuffer  = VK_NULL_HANDLE;
+		VkFence               m_FrameFence          = VK_NULL_HANDLE;
+
+		bool m_HasDebugUtils        = false;
+		bool m_HasMirrorClampToEdge = false;
+
+		shaderc_compiler_t m_ShaderCompiler = nullptr;
+
+		// Offscreen render target
+		VkImage        m_ColorImage   = VK_NULL_HANDLE;
+		VkDeviceMemory m_ColorMemory  = VK_NULL_HANDLE;
+		VkImageView    m_ColorView    = VK_NULL_HANDLE;
+		VkFramebuffer  m_Framebuffer  = VK_NULL_HANDLE;
+		u32            m_TargetWidth  = 0;
+		u32            m_TargetHeight = 0;
+
+		// Presentation through the window GL context, the target is copied into a readback buffer then uploaded to m_PresentTexture.
+		// Frames alternate between the buffers, so that presenting one does not wait for the frame copied into the other.
+		buffer_info m_Readbacks[k_ReadbackCount];
+		bool        m_ReadbackReady[k_ReadbackCount] = {};
+		u32         m_ReadbackIndex                  = 0;
+		u32         m_PresentTexture                 = 0;
+		u32         m_PresentFramebuffer             = 0;
+
+		// Per frame uniform ring, host visible and persistently mapped
+		buffer_info m_UniformRing;
+		u32         m_UniformRingOffset = 0;
+
+		u32 m_NextHandle = 0;
+
+		handle_map<shader_info>       m_Shaders;
+		handle_map<program_info>      m_Programs;
+		handle_map<buffer_info>       m_Buffers;
+		handle_map<vertex_array_info> m_VertexArrays;
+		handle_map<texture_info>      m_Textures;
+
+		eastl::unordered_map<u64, VkPipeline> m_GraphicsPipelines;
+
+		// Resources released while a frame may still be in flight
+		eastl::vector<buffer_info> m_PendingBufferReleases;
+
+		// Current state
+		program_handle      m_CurrentProgram     = GLUON_INVALID_HANDLE;
+		vertex_array_handle m_CurrentVertexArray = GLUON_INVALID_HANDLE;
+		buffer_handle       m_CurrentStorageBuffers[k_MaxStorageBindings];
+		texture_handle      m_CurrentTextures[k_MaxTextureUnits];
+		bool                m_Blending = false;
+		VkClearColorValue   m_ClearColor;
+		VkViewport          m_Viewport;
+		bool                m_FrameSubmitted = false;
+
+		eastl::vector<draw_packet> m_Packets;
+
+		// Recorded in the frame command buffer before the render pass, so that draws can read what they wrote
+		eastl::vector<draw_packet> m_Dispatches;
+
+		// Parallel recording
+		eastl::vector<recording_thread> m_Recorders;
+		std::mutex                      m_RecordingMutex;
+		std::condition_variable         m_RecordingStart;
+		std::condition_variable         m_RecordingDone;
+		u64                             m_RecordingGeneration = 0;
+		u32                             m_PendingRecorders    = 0;
+		bool                            m_StopRecording       = false;
+	};
+}
+}
@@ -0,0 +1,169 @@
+#include <gluon/render_backend/gln_program_cache_p.h>
+
+#include <EASTL/algorithm.h>
+#include <EASTL/string.h>
+
+#include <loguru.hpp>
+
+#include <filesystem>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace gluon
+{
+namespace fs = std::filesystem;
+
+static constexpr u32 k_ProgramCacheMagic   = 0x42505047; // "GPPB"
+static constexpr u32 k_ProgramCacheVersion = 2;
+
+struct program_cache_header
+{
+	u32 Magic;
+	u32 Version;
+	u64 SourceHash;
+	u64 DriverHash;
+	u32 Format;
+	u32 Size;
+};
+
+static eastl::string       s_CacheDirectory; // Empty until first used or set, @see GetCacheDirectory()
+static program_cache_stats s_Stats = {};
+
+//! The per user cache directory of the platform, or the temporary directory when it cannot be found
+static eastl::string GetDefaultCacheDirectory()
+{
+#if GLN_PLATFORM_WINDOWS
+	const char* LocalAppData = getenv("LOCALAPPDATA");
+	if (LocalAppData != nullptr && LocalAppData[0] != '\0')
+	{
+		return eastl::string(LocalAppData) + "/gluon/shader_cache";
+	}
+#else
+	const char* CacheHome = getenv("XDG_CACHE_HOME");
+	if (CacheHome != nullptr && CacheHome[0] == '/')
+	{
+		return eastl::string(CacheHome) + "/gluon/shader_cache";
+	}
+
+	const char* Home = getenv("HOME");
+	if (Home != nullptr && Home[0] != '\0')
+	{
+		return eastl::string(Home) + "/.cache/gluon/shader_cache";
+	}
+#endif
+
+	std::error_code Error;
+	const fs::path  TempDirectory = fs::temp_directory_path(Error);
+
+	return Error ? eastl::string("gluon_shader_cache") : eastl::string((TempDirectory / "gluon_shader_cache").string().c_str());
+}
+
+static const eastl::string& GetCacheDirectory()
+{
+	if (s_CacheDirectory.empty())
+	{
+		s_CacheDirectory = GetDefaultCacheDirectory();
+	}
+
+	return s_CacheDirectory;
+}
+
+static eastl::string GetCacheFileName(u64 SourceHash)
+{
+	char FileName[32];
+	snprintf(FileName, sizeof(FileName), "/%016llx.bin", (unsigned long long)SourceHash);
+
+	return GetCacheDirectory() + FileName;
+}
+
+void SetProgramCacheDirectory(const char* Directory) { s_CacheDirectory = Directory; }
+
+program_cache_stats GetProgramCacheStats() { return s_Stats; }
+
+bool LoadProgramBinary(u64 SourceHash, u64 DriverHash, const eastl::vector<u32>& Formats, program_binary* Binary)
+{
+	FILE* File = fopen(GetCacheFileName(SourceHash).c_str(), "rb");
+	if (!File)
+	{
+		return false;
+	}
+
+	fseek(File, 0, SEEK_END);
+	const i64 FileSize = (i64)ftell(File);
+	fseek(File, 0, SEEK_SET);
+
+	program_cache_header Header;
+
+	bool Valid = fread(&Header, sizeof(Header), 1, File) == 1;
+	Valid      = Valid && Header.Magic == k_ProgramCacheMagic && Header.Version == k_ProgramCacheVersion;
+	Valid      = Valid && Header.SourceHash == SourceHash && Header.DriverHash == DriverHash;
+
+	// The driver is not relied on to reject a foreign binary
+	Valid = Valid && eastl::find(Formats.begin(), Formats.end(), Header.Format) != Formats.end();
+
+	// A truncated or corrupted entry must not make us allocate an arbitrary size
+	Valid = Valid && (i64)Header.Size <= FileSize - (i64)sizeof(Header);
+
+	if (Valid)
+	{
+		Binary->Format = Header.Format;
+		Binary->Data.resize(Header.Size);
+
+		Valid = fread(Binary->Data.data(), 1, Header.Size, File) == Header.Size;
+	}
+
+	fclose(File);
+
+	return Valid;
+}
+
+void StoreProgramBinary(u64 SourceHash, u64 DriverHash, const program_binary& Binary)
+{
+	std::error_code Error;
+	fs::create_directories(fs::path(GetCacheDirectory().c_str()), Error);
+
+	// Entries are written aside then renamed, so that a crash or a full disk never leaves a partial entry under the final name
+	const eastl::string FileName     = GetCacheFileName(SourceHash);
+	const eastl::string TempFileName = FileName + ".tmp";
+
+	FILE* File = fopen(TempFileName.c_str(), "wb");
+	if (!File)
+	{
+		LOG_F(WARNING, "Cannot write program cache entry %s", TempFileName.c_str());
+		return;
+	}
+
+	program_cache_header Header;
+	Header.Magic      = k_ProgramCacheMagic;
+	Header.Version    = k_ProgramCacheVersion;
+	Header.SourceHash = SourceHash;
+	Header.DriverHash = DriverHash;
+	Header.Format     = Binary.Format;
+	Header.Size       = (u32)Binary.Data.size();
+
+	bool Written = fwrite(&Header, sizeof(Header), 1, File) == 1;
+	Written      = Written && fwrite(Binary.Data.data(), 1, Binary.Data.size(), File) == Binary.Data.size();
+	Written      = (fclose(File) == 0) && Written;
+
+	if (Written)
+	{
+		fs::rename(fs::path(TempFileName.c_str()), fs::path(FileName.c_str()), Error);
+		Written = !Error;
+	}
+
+	if (!Written)
+	{
+		LOG_F(WARNING, "Cannot write program cache entry %s", FileName.c_str());
+		fs::remove(fs::path(TempFileName.c_str()), Error);
+	}
+}
+
+void RecordProgramCacheHit(f64 LoadTime)
+{
+	++s_Stats.Hits;
+	s_Stats.LoadTime += LoadTime;
+}
+
+void RecordProgramCacheMiss() { ++s_Stats.Misses; }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <gluon/render_backend/gln_renderbackend.h>
+
+#include <EASTL/vector.h>
+
+/// This is a private header, it should not be included outside of the gluon renderbackend files.
+/// Program binaries are stored one per file, named after the hash of their sources. The driver hash and the binary format are kept
+/// in the file header, any mismatch or a format the driver does not list is reported as a miss so that the program is compiled and
+/// the entry overwritten.
+namespace gluon
+{
+struct program_binary
+{
+	u32               Format = 0;
+	eastl::vector<u8> Data;
+};
+
+//! Formats lists the binary formats the driver accepts, entries in another format are not loaded
+bool LoadProgramBinary(u64 SourceHash, u64 DriverHash, const eastl::vector<u32>& Formats, program_binary* Binary);
+void StoreProgramBinary(u64 SourceHash, u64 DriverHash, const program_binary& Binary);
+
+void RecordProgramCacheHit(f64 LoadTime);
+void RecordProgramCacheMiss();
+}
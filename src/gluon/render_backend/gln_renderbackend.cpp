@@ -3,68 +3,129 @@
 #include <gluon/render_backend/gln_renderbackend_p.h>
 #include <gluon/render_backend/backend_opengl/gln_renderbackend_opengl.h>
 
+#ifdef GLUON_RENDERBACKEND_VULKAN
+#	include <gluon/render_backend/backend_vulkan/gln_renderbackend_vulkan.h>
+#endif
+
+#include <loguru.hpp>
+
 #include <EASTL/vector.h>
 
+#include <stdio.h>
+
 namespace gluon
 {
 
-struct vertex_layout_impl
+bool ReadTextFile(const char* FileName, eastl::vector<char>* Content)
 {
-	eastl::vector<data_type> DataTypes;
-	eastl::vector<int>       ElemCounts;
-
-	uint32_t GetOffset(uint32_t Index) const
+	FILE* File = fopen(FileName, "r");
+	if (!File)
 	{
-		uint32_t Offset = 0;
+		LOG_F(ERROR, "Cannot open file %s", FileName);
+		return false;
+	}
 
-		for (uint32_t i = 0; i < Index; ++i)
-		{
-			Offset += ElemCounts[i] * GetDataTypeSize(DataTypes[i]);
-		}
+	fseek(File, 0, SEEK_END);
+	size_t Size = ftell(File);
+	fseek(File, 0, SEEK_SET);
 
-		return Offset;
-	}
+	Content->resize(Size + 1);
 
-	uint32_t GetTotalSize() const { return GetOffset((uint32_t)DataTypes.size()); }
-};
+	Size             = fread(Content->data(), sizeof(char), Size, File);
+	(*Content)[Size] = '\0';
+	Content->resize(Size + 1);
 
-vertex_layout::vertex_layout() { m_Impl = new vertex_layout_impl; }
+	fclose(File);
 
-vertex_layout::~vertex_layout()
-{
-	delete m_Impl;
-	m_Impl = nullptr;
+	return true;
 }
 
-vertex_layout& vertex_layout::Begin() { return *this; }
-
-vertex_layout& vertex_layout::Add(data_type DataType, int ElementCount)
+// The backend can be fixed at build time (see GLUON_RENDERBACKEND_DISPATCH). As every backend is final, calls through a concrete
+// backend pointer are direct and can be inlined with LTO. The dynamic mode keeps runtime selection through the virtual interface.
+#if defined(GLUON_RENDERBACKEND_STATIC_VULKAN)
+using backend_type                                       = vk::render_backend;
+static constexpr render_backend_type k_StaticBackendType = RenderBackend_Vulkan;
+#elif defined(GLUON_RENDERBACKEND_STATIC_OPENGL)
+using backend_type                                       = gl::render_backend;
+static constexpr render_backend_type k_StaticBackendType = RenderBackend_OpenGL;
+#else
+using backend_type = render_backend_interface;
+#endif
+
+static backend_type*       s_Backend     = nullptr;
+static render_backend_type s_BackendType = RenderBackend_OpenGL;
+
+#if defined(GLUON_RENDERBACKEND_STATIC_VULKAN) || defined(GLUON_RENDERBACKEND_STATIC_OPENGL)
+void InitializeBackend(render_backend_type BackendType)
 {
-	m_Impl->DataTypes.push_back(DataType);
-	m_Impl->ElemCounts.push_back(ElementCount);
-	return *this;
-}
+	if (BackendType != k_StaticBackendType)
+	{
+		LOG_F(WARNING, "Render backend %d requested, but backend %d has been selected at build time", BackendType, k_StaticBackendType);
+	}
+
+	s_BackendType = k_StaticBackendType;
+	s_Backend     = new backend_type();
 
-void vertex_layout::End()
-{ /* no-op for now */
+	if (!s_Backend->Initialize())
+	{
+		LOG_F(FATAL, "Cannot initialize render backend %d", k_StaticBackendType);
+	}
 }
+#else
+void InitializeBackend(render_backend_type BackendType)
+{
+	switch (BackendType)
+	{
+#ifdef GLUON_RENDERBACKEND_VULKAN
+		case RenderBackend_Vulkan:
+			s_Backend = new vk::render_backend();
+			break;
+#endif
+
+		default:
+			if (BackendType != RenderBackend_OpenGL)
+			{
+				LOG_F(WARNING, "Render backend %d is not available, falling back to OpenGL", BackendType);
+			}
+
+			BackendType = RenderBackend_OpenGL;
+			s_Backend   = new gl::render_backend();
+			break;
+	}
 
-u32 vertex_layout::GetTotalSize() const { return m_Impl->GetTotalSize(); }
+	s_BackendType = BackendType;
 
-u32 vertex_layout::GetOffset(u32 Index) const { return m_Impl->GetOffset(Index); }
+	if (s_Backend->Initialize())
+	{
+		return;
+	}
 
-u32 vertex_layout::GetEntryCount() const { return (u32)m_Impl->DataTypes.size(); }
+	if (BackendType != RenderBackend_OpenGL)
+	{
+		LOG_F(WARNING, "Render backend %d cannot be initialized, falling back to OpenGL", BackendType);
 
-vertex_layout::entry vertex_layout::GetEntry(u32 Index) const { return {m_Impl->DataTypes[Index], m_Impl->ElemCounts[Index]}; }
+		delete s_Backend;
+		s_BackendType = RenderBackend_OpenGL;
+		s_Backend     = new gl::render_backend();
 
-static render_backend_interface* s_Backend = nullptr;
+		if (s_Backend->Initialize())
+		{
+			return;
+		}
+	}
+
+	LOG_F(FATAL, "Cannot initialize the OpenGL render backend");
+}
+#endif
 
-void InitializeBackend()
+void ShutdownBackend()
 {
-	s_Backend = new gl::render_backend();
-	s_Backend->Initialize();
+	delete s_Backend;
+	s_Backend = nullptr;
 }
 
+render_backend_type GetBackendType() { return s_BackendType; }
+
 void EnableDebugging() { s_Backend->EnableDebugging(); }
 void DisableDebugging() { s_Backend->DisableDebugging(); }
 
@@ -90,8 +151,44 @@ program_handle CreateComputeProgram(shader_handle ComputeShader, bool DeleteShad
 	return s_Backend->CreateComputeProgram(ComputeShader, DeleteShader);
 }
 
+program_handle CreateProgramFromSources(const char* VertexSource, const char* FragmentSource, const char* ProgramName)
+{
+	return s_Backend->CreateProgramFromSources(VertexSource, FragmentSource, ProgramName);
+}
+
+program_handle CreateComputeProgramFromSource(const char* ComputeSource, const char* ProgramName)
+{
+	return s_Backend->CreateComputeProgramFromSource(ComputeSource, ProgramName);
+}
+
+program_handle CreateProgramFromFiles(const char* VertexFileName, const char* FragmentFileName)
+{
+	eastl::vector<char> VertexSource, FragmentSource;
+
+	if (!ReadTextFile(VertexFileName, &VertexSource) || !ReadTextFile(FragmentFileName, &FragmentSource))
+	{
+		return GLUON_INVALID_HANDLE;
+	}
+
+	return s_Backend->CreateProgramFromSources(VertexSource.data(), FragmentSource.data(), VertexFileName);
+}
+
+bool IsProgramReady(program_handle Program) { return s_Backend->IsProgramReady(Program); }
+
+void SetProgram(program_handle Program) { s_Backend->SetProgram(Program); }
 void DestroyProgram(program_handle Program) { s_Backend->DestroyProgram(Program); }
 
+void SetUniform(const char* UniformName, i32 Value) { s_Backend->SetUniform(UniformName, Value); }
+void SetUniform(const char* UniformName, u32 Value) { s_Backend->SetUniform(UniformName, Value); }
+void SetUniform(const char* UniformName, f32 Value) { s_Backend->SetUniform(UniformName, Value); }
+void SetUniform(const char* UniformName, const vec2& Value) { s_Backend->SetUniform(UniformName, Value); }
+void SetUniform(const char* UniformName, const vec3& Value) { s_Backend->SetUniform(UniformName, Value); }
+void SetUniform(const char* UniformName, const vec4& Value) { s_Backend->SetUniform(UniformName, Value); }
+void SetUniform(const char* UniformName, const mat2& Value) { s_Backend->SetUniform(UniformName, Value); }
+void SetUniform(const char* UniformName, const mat3& Value) { s_Backend->SetUniform(UniformName, Value); }
+void SetUniform(const char* UniformName, const mat4& Value) { s_Backend->SetUniform(UniformName, Value); }
+void SetUniform(const char* UniformName, const i32* Values, u32 Count) { s_Backend->SetUniform(UniformName, Values, Count); }
+
 vertex_array_handle CreateVertexArray(buffer_handle IndexBuffer) { return s_Backend->CreateVertexArray(IndexBuffer); }
 void                AttachVertexBuffer(vertex_array_handle VertexArray, buffer_handle VertexBuffer, const vertex_layout& VertexLayout)
 {
@@ -122,7 +219,20 @@ texture_handle CreateTexture(u32 Width, u32 Height, u32 ComponentCount, data_typ
 	return s_Backend->CreateTexture(Width, Height, ComponentCount, DataType, WithMipmaps, Data);
 }
 
+texture_handle CreateTextureArray(u32 Width, u32 Height, u32 LayerCount, u32 ComponentCount, data_type DataType)
+{
+	return s_Backend->CreateTextureArray(Width, Height, LayerCount, ComponentCount, DataType);
+}
+
 void SetTextureData(texture_handle Handle, void* Data) { s_Backend->SetTextureData(Handle, Data); }
+void SetTextureSubData(texture_handle Handle, u32 X, u32 Y, u32 Width, u32 Height, const void* Data)
+{
+	s_Backend->SetTextureSubData(Handle, X, Y, Width, Height, Data);
+}
+void SetTextureLayerSubData(texture_handle Handle, u32 Layer, u32 X, u32 Y, u32 Width, u32 Height, const void* Data)
+{
+	s_Backend->SetTextureLayerSubData(Handle, Layer, X, Y, Width, Height, Data);
+}
 void SetTextureWrapping(texture_handle Handle, wrap_mode WrapS, wrap_mode WrapT) { s_Backend->SetTextureWrapping(Handle, WrapS, WrapT); }
 void SetTextureFiltering(texture_handle Handle, min_filter MinFilter, mag_filter MagFilter)
 {
@@ -130,4 +240,29 @@ void SetTextureFiltering(texture_handle Handle, min_filter MinFilter, mag_filter
 }
 void DestroyTexture(texture_handle Handle) { s_Backend->DestroyTexture(Handle); }
 
+framebuffer_handle CreateFramebuffer(texture_handle TextureArray, u32 Layer) { return s_Backend->CreateFramebuffer(TextureArray, Layer); }
+void               DestroyFramebuffer(framebuffer_handle Handle) { s_Backend->DestroyFramebuffer(Handle); }
+
+void BeginFrame() { s_Backend->BeginFrame(); }
+void EndFrame() { s_Backend->EndFrame(); }
+
+void SetViewport(i32 X, i32 Y, i32 Width, i32 Height) { s_Backend->SetViewport(X, Y, Width, Height); }
+void Clear(const vec4& Color) { s_Backend->Clear(Color); }
+void SetBlending(bool Enabled) { s_Backend->SetBlending(Enabled); }
+void BindFramebuffer(framebuffer_handle Handle) { s_Backend->BindFramebuffer(Handle); }
+
+void BindVertexArray(vertex_array_handle VertexArray) { s_Backend->BindVertexArray(VertexArray); }
+void BindStorageBuffer(u32 Binding, buffer_handle Buffer) { s_Backend->BindStorageBuffer(Binding, Buffer); }
+void BindTexture(u32 Unit, texture_handle Texture) { s_Backend->BindTexture(Unit, Texture); }
+
+void DrawElementsInstanced(u32 IndexCount, u32 InstanceCount, data_type IndexType)
+{
+	s_Backend->DrawElementsInstanced(IndexCount, InstanceCount, IndexType);
+}
+
+void DispatchCompute(u32 GroupCountX, u32 GroupCountY, u32 GroupCountZ)
+{
+	s_Backend->DispatchCompute(GroupCountX, GroupCountY, GroupCountZ);
+}
+
 }
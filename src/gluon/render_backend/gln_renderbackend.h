@@ -4,6 +4,8 @@
 
 #include <EASTL/numeric_limits.h>
 
+#include <assert.h>
+
 #ifdef _WIN32
 #	ifdef GLUON_RENDERBACKEND_MAKELIB
 #		define GLUON_RENDERBACKEND_EXPORT
@@ -48,6 +50,7 @@ GLUON_HANDLE(vertex_array_handle);
 GLUON_HANDLE(buffer_handle);
 
 GLUON_HANDLE(texture_handle);
+GLUON_HANDLE(framebuffer_handle);
 
 enum data_type
 {
@@ -97,8 +100,42 @@ enum mag_filter
 	MagFilter_Count,
 };
 
-struct vertex_layout_impl;
-struct GLUON_RENDERBACKEND_EXPORT vertex_layout
+enum render_backend_type
+{
+	RenderBackend_OpenGL = 0,
+	RenderBackend_Vulkan,
+	RenderBackend_Count,
+};
+
+inline constexpr u32 GetDataTypeSize(data_type DataType)
+{
+	switch (DataType)
+	{
+		case DataType_Byte:
+		case DataType_UnsignedByte:
+			return 1;
+
+		case DataType_Short:
+		case DataType_UnsignedShort:
+			return 2;
+
+		case DataType_Int:
+		case DataType_UnsignedInt:
+		case DataType_Float:
+			return 4;
+
+		default:
+			return 0;
+	}
+
+	return 0;
+}
+
+static constexpr u32 k_MaxVertexAttributes = 16;
+
+//! Fixed capacity vertex layout, offsets and stride are computed when attributes are added.
+//! Layouts known at compile time should be built with MakeVertexLayout<...>(), the Begin/Add/End builder is kept for dynamic cases.
+struct vertex_layout
 {
 	struct entry
 	{
@@ -106,23 +143,86 @@ struct GLUON_RENDERBACKEND_EXPORT vertex_layout
 		i32       ElementCount;
 	};
 
-	vertex_layout();
-	~vertex_layout();
+	constexpr vertex_layout& Begin()
+	{
+		m_EntryCount = 0;
+		m_TotalSize  = 0;
+		return *this;
+	}
 
-	vertex_layout& Begin();
-	vertex_layout& Add(data_type DataType, i32 ElementCount);
-	void           End();
+	constexpr vertex_layout& Add(data_type DataType, i32 ElementCount)
+	{
+		// MakeVertexLayout checks the count at compile time. In a constant expression, the assert makes an overflow a compile error.
+		assert(m_EntryCount < k_MaxVertexAttributes && "Too many vertex attributes");
+		if (m_EntryCount >= k_MaxVertexAttributes)
+		{
+			return *this;
+		}
 
-	u32 GetTotalSize() const;
-	u32 GetOffset(u32 Index) const;
+		m_Entries[m_EntryCount] = {DataType, ElementCount};
+		m_Offsets[m_EntryCount] = m_TotalSize;
 
-	u32   GetEntryCount() const;
-	entry GetEntry(u32 Index) const;
+		m_TotalSize += ElementCount * GetDataTypeSize(DataType);
+		++m_EntryCount;
 
-	vertex_layout_impl* m_Impl;
+		return *this;
+	}
+
+	constexpr void End() {}
+
+	constexpr u32 GetTotalSize() const { return m_TotalSize; }
+	constexpr u32 GetOffset(u32 Index) const { return Index < m_EntryCount ? m_Offsets[Index] : m_TotalSize; }
+
+	constexpr u32   GetEntryCount() const { return m_EntryCount; }
+	constexpr entry GetEntry(u32 Index) const { return m_Entries[Index]; }
+
+	entry m_Entries[k_MaxVertexAttributes] = {};
+	u32   m_Offsets[k_MaxVertexAttributes] = {};
+	u32   m_EntryCount                     = 0;
+	u32   m_TotalSize                      = 0;
 };
 
-GLUON_RENDERBACKEND_EXPORT void InitializeBackend();
+//! Maps a C++ attribute type to its vertex format, specialize it to use custom attribute types with MakeVertexLayout
+template <typename attribute_t>
+struct vertex_attribute;
+
+#define GLUON_VERTEX_ATTRIBUTE(attribute_t, attribute_data_type, element_count)                                                            \
+	template <>                                                                                                                            \
+	struct vertex_attribute<attribute_t>                                                                                                   \
+	{                                                                                                                                      \
+		static constexpr data_type DataType     = attribute_data_type;                                                                     \
+		static constexpr i32       ElementCount = element_count;                                                                           \
+	}
+
+GLUON_VERTEX_ATTRIBUTE(i8, DataType_Byte, 1);
+GLUON_VERTEX_ATTRIBUTE(u8, DataType_UnsignedByte, 1);
+GLUON_VERTEX_ATTRIBUTE(i16, DataType_Short, 1);
+GLUON_VERTEX_ATTRIBUTE(u16, DataType_UnsignedShort, 1);
+GLUON_VERTEX_ATTRIBUTE(i32, DataType_Int, 1);
+GLUON_VERTEX_ATTRIBUTE(u32, DataType_UnsignedInt, 1);
+GLUON_VERTEX_ATTRIBUTE(f32, DataType_Float, 1);
+GLUON_VERTEX_ATTRIBUTE(vec2, DataType_Float, 2);
+GLUON_VERTEX_ATTRIBUTE(vec3, DataType_Float, 3);
+GLUON_VERTEX_ATTRIBUTE(vec4, DataType_Float, 4);
+GLUON_VERTEX_ATTRIBUTE(vec2i, DataType_Int, 2);
+GLUON_VERTEX_ATTRIBUTE(vec3i, DataType_Int, 3);
+GLUON_VERTEX_ATTRIBUTE(vec4i, DataType_Int, 4);
+
+//! Builds a vertex layout from a list of attribute types, e.g. MakeVertexLayout<vec2, vec2>()
+template <typename... attribute_ts>
+constexpr vertex_layout MakeVertexLayout()
+{
+	static_assert(sizeof...(attribute_ts) <= k_MaxVertexAttributes, "Too many vertex attributes");
+
+	vertex_layout Layout;
+	(Layout.Add(vertex_attribute<attribute_ts>::DataType, vertex_attribute<attribute_ts>::ElementCount), ...);
+	return Layout;
+}
+
+//! Falls back to OpenGL if the requested backend has not been compiled in, or if it cannot be initialized
+GLUON_RENDERBACKEND_EXPORT void InitializeBackend(render_backend_type BackendType = RenderBackend_OpenGL);
+GLUON_RENDERBACKEND_EXPORT void ShutdownBackend();
+GLUON_RENDERBACKEND_EXPORT render_backend_type GetBackendType();
 
 GLUON_RENDERBACKEND_EXPORT void EnableDebugging();
 GLUON_RENDERBACKEND_EXPORT void DisableDebugging();
@@ -138,8 +238,45 @@ GLUON_RENDERBACKEND_EXPORT program_handle CreateProgram(shader_handle VertexShad
                                                         bool          DeleteShaders  = false);
 GLUON_RENDERBACKEND_EXPORT program_handle CreateComputeProgram(shader_handle ComputeShader, bool DeleteShader = false);
 
+//! Programs created from sources are stored in the program cache as driver binaries when the backend supports it,
+//! later runs load the binaries instead of compiling, and fall back to compiling when the sources or the driver changed.
+GLUON_RENDERBACKEND_EXPORT program_handle CreateProgramFromSources(const char* VertexSource,
+                                                                   const char* FragmentSource,
+                                                                   const char* ProgramName = nullptr);
+//! Same cache and asynchronous compilation as CreateProgramFromSources(), @see IsProgramReady()
+GLUON_RENDERBACKEND_EXPORT program_handle CreateComputeProgramFromSource(const char* ComputeSource, const char* ProgramName = nullptr);
+GLUON_RENDERBACKEND_EXPORT program_handle CreateProgramFromFiles(const char* VertexFileName, const char* FragmentFileName);
+
+//! Programs created from sources are compiled asynchronously, this polls their status without blocking when the driver supports it.
+//! Returns false while the program is compiling, or if it failed to compile
+GLUON_RENDERBACKEND_EXPORT bool IsProgramReady(program_handle Program);
+
+struct program_cache_stats
+{
+	u32 Hits;
+	u32 Misses;
+	f64 LoadTime; ///< In seconds, spent loading the binaries of the hits. Compiles overlap frames, so their cost is not reported
+};
+
+//! Defaults to gluon/shader_cache in the user cache directory: $XDG_CACHE_HOME or ~/.cache, %LOCALAPPDATA% on Windows
+GLUON_RENDERBACKEND_EXPORT void                SetProgramCacheDirectory(const char* Directory);
+GLUON_RENDERBACKEND_EXPORT program_cache_stats GetProgramCacheStats();
+
+GLUON_RENDERBACKEND_EXPORT void SetProgram(program_handle Program);
 GLUON_RENDERBACKEND_EXPORT void DestroyProgram(program_handle Program);
 
+//! Uniforms are set on the current program, @see SetProgram()
+GLUON_RENDERBACKEND_EXPORT void SetUniform(const char* UniformName, i32 Value);
+GLUON_RENDERBACKEND_EXPORT void SetUniform(const char* UniformName, u32 Value);
+GLUON_RENDERBACKEND_EXPORT void SetUniform(const char* UniformName, f32 Value);
+GLUON_RENDERBACKEND_EXPORT void SetUniform(const char* UniformName, const vec2& Value);
+GLUON_RENDERBACKEND_EXPORT void SetUniform(const char* UniformName, const vec3& Value);
+GLUON_RENDERBACKEND_EXPORT void SetUniform(const char* UniformName, const vec4& Value);
+GLUON_RENDERBACKEND_EXPORT void SetUniform(const char* UniformName, const mat2& Value);
+GLUON_RENDERBACKEND_EXPORT void SetUniform(const char* UniformName, const mat3& Value);
+GLUON_RENDERBACKEND_EXPORT void SetUniform(const char* UniformName, const mat4& Value);
+GLUON_RENDERBACKEND_EXPORT void SetUniform(const char* UniformName, const i32* Values, u32 Count);
+
 GLUON_RENDERBACKEND_EXPORT vertex_array_handle CreateVertexArray(buffer_handle IndexBuffer);
 GLUON_RENDERBACKEND_EXPORT void                AttachVertexBuffer(vertex_array_handle  VertexArray,
                                                                   buffer_handle        VertexBuffer,
@@ -171,8 +308,49 @@ GLUON_RENDERBACKEND_EXPORT texture_handle CreateTexture(u32       Width,
                                                         bool      WithMipmaps    = false,
                                                         void*     Data           = nullptr);
 
+//! Layers share the size and the format of the array, shaders sample them through a sampler2DArray. Arrays have no mipmaps, their
+//! content is undefined until it is written.
+GLUON_RENDERBACKEND_EXPORT texture_handle CreateTextureArray(u32       Width,
+                                                             u32       Height,
+                                                             u32       LayerCount,
+                                                             u32       ComponentCount = 4,
+                                                             data_type DataType       = DataType_UnsignedByte);
+
 GLUON_RENDERBACKEND_EXPORT void SetTextureData(texture_handle Handle, void* Data);
+//! Updates a region of the first level, Data holds Width * Height tightly packed texels. Mipmaps are not regenerated.
+GLUON_RENDERBACKEND_EXPORT void SetTextureSubData(texture_handle Handle, u32 X, u32 Y, u32 Width, u32 Height, const void* Data);
+//! Same as SetTextureSubData() for a layer of a texture array
+GLUON_RENDERBACKEND_EXPORT void
+SetTextureLayerSubData(texture_handle Handle, u32 Layer, u32 X, u32 Y, u32 Width, u32 Height, const void* Data);
 GLUON_RENDERBACKEND_EXPORT void SetTextureWrapping(texture_handle Handle, wrap_mode WrapS, wrap_mode WrapT);
 GLUON_RENDERBACKEND_EXPORT void SetTextureFiltering(texture_handle Handle, min_filter MinFilter, mag_filter MagFilter);
 GLUON_RENDERBACKEND_EXPORT void DestroyTexture(texture_handle Handle);
+
+//! Offscreen target rendering into a layer of a texture array. Returns an invalid handle when the backend cannot render to textures,
+//! which is the case of the Vulkan one.
+GLUON_RENDERBACKEND_EXPORT framebuffer_handle CreateFramebuffer(texture_handle TextureArray, u32 Layer = 0);
+GLUON_RENDERBACKEND_EXPORT void               DestroyFramebuffer(framebuffer_handle Handle);
+
+//! All draw calls must happen between BeginFrame() and EndFrame()
+GLUON_RENDERBACKEND_EXPORT void BeginFrame();
+GLUON_RENDERBACKEND_EXPORT void EndFrame();
+
+GLUON_RENDERBACKEND_EXPORT void SetViewport(i32 X, i32 Y, i32 Width, i32 Height);
+GLUON_RENDERBACKEND_EXPORT void Clear(const vec4& Color);
+GLUON_RENDERBACKEND_EXPORT void SetBlending(bool Enabled);
+
+//! Following draws and clears go to the framebuffer, an invalid handle selects the window again. The viewport is not changed.
+GLUON_RENDERBACKEND_EXPORT void BindFramebuffer(framebuffer_handle Handle);
+
+GLUON_RENDERBACKEND_EXPORT void BindVertexArray(vertex_array_handle VertexArray);
+GLUON_RENDERBACKEND_EXPORT void BindStorageBuffer(u32 Binding, buffer_handle Buffer);
+GLUON_RENDERBACKEND_EXPORT void BindTexture(u32 Unit, texture_handle Texture);
+
+GLUON_RENDERBACKEND_EXPORT void DrawElementsInstanced(u32       IndexCount,
+                                                      u32       InstanceCount,
+                                                      data_type IndexType = DataType_UnsignedShort);
+
+//! Runs the current compute program with the bound storage buffers. Its writes are visible to the draws of the same frame, the
+//! Vulkan backend runs every dispatch of a frame before its draws, so buffers written by a dispatch should not be drawn from before it.
+GLUON_RENDERBACKEND_EXPORT void DispatchCompute(u32 GroupCountX, u32 GroupCountY = 1, u32 GroupCountZ = 1);
 }
@@ -43,34 +43,16 @@ struct hash<gluon::texture_handle>
 /// This is a private header, it should not be included outside of the gluon renderbackend files.
 namespace gluon
 {
-inline constexpr uint32_t GetDataTypeSize(data_type DataType)
-{
-	switch (DataType)
-	{
-		case DataType_Byte:
-		case DataType_UnsignedByte:
-			return 1;
-
-		case DataType_Short:
-		case DataType_UnsignedShort:
-			return 2;
-
-		case DataType_Int:
-		case DataType_UnsignedInt:
-		case DataType_Float:
-			return 4;
-
-		default:
-			return 0;
-	}
-
-	return 0;
-}
+//! Reads a whole file and null terminates it
+bool ReadTextFile(const char* FileName, eastl::vector<char>* Content);
 
 struct GLN_NO_VTABLE render_backend_interface
 {
 	// Misc section
-	virtual void Initialize() = 0;
+	virtual ~render_backend_interface() = default;
+
+	//! Returns false when the backend cannot be used, it is then destroyed
+	virtual bool Initialize() = 0;
 
 	virtual void EnableDebugging()  = 0;
 	virtual void DisableDebugging() = 0;
@@ -80,10 +62,13 @@ struct GLN_NO_VTABLE render_backend_interface
 	virtual shader_handle CreateShaderFromFile(const char* ShaderName, shader_type ShaderType)                             = 0;
 	virtual void          DestroyShader(shader_handle Shader)                                                              = 0;
 
-	virtual program_handle CreateProgram(shader_handle VertexShader, shader_handle FragmentShader, bool DeleteShaders) = 0;
-	virtual program_handle CreateComputeProgram(shader_handle ComputeShader, bool DeleteShaders)                       = 0;
-	virtual void           SetProgram(program_handle Program)                                                          = 0;
-	virtual void           DestroyProgram(program_handle Program)                                                      = 0;
+	virtual program_handle CreateProgram(shader_handle VertexShader, shader_handle FragmentShader, bool DeleteShaders)             = 0;
+	virtual program_handle CreateComputeProgram(shader_handle ComputeShader, bool DeleteShaders)                                   = 0;
+	virtual program_handle CreateProgramFromSources(const char* VertexSource, const char* FragmentSource, const char* ProgramName) = 0;
+	virtual program_handle CreateComputeProgramFromSource(const char* ComputeSource, const char* ProgramName)                      = 0;
+	virtual bool           IsProgramReady(program_handle Program)                                                                  = 0;
+	virtual void           SetProgram(program_handle Program)                                                                      = 0;
+	virtual void           DestroyProgram(program_handle Program)                                                                  = 0;
 
 	// TODO: This uniform handling does not fit DirectX or Vulkan paradigms
 	virtual void SetUniform(const char* UniformName, i32 Value)         = 0;
@@ -96,6 +81,8 @@ struct GLN_NO_VTABLE render_backend_interface
 	virtual void SetUniform(const char* UniformName, const mat3& Value) = 0;
 	virtual void SetUniform(const char* UniformName, const mat4& Value) = 0;
 
+	virtual void SetUniform(const char* UniformName, const i32* Values, u32 Count) = 0;
+
 	// VAO section
 	virtual vertex_array_handle CreateVertexArray(buffer_handle IndexBuffer)                                                        = 0;
 	virtual void AttachVertexBuffer(vertex_array_handle VertexArray, buffer_handle VertexBuffer, const vertex_layout& VertexLayout) = 0;
@@ -114,9 +101,30 @@ struct GLN_NO_VTABLE render_backend_interface
 
 	// Texture section
 	virtual texture_handle CreateTexture(u32 Width, u32 Height, u32 ComponentCount, data_type DataType, bool WithMipmaps, void* Data) = 0;
+	virtual texture_handle CreateTextureArray(u32 Width, u32 Height, u32 LayerCount, u32 ComponentCount, data_type DataType)          = 0;
 	virtual void           SetTextureData(texture_handle Texture, void* Data)                                                         = 0;
+	virtual void           SetTextureSubData(texture_handle Texture, u32 X, u32 Y, u32 Width, u32 Height, const void* Data)           = 0;
+	virtual void SetTextureLayerSubData(texture_handle Texture, u32 Layer, u32 X, u32 Y, u32 Width, u32 Height, const void* Data)     = 0;
 	virtual void           SetTextureWrapping(texture_handle Texture, wrap_mode WrapS, wrap_mode WrapT)                               = 0;
 	virtual void           SetTextureFiltering(texture_handle Texture, min_filter MinFilter, mag_filter MagFilter)                    = 0;
 	virtual void           DestroyTexture(texture_handle Texture)                                                                     = 0;
+
+	virtual framebuffer_handle CreateFramebuffer(texture_handle TextureArray, u32 Layer) = 0;
+	virtual void               DestroyFramebuffer(framebuffer_handle Framebuffer)        = 0;
+
+	// Draw section
+	virtual void BeginFrame() = 0;
+	virtual void EndFrame()   = 0;
+
+	virtual void SetViewport(i32 X, i32 Y, i32 Width, i32 Height) = 0;
+	virtual void Clear(const vec4& Color)                         = 0;
+	virtual void SetBlending(bool Enabled)                        = 0;
+	virtual void BindFramebuffer(framebuffer_handle Framebuffer)  = 0;
+
+	virtual void BindVertexArray(vertex_array_handle VertexArray)                              = 0;
+	virtual void BindStorageBuffer(u32 Binding, buffer_handle Buffer)                          = 0;
+	virtual void BindTexture(u32 Unit, texture_handle Texture)                                 = 0;
+	virtual void DrawElementsInstanced(u32 IndexCount, u32 InstanceCount, data_type IndexType) = 0;
+	virtual void DispatchCompute(u32 GroupCountX, u32 GroupCountY, u32 GroupCountZ)            = 0;
 };
 }
@@ -0,0 +1,65 @@
+// Converts a msdf-atlas-gen json/png pair into the binary font format described in gluon/api/gln_font_file.h
+//
+// Usage: font_converter <atlas.png> <atlas.json> <output.glnfont>
+
+#include <gluon/api/gln_text.h>
+
+#include <EASTL/vector.h>
+
+#include <stdio.h>
+
+static bool ReadFile(const char* FileName, eastl::vector<u8>* Content)
+{
+	FILE* File = fopen(FileName, "rb");
+
+	if (File == nullptr)
+	{
+		fprintf(stderr, "Cannot open %s\n", FileName);
+		return false;
+	}
+
+	fseek(File, 0, SEEK_END);
+	u64 FileSize = ftell(File);
+	rewind(File);
+
+	Content->resize(FileSize + 1);
+	size_t Read      = fread(Content->data(), 1, FileSize, File);
+	(*Content)[Read] = '\0';
+	Content->resize(Read + 1);
+
+	fclose(File);
+
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc != 4)
+	{
+		fprintf(stderr, "Usage: %s <atlas.png> <atlas.json> <output.glnfont>\n", argv[0]);
+		return 1;
+	}
+
+	eastl::vector<u8> AtlasContent, JsonContent;
+
+	if (!ReadFile(argv[1], &AtlasContent) || !ReadFile(argv[2], &JsonContent))
+	{
+		return 1;
+	}
+
+	gluon::font_atlas Atlas = gluon::LoadFontAtlasFromMemory(AtlasContent.data(), AtlasContent.size() - 1, (const char*)JsonContent.data());
+
+	if (Atlas.Data == nullptr)
+	{
+		fprintf(stderr, "Cannot decode %s\n", argv[1]);
+		return 1;
+	}
+
+	const bool Written = gluon::WriteFontAtlasBinary(Atlas, argv[3]);
+
+	printf("%s: %u glyphs, %dx%d texels, %d channels\n", argv[3], Atlas.Glyphs.GetGlyphCount(), Atlas.Width, Atlas.Height, Atlas.Type);
+
+	gluon::ReleaseFontAtlasTexels(&Atlas);
+
+	return Written ? 0 : 1;
+}